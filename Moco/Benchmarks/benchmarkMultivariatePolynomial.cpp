@@ -0,0 +1,127 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: benchmarkMultivariatePolynomial.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/// This executable compares the time to evaluate a SimTKMultivariatePolynomial
+/// (value and full gradient, as needed for a muscle's length and moment arms)
+/// with a reference implementation that evaluates each term with std::pow and
+/// computes each derivative in a separate pass over the terms.
+///
+/// Usage:
+/// @verbatim
+/// benchmarkMultivariatePolynomial [<num-points>]
+/// @endverbatim
+
+#include <Moco/osimMoco.h>
+#include <iostream>
+
+using namespace OpenSim;
+
+namespace {
+
+/// The reference: evaluate the value and each derivative in separate passes,
+/// computing each power with std::pow.
+double calcReference(const std::vector<std::array<int, 4>>& powers,
+        const SimTK::Vector& coefficients, int dimension,
+        const SimTK::Vector& x, SimTK::Vector& gradient) {
+    double value = 0;
+    for (int iterm = 0; iterm < (int)powers.size(); ++iterm) {
+        double term = coefficients[iterm];
+        for (int i = 0; i < dimension; ++i) {
+            term *= std::pow(x[i], powers[iterm][i]);
+        }
+        value += term;
+    }
+    for (int j = 0; j < dimension; ++j) {
+        gradient[j] = 0;
+        for (int iterm = 0; iterm < (int)powers.size(); ++iterm) {
+            const auto& nq = powers[iterm];
+            double term = coefficients[iterm] * nq[j] *
+                          std::pow(x[j], std::max(nq[j] - 1, 0));
+            for (int i = 0; i < dimension; ++i) {
+                if (i != j) term *= std::pow(x[i], nq[i]);
+            }
+            gradient[j] += term;
+        }
+    }
+    return value;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const int numPoints = argc > 1 ? std::stoi(argv[1]) : 100000;
+    const int order = 5;
+    SimTK::Random::Uniform random(-1, 1);
+    random.setSeed(0);
+    std::cout << "dimension, reference (ns/point), value and gradient "
+                 "(ns/point), batch value and gradient (ns/point)"
+              << std::endl;
+    for (int dimension = 1; dimension <= 4; ++dimension) {
+        const auto powers = SimTKMultivariatePolynomial<double>::createPowers(
+                dimension, order);
+        SimTK::Vector coefficients((int)powers.size());
+        for (int i = 0; i < coefficients.size(); ++i) {
+            coefficients[i] = random.getValue();
+        }
+        const SimTKMultivariatePolynomial<double> polynomial(
+                coefficients, dimension, order);
+        SimTK::Matrix points(numPoints, dimension);
+        for (int p = 0; p < numPoints; ++p) {
+            for (int i = 0; i < dimension; ++i) {
+                points(p, i) = random.getValue();
+            }
+        }
+
+        // Accumulate the results so that the evaluations are not optimized
+        // away.
+        double sum = 0;
+        SimTK::Vector x(dimension);
+        SimTK::Vector gradient(dimension);
+
+        Stopwatch watch;
+        for (int p = 0; p < numPoints; ++p) {
+            for (int i = 0; i < dimension; ++i) x[i] = points(p, i);
+            sum += calcReference(powers, coefficients, dimension, x, gradient);
+            sum += gradient.sum();
+        }
+        const double referenceTime =
+                (double)watch.getElapsedTimeInNs() / numPoints;
+
+        watch.reset();
+        for (int p = 0; p < numPoints; ++p) {
+            for (int i = 0; i < dimension; ++i) x[i] = points(p, i);
+            double value;
+            polynomial.calcValueAndGradient(x, value, gradient);
+            sum += value + gradient.sum();
+        }
+        const double singleTime =
+                (double)watch.getElapsedTimeInNs() / numPoints;
+
+        watch.reset();
+        SimTK::Vector values;
+        SimTK::Matrix gradients;
+        polynomial.calcValuesAndGradients(points, values, gradients);
+        sum += values.sum() + gradients.sum().sum();
+        const double batchTime = (double)watch.getElapsedTimeInNs() / numPoints;
+
+        std::cout << dimension << ", " << referenceTime << ", " << singleTime
+                  << ", " << batchTime << std::endl;
+        if (SimTK::isNaN(sum)) std::cout << "NaN encountered." << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
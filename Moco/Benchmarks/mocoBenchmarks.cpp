@@ -0,0 +1,420 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: mocoBenchmarks.cpp                                           *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/// This executable solves a fixed set of representative problems with each
+/// available solver and for a range of thread counts, and writes the results
+/// (wall time, iterations, number of dynamics evaluations, time per
+/// iteration) to a JSON file so that performance can be tracked across
+/// changes.
+///
+/// Usage:
+/// @verbatim
+/// mocoBenchmarks [--output <file>] [--threads <n1,n2,...>]
+///                [--filter <substring>]
+/// @endverbatim
+///
+/// - output: the JSON file to write (default: mocoBenchmarks.json).
+/// - threads: the thread counts to use with MocoCasADiSolver (default: 1 and
+///   the number of cores). MocoTropterSolver is always run with 1 thread.
+/// - filter: only run the problems whose name contains this substring.
+
+#include <Moco/osimMoco.h>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace OpenSim;
+
+namespace {
+
+/// This force applies no load; it counts the number of times the forces of
+/// any copy of the model are computed, which is the number of times the solver
+/// evaluates the multibody dynamics.
+class DynamicsEvaluationCounter : public Force {
+    OpenSim_DECLARE_CONCRETE_OBJECT(DynamicsEvaluationCounter, Force);
+
+public:
+    DynamicsEvaluationCounter() { setName("dynamics_evaluation_counter"); }
+    void computeForce(const SimTK::State&, SimTK::Vector_<SimTK::SpatialVec>&,
+            SimTK::Vector&) const override {
+        ++s_count;
+    }
+    static void resetCount() { s_count = 0; }
+    static long long getCount() { return s_count; }
+
+private:
+    static std::atomic<long long> s_count;
+};
+
+std::atomic<long long> DynamicsEvaluationCounter::s_count(0);
+
+/// Add a DynamicsEvaluationCounter to a model created by a ModelProcessor.
+class ModOpAddDynamicsEvaluationCounter : public ModelOperator {
+    OpenSim_DECLARE_CONCRETE_OBJECT(
+            ModOpAddDynamicsEvaluationCounter, ModelOperator);
+
+public:
+    void operate(Model& model, const std::string&) const override {
+        model.addForce(new DynamicsEvaluationCounter());
+        model.finalizeConnections();
+    }
+};
+
+struct BenchmarkResult {
+    std::string problem;
+    std::string solver;
+    int numThreads = 1;
+    bool success = false;
+    std::string status;
+    double wallTime = SimTK::NaN;
+    double solverDuration = SimTK::NaN;
+    int numIterations = -1;
+    long long numDynamicsEvaluations = 0;
+    double objective = SimTK::NaN;
+};
+
+struct Benchmark {
+    std::string name;
+    bool supportsTropter;
+    /// Create a study whose problem is ready to be solved. The solver is
+    /// configured by configureSolver().
+    std::function<MocoStudy()> createStudy;
+    int numMeshIntervals;
+    std::string transcriptionScheme;
+};
+
+/// Configure the study's solver. MocoInverse and MocoTrack configure a
+/// MocoCasADiSolver in initialize(); we only adjust the parallelism of such
+/// studies.
+void configureSolver(MocoStudy& study, const Benchmark& benchmark,
+        const std::string& solverName, int numThreads) {
+    if (solverName == "casadi") {
+        MocoCasADiSolver* solver = nullptr;
+        if (benchmark.numMeshIntervals > 0) {
+            solver = &study.initCasADiSolver();
+            solver->set_num_mesh_intervals(benchmark.numMeshIntervals);
+            solver->set_transcription_scheme(benchmark.transcriptionScheme);
+        } else {
+            solver = &study.updSolver<MocoCasADiSolver>();
+        }
+        solver->set_parallel(numThreads == 1 ? 0 : numThreads);
+    }
+#ifdef MOCO_WITH_TROPTER
+    else if (solverName == "tropter") {
+        auto& solver = study.initTropterSolver();
+        solver.set_num_mesh_intervals(benchmark.numMeshIntervals);
+        solver.set_transcription_scheme(benchmark.transcriptionScheme);
+    }
+#endif
+    else {
+        OPENSIM_THROW(Exception, "Unrecognized solver '{}'.", solverName);
+    }
+}
+
+/// Slide a point mass from rest at 0 to rest at 1 in minimum time.
+MocoStudy createSlidingMassStudy() {
+    Model model = ModelFactory::createSlidingPointMass();
+    ModOpAddDynamicsEvaluationCounter().operate(model, "");
+    MocoStudy study;
+    study.setName("sliding_mass");
+    MocoProblem& problem = study.updProblem();
+    problem.setModelCopy(model);
+    problem.setTimeBounds(0, {0, 5});
+    problem.setStateInfo("/slider/position/value", {0, 1}, 0, 1);
+    problem.setStateInfo("/slider/position/speed", {-100, 100}, 0, 0);
+    problem.setControlInfo("/forceset/actuator", {-10, 10});
+    problem.addGoal<MocoFinalTimeGoal>();
+    return study;
+}
+
+/// Swing a double pendulum from hanging to inverted while minimizing effort.
+MocoStudy createDoublePendulumStudy() {
+    Model model = ModelFactory::createDoublePendulum();
+    ModOpAddDynamicsEvaluationCounter().operate(model, "");
+    MocoStudy study;
+    study.setName("double_pendulum");
+    MocoProblem& problem = study.updProblem();
+    problem.setModelCopy(model);
+    problem.setTimeBounds(0, 1);
+    problem.setStateInfo("/jointset/j0/q0/value", {-10, 10}, -0.5 * SimTK::Pi,
+            0.5 * SimTK::Pi);
+    problem.setStateInfo("/jointset/j1/q1/value", {-10, 10}, 0, 0);
+    problem.setStateInfoPattern("/jointset/.*/speed", {-50, 50}, 0, 0);
+    problem.setControlInfo("/tau0", {-100, 100});
+    problem.setControlInfo("/tau1", {-100, 100});
+    problem.addGoal<MocoControlGoal>();
+    return study;
+}
+
+/// Drop a planar point mass onto a compliant ground contact (an initial value
+/// problem).
+MocoStudy createPointMassContactStudy() {
+    using SimTK::Vec3;
+    Model model;
+    model.setName("point_mass_contact");
+    auto* intermed = new Body("intermed", 0, Vec3(0), SimTK::Inertia(0));
+    model.addComponent(intermed);
+    auto* body = new Body("body", 50.0, Vec3(0), SimTK::Inertia(1));
+    model.addComponent(body);
+
+    auto* jointX = new SliderJoint("tx", model.getGround(), *intermed);
+    jointX->updCoordinate(SliderJoint::Coord::TranslationX).setName("tx");
+    model.addComponent(jointX);
+
+    // The joint's x axis must point in the global "+y" direction.
+    auto* jointY = new SliderJoint("ty", *intermed, Vec3(0),
+            Vec3(0, 0, 0.5 * SimTK::Pi), *body, Vec3(0),
+            Vec3(0, 0, 0.5 * SimTK::Pi));
+    jointY->updCoordinate(SliderJoint::Coord::TranslationX).setName("ty");
+    model.addComponent(jointY);
+
+    auto* station = new Station();
+    station->setName("contact_point");
+    station->connectSocket_parent_frame(*body);
+    model.addComponent(station);
+
+    auto* contact = new AckermannVanDenBogert2010Force();
+    contact->setName("contact");
+    contact->set_stiffness(1e5);
+    contact->set_dissipation(1.0);
+    contact->set_friction_coefficient(0.7);
+    model.addComponent(contact);
+    contact->connectSocket_station(*station);
+
+    ModOpAddDynamicsEvaluationCounter().operate(model, "");
+
+    MocoStudy study;
+    study.setName("point_mass_contact");
+    MocoProblem& problem = study.updProblem();
+    problem.setModelCopy(model);
+    problem.setTimeBounds(0, 1);
+    problem.setStateInfo("/tx/tx/value", {-1, 1}, 0);
+    problem.setStateInfo("/ty/ty/value", {-0.5, 1}, 0.5);
+    problem.setStateInfo("/tx/tx/speed", {-10, 10}, 0);
+    problem.setStateInfo("/ty/ty/speed", {-10, 10}, 0);
+    return study;
+}
+
+/// Muscle-driven inverse problem for walking (same as testMocoInverse).
+MocoStudy createInverseStudy() {
+    MocoInverse inverse;
+    inverse.setModel(ModelProcessor("subject_walk_armless_18musc.osim") |
+                     ModOpReplaceJointsWithWelds(
+                             {"subtalar_r", "subtalar_l", "mtp_r", "mtp_l"}) |
+                     ModOpReplaceMusclesWithDeGrooteFregly2016() |
+                     ModOpIgnorePassiveFiberForcesDGF() |
+                     ModOpTendonComplianceDynamicsModeDGF("implicit") |
+                     ModOpAddExternalLoads(
+                             "subject_walk_armless_external_loads.xml") |
+                     ModOpAddDynamicsEvaluationCounter());
+    inverse.setKinematics(
+            TableProcessor("subject_walk_armless_coordinates.mot") |
+            TabOpLowPassFilter(6));
+    inverse.set_initial_time(0.450);
+    inverse.set_final_time(1.0);
+    inverse.set_kinematics_allow_extra_columns(true);
+    inverse.set_mesh_interval(0.05);
+    return inverse.initialize();
+}
+
+/// Torque-driven tracking of walking (same as testMocoTrack).
+MocoStudy createTrackStudy() {
+    MocoTrack track;
+    track.setModel(ModelProcessor("testGait10dof18musc_subject01.osim") |
+                   ModOpRemoveMuscles() | ModOpAddReserves(100) |
+                   ModOpAddExternalLoads("walk_gait1018_subject01_grf.xml") |
+                   ModOpAddDynamicsEvaluationCounter());
+    track.setStatesReference(
+            TableProcessor("walk_gait1018_state_reference.mot") |
+            TabOpLowPassFilter(6));
+    track.set_initial_time(0.01);
+    track.set_final_time(1.3);
+    return track.initialize();
+}
+
+std::vector<Benchmark> createBenchmarks() {
+    // A numMeshIntervals of -1 means the study's solver is already configured.
+    return {{"sliding_mass", true, createSlidingMassStudy, 50,
+                    "hermite-simpson"},
+            {"double_pendulum", true, createDoublePendulumStudy, 50,
+                    "hermite-simpson"},
+            // Hermite-Simpson has trouble converging for this problem.
+            {"point_mass_contact", true, createPointMassContactStudy, 50,
+                    "trapezoidal"},
+            // MocoTropterSolver does not support prescribed kinematics.
+            {"inverse_subject_walk_armless_18musc", false, createInverseStudy,
+                    -1, ""},
+            {"track_gait10dof18musc", false, createTrackStudy, -1, ""}};
+}
+
+BenchmarkResult runBenchmark(const Benchmark& benchmark,
+        const std::string& solverName, int numThreads) {
+    BenchmarkResult result;
+    result.problem = benchmark.name;
+    result.solver = solverName;
+    result.numThreads = numThreads;
+
+    MocoStudy study = benchmark.createStudy();
+    configureSolver(study, benchmark, solverName, numThreads);
+
+    DynamicsEvaluationCounter::resetCount();
+    Stopwatch watch;
+    MocoSolution solution = study.solve();
+    result.wallTime = watch.getElapsedTime();
+    result.numDynamicsEvaluations = DynamicsEvaluationCounter::getCount();
+
+    result.success = solution.success();
+    result.status = solution.getStatus();
+    solution.unseal();
+    result.solverDuration = solution.getSolverDuration();
+    result.numIterations = solution.getNumIterations();
+    result.objective = solution.getObjective();
+    return result;
+}
+
+std::string toJSON(double value) {
+    if (SimTK::isNaN(value) || SimTK::isInf(value)) return "null";
+    std::stringstream ss;
+    ss << std::setprecision(10) << value;
+    return ss.str();
+}
+
+std::string toJSON(const std::string& value) {
+    std::string escaped = "\"";
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped + "\"";
+}
+
+void writeJSON(const std::string& filepath,
+        const std::vector<BenchmarkResult>& results) {
+    std::ofstream f(filepath);
+    OPENSIM_THROW_IF(!f.good(), Exception, "Could not open file '{}'.",
+            filepath);
+    f << "{\n";
+    f << "  \"date\": " << toJSON(getMocoFormattedDateTime(false, "ISO"))
+      << ",\n";
+    f << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency()
+      << ",\n";
+    f << "  \"benchmarks\": [";
+    for (int i = 0; i < (int)results.size(); ++i) {
+        const auto& r = results[i];
+        // Exclude processing the model and creating the problem, which are
+        // included in the wall time.
+        const double timePerIteration =
+                r.numIterations > 0 ? r.solverDuration / r.numIterations
+                                    : SimTK::NaN;
+        f << (i == 0 ? "\n" : ",\n");
+        f << "    {\"problem\": " << toJSON(r.problem)
+          << ", \"solver\": " << toJSON(r.solver)
+          << ", \"num_threads\": " << r.numThreads
+          << ", \"success\": " << (r.success ? "true" : "false")
+          << ", \"status\": " << toJSON(r.status)
+          << ", \"wall_time\": " << toJSON(r.wallTime)
+          << ", \"solver_duration\": " << toJSON(r.solverDuration)
+          << ", \"num_iterations\": " << r.numIterations
+          << ", \"time_per_iteration\": " << toJSON(timePerIteration)
+          << ", \"num_dynamics_evaluations\": " << r.numDynamicsEvaluations
+          << ", \"objective\": " << toJSON(r.objective) << "}";
+    }
+    f << "\n  ]\n}\n";
+}
+
+std::vector<int> parseThreadCounts(const std::string& arg) {
+    std::vector<int> counts;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const int count = std::stoi(item);
+        OPENSIM_THROW_IF(count < 1, Exception,
+                "Expected thread counts to be positive, but got {}.", count);
+        counts.push_back(count);
+    }
+    return counts;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        std::string output = "mocoBenchmarks.json";
+        std::string filter;
+        std::vector<int> threadCounts = {1};
+        const int numCores = (int)std::thread::hardware_concurrency();
+        if (numCores > 1) threadCounts.push_back(numCores);
+
+        for (int iarg = 1; iarg < argc; ++iarg) {
+            const std::string arg = argv[iarg];
+            OPENSIM_THROW_IF(iarg + 1 == argc, Exception,
+                    "Expected a value after '{}'.", arg);
+            const std::string value = argv[++iarg];
+            if (arg == "--output") {
+                output = value;
+            } else if (arg == "--threads") {
+                threadCounts = parseThreadCounts(value);
+            } else if (arg == "--filter") {
+                filter = value;
+            } else {
+                OPENSIM_THROW(Exception, "Unrecognized argument '{}'.", arg);
+            }
+        }
+
+        Object::registerType(DynamicsEvaluationCounter());
+        Object::registerType(ModOpAddDynamicsEvaluationCounter());
+
+        std::vector<BenchmarkResult> results;
+        for (const auto& benchmark : createBenchmarks()) {
+            if (!filter.empty() &&
+                    benchmark.name.find(filter) == std::string::npos) {
+                continue;
+            }
+            for (const int numThreads : threadCounts) {
+                log_info("Benchmark {}, casadi, {} thread(s).", benchmark.name,
+                        numThreads);
+                results.push_back(
+                        runBenchmark(benchmark, "casadi", numThreads));
+            }
+#ifdef MOCO_WITH_TROPTER
+            if (benchmark.supportsTropter) {
+                log_info("Benchmark {}, tropter, 1 thread(s).", benchmark.name);
+                results.push_back(runBenchmark(benchmark, "tropter", 1));
+            }
+#endif
+            // Write after each problem so that partial results are kept.
+            writeJSON(output, results);
+        }
+        writeJSON(output, results);
+        log_info("Wrote benchmark results to {}.", output);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
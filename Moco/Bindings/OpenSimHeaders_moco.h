@@ -7,6 +7,7 @@
 #include <Moco/Common/TableProcessor.h>
 #include <Moco/Components/DeGrooteFregly2016Muscle.h>
 #include <Moco/Components/ModelFactory.h>
+#include <Moco/Components/MultiStationPlaneContactForce.h>
 #include <Moco/Components/MultivariatePolynomialFunction.h>
 #include <Moco/Components/PositionMotion.h>
 #include <Moco/Components/Bhargava2004Metabolics.h>
@@ -34,6 +35,8 @@
 #include <Moco/MocoInverse.h>
 #include <Moco/MocoParameter.h>
 #include <Moco/MocoProblem.h>
+#include <Moco/MocoRecedingHorizon.h>
+#include <Moco/MocoSolutionCache.h>
 #include <Moco/MocoStudy.h>
 #include <Moco/MocoStudyFactory.h>
 #include <Moco/MocoTrack.h>
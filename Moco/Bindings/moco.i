@@ -7,6 +7,7 @@ typedef SimTK::RowVector_<double> RowVector;
 
 %include <Moco/About.h>
 
+%include <Moco/Common/ProcessorCache.h>
 %include <Moco/Common/TableProcessor.h>
 
 
@@ -208,16 +209,21 @@ namespace OpenSim {
 %include <Moco/MocoTropterSolver.h>
 %include <Moco/MocoCasADiSolver/MocoCasADiSolver.h>
 %include <Moco/MocoStudy.h>
+%include <Moco/MocoSolutionCache.h>
 %include <Moco/MocoStudyFactory.h>
 
 %include <Moco/MocoTool.h>
 %include <Moco/MocoInverse.h>
 %include <Moco/MocoTrack.h>
+%include <Moco/MocoRecedingHorizon.h>
+%template(StdVectorMocoRecedingHorizonStepStatistics)
+        std::vector<OpenSim::MocoRecedingHorizon::StepStatistics>;
 
 %include <Moco/Components/DeGrooteFregly2016Muscle.h>
 moco_unique_ptr(OpenSim::PositionMotion);
 %include <Moco/Components/PositionMotion.h>
 
+%ignore OpenSim::runTasksInParallel;
 %include <Moco/MocoUtilities.h>
 %template(analyze) OpenSim::analyze<double>;
 %template(analyzeVec3) OpenSim::analyze<SimTK::Vec3>;
@@ -226,5 +232,6 @@ moco_unique_ptr(OpenSim::PositionMotion);
 %include <Moco/Components/ModelFactory.h>
 %include <Moco/Components/MultivariatePolynomialFunction.h>
 %include <Moco/Components/Bhargava2004Metabolics.h>
+%include <Moco/Components/MultiStationPlaneContactForce.h>
 
 %include <Moco/ModelOperators.h>
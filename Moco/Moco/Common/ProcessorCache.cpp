@@ -0,0 +1,263 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: ProcessorCache.cpp                                           *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ProcessorCache.h"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Simulation/Model/Model.h>
+
+using namespace OpenSim;
+
+namespace {
+
+/// A 64-bit FNV-1a hash of a key.
+std::uint64_t hashKey(const std::string& key) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// A least-recently-used list of entries; the most recently used entry is at
+/// the front. Entries are indexed by the hash of their key (see hashKey()),
+/// and full keys are compared only for entries whose hashes match.
+template <typename T>
+class LRUCache {
+public:
+    explicit LRUCache(std::size_t capacity) : m_capacity(capacity) {}
+    std::shared_ptr<const T> find(
+            std::uint64_t hash, const std::string& key) {
+        const auto it = findEntry(hash, key);
+        if (it == m_entries.end()) return nullptr;
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        return m_entries.front().value;
+    }
+    void insert(std::uint64_t hash, const std::string& key,
+            std::shared_ptr<const T> value) {
+        const auto it = findEntry(hash, key);
+        if (it != m_entries.end()) erase(it);
+        m_entries.push_front({hash, key, std::move(value)});
+        m_index.emplace(hash, m_entries.begin());
+        if (m_entries.size() > m_capacity) erase(std::prev(m_entries.end()));
+    }
+    void clear() {
+        m_entries.clear();
+        m_index.clear();
+    }
+
+private:
+    struct Entry {
+        std::uint64_t hash;
+        std::string key;
+        std::shared_ptr<const T> value;
+    };
+    using Iterator = typename std::list<Entry>::iterator;
+    Iterator findEntry(std::uint64_t hash, const std::string& key) {
+        const auto range = m_index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->key == key) return it->second;
+        }
+        return m_entries.end();
+    }
+    void erase(Iterator entry) {
+        const auto range = m_index.equal_range(entry->hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == entry) {
+                m_index.erase(it);
+                break;
+            }
+        }
+        m_entries.erase(entry);
+    }
+    std::size_t m_capacity;
+    std::list<Entry> m_entries;
+    std::unordered_multimap<std::uint64_t, Iterator> m_index;
+};
+
+struct Cache {
+    std::mutex mutex;
+    std::atomic<bool> enabled{false};
+    std::atomic<int> numHits{0};
+    LRUCache<TimeSeriesTable> tables{32};
+    // Models are large, so we keep only a few.
+    LRUCache<Model> models{4};
+};
+
+Cache& getCache() {
+    static Cache cache;
+    return cache;
+}
+
+void combineHash(std::size_t& hash, std::size_t value) {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+}
+
+template <typename T> void appendBytes(std::string& str, const T& value) {
+    str.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // anonymous namespace
+
+void ProcessorCache::setEnabled(bool enabled) {
+    getCache().enabled = enabled;
+}
+
+bool ProcessorCache::getEnabled() { return getCache().enabled; }
+
+void ProcessorCache::clear() {
+    auto& cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.tables.clear();
+    cache.models.clear();
+    cache.numHits = 0;
+}
+
+int ProcessorCache::getNumHits() { return getCache().numHits; }
+
+std::string ProcessorCache::createKeyPart(const std::string& contents) {
+    std::string part;
+    part.reserve(sizeof(std::size_t) + contents.size());
+    appendBytes(part, contents.size());
+    part += contents;
+    return part;
+}
+
+std::string ProcessorCache::createFileKeyPart(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return {};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return createKeyPart("file") + createKeyPart(contents.str());
+}
+
+std::string ProcessorCache::createTableKeyPart(const TimeSeriesTable& table) {
+    std::string contents;
+    for (const auto& label : table.getColumnLabels()) {
+        contents += createKeyPart(label);
+    }
+    const auto& times = table.getIndependentColumn();
+    appendBytes(contents, times.size());
+    for (const auto& time : times) appendBytes(contents, time);
+    const auto& matrix = table.getMatrix();
+    for (int irow = 0; irow < matrix.nrow(); ++irow) {
+        for (int icol = 0; icol < matrix.ncol(); ++icol) {
+            appendBytes(contents, matrix(irow, icol));
+        }
+    }
+    if (table.hasTableMetaDataKey("inDegrees")) {
+        contents += createKeyPart(table.getTableMetaDataAsString("inDegrees"));
+    }
+    return createKeyPart("table") + createKeyPart(contents);
+}
+
+std::string ProcessorCache::createObjectKeyPart(const Object& object) {
+    return createKeyPart(object.dump());
+}
+
+std::string ProcessorCache::createModelKeyPartForTable(const Model& model) {
+    if (!model.hasSystem()) return {};
+    std::string contents = createKeyPart(model.getName());
+    const auto svNames = model.getStateVariableNames();
+    for (int isv = 0; isv < svNames.getSize(); ++isv) {
+        contents += createKeyPart(svNames[isv]);
+    }
+    for (const auto& coord : model.getComponentList<Coordinate>()) {
+        contents += createKeyPart(coord.getAbsolutePathString());
+        appendBytes(contents, (int)coord.getMotionType());
+    }
+    return createKeyPart(contents);
+}
+
+std::size_t ProcessorCache::hashTable(const TimeSeriesTable& table) {
+    std::size_t hash = 0;
+    for (const auto& label : table.getColumnLabels()) {
+        combineHash(hash, std::hash<std::string>()(label));
+    }
+    for (const auto& time : table.getIndependentColumn()) {
+        combineHash(hash, std::hash<double>()(time));
+    }
+    const auto& matrix = table.getMatrix();
+    for (int irow = 0; irow < matrix.nrow(); ++irow) {
+        for (int icol = 0; icol < matrix.ncol(); ++icol) {
+            combineHash(hash, std::hash<double>()(matrix(irow, icol)));
+        }
+    }
+    if (table.hasTableMetaDataKey("inDegrees")) {
+        combineHash(hash, std::hash<std::string>()(
+                                  table.getTableMetaDataAsString("inDegrees")));
+    }
+    return hash;
+}
+
+bool ProcessorCache::findTable(
+        const std::string& key, TimeSeriesTable& table) {
+    auto& cache = getCache();
+    const std::uint64_t hash = hashKey(key);
+    std::shared_ptr<const TimeSeriesTable> found;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        found = cache.tables.find(hash, key);
+    }
+    if (!found) return false;
+    ++cache.numHits;
+    table = *found;
+    return true;
+}
+
+void ProcessorCache::insertTable(
+        const std::string& key, const TimeSeriesTable& table) {
+    auto& cache = getCache();
+    const std::uint64_t hash = hashKey(key);
+    auto copy = std::make_shared<const TimeSeriesTable>(table);
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.tables.insert(hash, key, std::move(copy));
+}
+
+bool ProcessorCache::findModel(const std::string& key, Model& model) {
+    auto& cache = getCache();
+    const std::uint64_t hash = hashKey(key);
+    std::shared_ptr<const Model> found;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        found = cache.models.find(hash, key);
+    }
+    if (!found) return false;
+    ++cache.numHits;
+    model = *found;
+    return true;
+}
+
+void ProcessorCache::insertModel(const std::string& key, const Model& model) {
+    auto& cache = getCache();
+    const std::uint64_t hash = hashKey(key);
+    auto copy = std::make_shared<const Model>(model);
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.models.insert(hash, key, std::move(copy));
+}
@@ -0,0 +1,107 @@
+#ifndef MOCO_PROCESSORCACHE_H
+#define MOCO_PROCESSORCACHE_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: ProcessorCache.h                                             *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "../osimMocoDLL.h"
+
+#include <OpenSim/Common/TimeSeriesTable.h>
+
+namespace OpenSim {
+
+class Model;
+
+/// A cache, shared by all TableProcessor%s and ModelProcessor%s in this
+/// process, of the tables and models that they produce. When many solves (or
+/// the MocoProblemRep%s within a solve) process the same inputs, the inputs
+/// are read, filtered, and operated on only once. The cache is disabled by
+/// default; enable it with setEnabled(true).
+///
+/// Entries are keyed on content rather than on object identity:
+///  - the source: the contents of the file (not its path), or the in-memory
+///    table or model;
+///  - the serialized properties of each operator;
+///  - for TableProcessor, if a model is provided: the model's name, state
+///    variables, and coordinates (this is what the degrees-to-radians
+///    conversion and TabOpUseAbsoluteStateNames depend on).
+///
+/// The keys contain the full contents of these inputs (not hashes of them),
+/// so a result is only reused for identical inputs, and editing a file, an
+/// operator, or a source table invalidates the cached result. Some inputs
+/// are not part of the key: files read by operators (e.g., the external
+/// loads file of ModOpAddExternalLoads), the relativeToDirectory used to
+/// locate such files (for ModelProcessor, it is part of the key), and any
+/// aspect of the model, beyond those listed above, that a custom
+/// TableOperator uses. If these change between calls to process(), call
+/// clear() or do not enable the cache.
+///
+/// Entries are found by a hash of their key; the full key is compared only
+/// with entries whose hash matches. Only a small number of results are
+/// retained (the most recently used).
+/// The cache is thread-safe. Processors compute results outside of the
+/// cache's lock, so if multiple threads process the same inputs concurrently
+/// before the result is cached, each computes the result.
+class OSIMMOCO_API ProcessorCache {
+public:
+    /// The cache is disabled by default.
+    static void setEnabled(bool enabled);
+    static bool getEnabled();
+    /// Remove all cached tables and models.
+    static void clear();
+    /// The number of times a processor obtained its result from the cache
+    /// (since the program started or clear() was called).
+    static int getNumHits();
+
+    /// @name For use by processors
+    /// A key is the concatenation of the parts below. Each part starts with
+    /// its length (and file and table parts with their type), so that
+    /// different inputs cannot form the same key.
+    /// @{
+    /// Create a key part from a string.
+    static std::string createKeyPart(const std::string& contents);
+    /// Create a key part from the contents of a file. This returns an empty
+    /// string if the file cannot be read.
+    static std::string createFileKeyPart(const std::string& path);
+    /// Create a key part from the column labels, times, and data of a table,
+    /// and its inDegrees metadata, if any.
+    static std::string createTableKeyPart(const TimeSeriesTable& table);
+    /// Create a key part from the serialized properties of an object.
+    static std::string createObjectKeyPart(const Object& object);
+    /// Create a key part from the aspects of a model that TableProcessor's
+    /// key depends on. This returns an empty string if the model does not
+    /// have a system.
+    static std::string createModelKeyPartForTable(const Model& model);
+    /// Hash the column labels, times, and data of a table, and its inDegrees
+    /// metadata, if any. Equal tables have equal hashes, but different tables
+    /// may also have equal hashes.
+    static std::size_t hashTable(const TimeSeriesTable& table);
+
+    /// If a table with the given key is cached, copy it into `table` and
+    /// return true.
+    static bool findTable(const std::string& key, TimeSeriesTable& table);
+    static void insertTable(const std::string& key, const TimeSeriesTable&);
+    /// If a model with the given key is cached, copy it into `model` and
+    /// return true.
+    static bool findModel(const std::string& key, Model& model);
+    static void insertModel(const std::string& key, const Model&);
+    /// @}
+};
+
+} // namespace OpenSim
+
+#endif // MOCO_PROCESSORCACHE_H
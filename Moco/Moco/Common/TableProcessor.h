@@ -19,6 +19,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "../MocoUtilities.h"
+#include "ProcessorCache.h"
 #include <algorithm>
 
 #include <OpenSim/Common/TimeSeriesTable.h>
@@ -77,26 +78,37 @@ public:
     /// radians (if the table has a header with inDegrees=yes) before any
     /// operations are performed. This model is accessible by any
     /// TableOperator%s that require it.
+    /// If the ProcessorCache is enabled, the result is cached, and if the same
+    /// source table is processed with the same operators again, the result is
+    /// obtained from the cache.
     TimeSeriesTable process(std::string relativeToDirectory,
             const Model* model = nullptr) const {
-        TimeSeriesTable table;
+        std::string path;
         if (get_filepath().empty()) {
-            if (m_tableProvided) {
-                table = m_table;
-            } else {
-                OPENSIM_THROW_FRMOBJ(Exception, "No source table.");
-            }
+            OPENSIM_THROW_IF_FRMOBJ(
+                    !m_tableProvided, Exception, "No source table.");
         } else {
             OPENSIM_THROW_IF_FRMOBJ(m_tableProvided, Exception,
                     "Expected either an in-memory table or a filepath, but "
                     "both were provided.");
-            std::string path = get_filepath();
+            path = get_filepath();
             if (!relativeToDirectory.empty()) {
                 using SimTK::Pathname;
                 path = Pathname::
                         getAbsolutePathnameUsingSpecifiedWorkingDirectory(
                                 relativeToDirectory, path);
             }
+        }
+
+        TimeSeriesTable table;
+        const std::string cacheKey = createCacheKey(path, model);
+        if (!cacheKey.empty() && ProcessorCache::findTable(cacheKey, table)) {
+            return table;
+        }
+
+        if (path.empty()) {
+            table = m_table;
+        } else {
             table = TimeSeriesTable(path);
         }
 
@@ -110,6 +122,7 @@ public:
         for (int i = 0; i < getProperty_operators().size(); ++i) {
             get_operators(i).operate(table, model);
         }
+        if (!cacheKey.empty()) ProcessorCache::insertTable(cacheKey, table);
         return table;
     }
     /// Same as above, but paths are evaluated with respect to the current
@@ -145,6 +158,29 @@ public:
     }
 
 private:
+    /// Returns an empty string if the result should not be cached.
+    std::string createCacheKey(
+            const std::string& path, const Model* model) const {
+        if (!ProcessorCache::getEnabled()) return {};
+        std::string key;
+        if (path.empty()) {
+            key = ProcessorCache::createTableKeyPart(m_table);
+        } else {
+            key = ProcessorCache::createFileKeyPart(path);
+            if (key.empty()) return {};
+        }
+        std::string modelPart;
+        if (model) {
+            modelPart = ProcessorCache::createModelKeyPartForTable(*model);
+            if (modelPart.empty()) return {};
+        }
+        key += ProcessorCache::createKeyPart(modelPart);
+        for (int i = 0; i < getProperty_operators().size(); ++i) {
+            key += ProcessorCache::createObjectKeyPart(get_operators(i));
+        }
+        return key;
+    }
+
     bool m_tableProvided = false;
     TimeSeriesTable m_table;
 };
@@ -157,7 +193,15 @@ public:
     OpenSim_DECLARE_PROPERTY(cutoff_frequency, double,
             "Low-pass cutoff frequency (Hz) (default is -1, which means no "
             "filtering).");
-    TabOpLowPassFilter() { constructProperty_cutoff_frequency(-1); }
+    OpenSim_DECLARE_PROPERTY(convert_to_storage, bool,
+            "Filter by converting the table to a Storage, as in "
+            "filterLowpass() (default: true). If false, filter the table's "
+            "data directly, which avoids copying the data "
+            "(see filterLowpassWithoutStorage()).");
+    TabOpLowPassFilter() {
+        constructProperty_cutoff_frequency(-1);
+        constructProperty_convert_to_storage(true);
+    }
     TabOpLowPassFilter(double cutoffFrequency) : TabOpLowPassFilter() {
         set_cutoff_frequency(cutoffFrequency);
     }
@@ -168,7 +212,12 @@ public:
                     "Expected cutoff frequency to be positive, but got {}.",
                     get_cutoff_frequency());
 
-            table = filterLowpass(table, get_cutoff_frequency(), true);
+            if (get_convert_to_storage()) {
+                table = filterLowpass(table, get_cutoff_frequency(), true);
+            } else {
+                table = filterLowpassWithoutStorage(
+                        table, get_cutoff_frequency(), true);
+            }
         }
     }
 };
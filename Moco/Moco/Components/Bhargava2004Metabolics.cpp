@@ -22,6 +22,7 @@
 #include <SimTKcommon/internal/State.h>
 
 #include <OpenSim/Common/Component.h>
+#include <OpenSim/Common/Logger.h>
 #include <OpenSim/Simulation/Model/Model.h>
 
 using namespace OpenSim;
@@ -176,44 +177,70 @@ void Bhargava2004Metabolics::constructProperties()
 
 void Bhargava2004Metabolics::extendFinalizeFromProperties() {
     if (get_use_smoothing()) {
-        m_tanh_conditional = [](const double& cond, const double& left,
-                const double& right, const double& smoothing, const int&) {
-            const double smoothed_binary = 0.5 + 0.5 * tanh(smoothing * cond);
-            return left + (-left + right) * smoothed_binary;
-        };
         if (get_smoothing_type() == "tanh") {
-            m_conditional = m_tanh_conditional;
-
+            m_smoothing = Smoothing::Tanh;
         } else if (get_smoothing_type() == "huber") {
-            m_conditional = [](const double& cond, const double& left,
-                    const double& right, const double& smoothing,
-                    const int& direction) {
-                const double offset = (direction == 1) ? left : right;
-                const double scale = (right - left) / cond;
-                const double delta = 1.0;
-                const double state = direction * cond;
-                const double shift = 0.5 * (1 / smoothing);
-                const double y = smoothing * (state + shift);
-                double f = 0;
-                if (y < 0) f = offset;
-                else if (y <= delta) f = 0.5 * y * y + offset;
-                else  f = delta * (y - 0.5 * delta) + offset;
-                return scale * (f/smoothing + offset * (1.0 - 1.0/smoothing));
-            };
+            m_smoothing = Smoothing::Huber;
+        } else {
+            OPENSIM_THROW_FRMOBJ(Exception,
+                    "Expected smoothing_type to be 'tanh' or 'huber', but got "
+                    "'{}'.",
+                    get_smoothing_type());
         }
     } else {
-        m_conditional = [](const double& cond, const double& left,
-                const double& right, const double& smoothing, const int&) {
-            if (cond <= 0) {
-                return left;
-            } else {
-                return right;
-            }
-        };
-        m_tanh_conditional = m_conditional;
+        m_smoothing = Smoothing::None;
     }
 }
 
+namespace {
+// The conditional statements of the model, with and without smoothing. Each
+// returns left if cond <= 0 and right otherwise (or a smooth transition
+// between the two). These are function objects (rather than function
+// pointers or std::function) so that they are inlined in the rate kernel.
+struct StepConditional {
+    double operator()(double cond, double left, double right, double,
+            int) const {
+        return cond <= 0 ? left : right;
+    }
+};
+struct TanhConditional {
+    double operator()(double cond, double left, double right,
+            double smoothing, int) const {
+        const double smoothed_binary = 0.5 + 0.5 * tanh(smoothing * cond);
+        return left + (-left + right) * smoothed_binary;
+    }
+};
+struct HuberConditional {
+    double operator()(double cond, double left, double right,
+            double smoothing, int direction) const {
+        const double offset = (direction == 1) ? left : right;
+        const double scale = (right - left) / cond;
+        const double delta = 1.0;
+        const double state = direction * cond;
+        const double shift = 0.5 * (1 / smoothing);
+        const double y = smoothing * (state + shift);
+        double f = 0;
+        if (y < 0) f = offset;
+        else if (y <= delta) f = 0.5 * y * y + offset;
+        else  f = delta * (y - 0.5 * delta) + offset;
+        return scale * (f/smoothing + offset * (1.0 - 1.0/smoothing));
+    }
+};
+
+// Columns of the matrix of muscle inputs (one row per muscle).
+enum MuscleInput {
+    Activation,
+    Excitation,
+    PassiveFiberForce,
+    ActiveFiberForce,
+    NormalizedFiberLength,
+    FiberVelocity,
+    ActiveForceLengthMultiplier,
+    MaxIsometricForce,
+    NumMuscleInputs
+};
+} // anonymous namespace
+
 double Bhargava2004Metabolics::getTotalMetabolicRate(
         const SimTK::State& s) const {
     // BASAL METABOLIC RATE (W) (based on whole body mass, not muscle mass).
@@ -253,11 +280,33 @@ void Bhargava2004Metabolics::extendRealizeTopology(SimTK::State& state)
 const {
     Super::extendRealizeTopology(state);
     m_muscleIndices.clear();
-    for (int i=0; i < getProperty_muscle_parameters().size(); ++i) {
-        const auto& muscle = get_muscle_parameters(i).getMuscle();
+    m_muscleParameterIndices.clear();
+    m_muscles.clear();
+    m_muscleMass.clear();
+    m_ratioSlowTwitch.clear();
+    m_activationConstantSlowTwitch.clear();
+    m_activationConstantFastTwitch.clear();
+    m_maintenanceConstantSlowTwitch.clear();
+    m_maintenanceConstantFastTwitch.clear();
+    for (int i = 0; i < getProperty_muscle_parameters().size(); ++i) {
+        const auto& muscleParameter = get_muscle_parameters(i);
+        const auto& muscle = muscleParameter.getMuscle();
         if (muscle.get_appliesForce()) {
-            m_muscleIndices[muscle.getAbsolutePathString()] = i;
-            ++i;
+            m_muscleIndices[muscle.getAbsolutePathString()] =
+                    (int)m_muscles.size();
+            m_muscleParameterIndices.push_back(i);
+            m_muscles.emplace_back(&muscle);
+            m_muscleMass.push_back(muscleParameter.getMuscleMass());
+            m_ratioSlowTwitch.push_back(
+                    muscleParameter.get_ratio_slow_twitch_fibers());
+            m_activationConstantSlowTwitch.push_back(
+                    muscleParameter.get_activation_constant_slow_twitch());
+            m_activationConstantFastTwitch.push_back(
+                    muscleParameter.get_activation_constant_fast_twitch());
+            m_maintenanceConstantSlowTwitch.push_back(
+                    muscleParameter.get_maintenance_constant_slow_twitch());
+            m_maintenanceConstantFastTwitch.push_back(
+                    muscleParameter.get_maintenance_constant_fast_twitch());
         }
     }
 }
@@ -276,28 +325,34 @@ void Bhargava2004Metabolics::extendAddToSystem(
             SimTK::Stage::Dynamics);
     addCacheVariable<SimTK::Vector>("mechanical_work_rate", rates,
             SimTK::Stage::Dynamics);
+    // Scratch space for gathering the inputs from the muscles.
+    addCacheVariable<SimTK::Matrix>("muscle_inputs",
+            SimTK::Matrix((int)m_muscleIndices.size(), NumMuscleInputs),
+            SimTK::Stage::Dynamics);
 }
 
 void Bhargava2004Metabolics::calcMetabolicRateForCache(
-    const SimTK::State& s) const {
-    calcMetabolicRate(s,
+        const SimTK::State& s, bool activationAndMaintenanceOnly) const {
+    calcMetabolicRate(s, activationAndMaintenanceOnly,
             updCacheVariableValue<SimTK::Vector>(s, "metabolic_rate"),
             updCacheVariableValue<SimTK::Vector>(s, "activation_rate"),
             updCacheVariableValue<SimTK::Vector>(s, "maintenance_rate"),
             updCacheVariableValue<SimTK::Vector>(s, "shortening_rate"),
             updCacheVariableValue<SimTK::Vector>(s, "mechanical_work_rate")
             );
-    markCacheVariableValid(s, "metabolic_rate");
     markCacheVariableValid(s, "activation_rate");
     markCacheVariableValid(s, "maintenance_rate");
-    markCacheVariableValid(s, "shortening_rate");
-    markCacheVariableValid(s, "mechanical_work_rate");
+    if (!activationAndMaintenanceOnly) {
+        markCacheVariableValid(s, "metabolic_rate");
+        markCacheVariableValid(s, "shortening_rate");
+        markCacheVariableValid(s, "mechanical_work_rate");
+    }
 }
 
 const SimTK::Vector& Bhargava2004Metabolics::getMetabolicRate(
         const SimTK::State& s) const {
     if (!isCacheVariableValid(s, "metabolic_rate")) {
-        calcMetabolicRateForCache(s);
+        calcMetabolicRateForCache(s, false);
     }
     return getCacheVariableValue<SimTK::Vector>(s, "metabolic_rate");
 }
@@ -305,7 +360,7 @@ const SimTK::Vector& Bhargava2004Metabolics::getMetabolicRate(
 const SimTK::Vector& Bhargava2004Metabolics::getActivationRate(
         const SimTK::State& s) const {
     if (!isCacheVariableValid(s, "activation_rate")) {
-        calcMetabolicRateForCache(s);
+        calcMetabolicRateForCache(s, true);
     }
     return getCacheVariableValue<SimTK::Vector>(s, "activation_rate");
 }
@@ -313,7 +368,7 @@ const SimTK::Vector& Bhargava2004Metabolics::getActivationRate(
 const SimTK::Vector& Bhargava2004Metabolics::getMaintenanceRate(
         const SimTK::State& s) const {
     if (!isCacheVariableValid(s, "maintenance_rate")) {
-        calcMetabolicRateForCache(s);
+        calcMetabolicRateForCache(s, true);
     }
     return getCacheVariableValue<SimTK::Vector>(s, "maintenance_rate");
 }
@@ -321,7 +376,7 @@ const SimTK::Vector& Bhargava2004Metabolics::getMaintenanceRate(
 const SimTK::Vector& Bhargava2004Metabolics::getShorteningRate(
         const SimTK::State& s) const {
     if (!isCacheVariableValid(s, "shortening_rate")) {
-        calcMetabolicRateForCache(s);
+        calcMetabolicRateForCache(s, false);
     }
     return getCacheVariableValue<SimTK::Vector>(s, "shortening_rate");
 }
@@ -329,95 +384,155 @@ const SimTK::Vector& Bhargava2004Metabolics::getShorteningRate(
 const SimTK::Vector& Bhargava2004Metabolics::getMechanicalWorkRate(
         const SimTK::State& s) const {
     if (!isCacheVariableValid(s, "mechanical_work_rate")) {
-        calcMetabolicRateForCache(s);
+        calcMetabolicRateForCache(s, false);
     }
     return getCacheVariableValue<SimTK::Vector>(s, "mechanical_work_rate");
 }
 
 void Bhargava2004Metabolics::calcMetabolicRate(
-        const SimTK::State& s, SimTK::Vector& totalRatesForMuscles,
+        const SimTK::State& s, bool activationAndMaintenanceOnly,
+        SimTK::Vector& totalRatesForMuscles,
         SimTK::Vector& activationRatesForMuscles,
         SimTK::Vector& maintenanceRatesForMuscles,
         SimTK::Vector& shorteningRatesForMuscles,
         SimTK::Vector& mechanicalWorkRatesForMuscles) const {
-    totalRatesForMuscles.resize((int)m_muscleIndices.size());
-    activationRatesForMuscles.resize((int)m_muscleIndices.size());
-    maintenanceRatesForMuscles.resize((int)m_muscleIndices.size());
-    shorteningRatesForMuscles.resize((int)m_muscleIndices.size());
-    mechanicalWorkRatesForMuscles.resize((int)m_muscleIndices.size());
-    double activationHeatRate, maintenanceHeatRate, shorteningHeatRate;
-    double mechanicalWorkRate;
-    activationHeatRate = maintenanceHeatRate = shorteningHeatRate =
-        mechanicalWorkRate = 0;
-
-    int i = 0;
-    for (const auto& muscleIndex : m_muscleIndices) {
-
-        const auto& muscleParameter =
-            get_muscle_parameters(muscleIndex.second);
-        const auto& muscle = muscleParameter.getMuscle();
+    const int numMuscles = (int)m_muscles.size();
+    const auto resize = [numMuscles](SimTK::Vector& rates) {
+        if (rates.size() != numMuscles) rates.resize(numMuscles);
+    };
+    resize(activationRatesForMuscles);
+    resize(maintenanceRatesForMuscles);
+    if (!activationAndMaintenanceOnly) {
+        resize(totalRatesForMuscles);
+        resize(shorteningRatesForMuscles);
+        resize(mechanicalWorkRatesForMuscles);
+    }
 
-        const double maximalIsometricForce = muscle.getMaxIsometricForce();
-        const double activation =
-            get_muscle_effort_scaling_factor() * muscle.getActivation(s);
-        const double excitation =
-            get_muscle_effort_scaling_factor() * muscle.getControl(s);
-        const double fiberForcePassive =  muscle.getPassiveFiberForce(s);
-        const double fiberForceActive =
-            get_muscle_effort_scaling_factor() * muscle.getActiveFiberForce(s);
-        const double fiberForceTotal =
-            fiberForceActive + fiberForcePassive;
-        const double fiberLengthNormalized =
-            muscle.getNormalizedFiberLength(s);
-        const double fiberVelocity = muscle.getFiberVelocity(s);
+    // Gather the inputs from the muscles. The activation and maintenance
+    // heat rates only require the excitation and the fiber length.
+    auto& inputs = updCacheVariableValue<SimTK::Matrix>(s, "muscle_inputs");
+    if (inputs.nrow() != numMuscles) inputs.resize(numMuscles, NumMuscleInputs);
+    const double effortScaling = get_muscle_effort_scaling_factor();
+    for (int i = 0; i < numMuscles; ++i) {
+        const Muscle& muscle = *m_muscles[i];
+        inputs(i, Excitation) = effortScaling * muscle.getControl(s);
+        inputs(i, NormalizedFiberLength) = muscle.getNormalizedFiberLength(s);
+        if (activationAndMaintenanceOnly) continue;
+        inputs(i, Activation) = effortScaling * muscle.getActivation(s);
+        inputs(i, PassiveFiberForce) = muscle.getPassiveFiberForce(s);
+        inputs(i, ActiveFiberForce) =
+                effortScaling * muscle.getActiveFiberForce(s);
+        inputs(i, FiberVelocity) = muscle.getFiberVelocity(s);
+        inputs(i, ActiveForceLengthMultiplier) =
+                muscle.getActiveForceLengthMultiplier(s);
+        inputs(i, MaxIsometricForce) = muscle.getMaxIsometricForce();
+    }
+
+    switch (m_smoothing) {
+    case Smoothing::None:
+        calcMetabolicRateImpl<StepConditional, StepConditional>(inputs,
+                activationAndMaintenanceOnly, totalRatesForMuscles,
+                activationRatesForMuscles, maintenanceRatesForMuscles,
+                shorteningRatesForMuscles, mechanicalWorkRatesForMuscles);
+        break;
+    case Smoothing::Tanh:
+        calcMetabolicRateImpl<TanhConditional, TanhConditional>(inputs,
+                activationAndMaintenanceOnly, totalRatesForMuscles,
+                activationRatesForMuscles, maintenanceRatesForMuscles,
+                shorteningRatesForMuscles, mechanicalWorkRatesForMuscles);
+        break;
+    case Smoothing::Huber:
+        calcMetabolicRateImpl<HuberConditional, TanhConditional>(inputs,
+                activationAndMaintenanceOnly, totalRatesForMuscles,
+                activationRatesForMuscles, maintenanceRatesForMuscles,
+                shorteningRatesForMuscles, mechanicalWorkRatesForMuscles);
+        break;
+    }
+}
+
+template <typename Conditional, typename TanhConditional>
+void Bhargava2004Metabolics::calcMetabolicRateImpl(const SimTK::Matrix& inputs,
+        bool activationAndMaintenanceOnly,
+        SimTK::Vector& totalRatesForMuscles,
+        SimTK::Vector& activationRatesForMuscles,
+        SimTK::Vector& maintenanceRatesForMuscles,
+        SimTK::Vector& shorteningRatesForMuscles,
+        SimTK::Vector& mechanicalWorkRatesForMuscles) const {
+    const Conditional conditional;
+    const TanhConditional tanhConditional;
+    const bool useSmoothing = get_use_smoothing();
+    const bool useForceDependentShorteningPropConstant =
+            get_use_force_dependent_shortening_prop_constant();
+    const bool includeNegativeMechanicalWork =
+            get_include_negative_mechanical_work();
+    const bool forbidNegativeTotalPower = get_forbid_negative_total_power();
+    const bool enforceMinimumHeatRatePerMuscle =
+            get_enforce_minimum_heat_rate_per_muscle();
+    const double velocitySmoothing = get_velocity_smoothing();
+    const double powerSmoothing = get_power_smoothing();
+    const double heatRateSmoothing = get_heat_rate_smoothing();
+
+    // This small constant is added to the fiber velocity to prevent
+    // dividing by 0 (in case the actual fiber velocity is null) when using
+    // the Huber loss smoothing approach, thereby preventing singularities.
+    const double eps = 1e-16;
+    // This value is set to 1.0, as used by Anderson & Pandy (1999),
+    // however, in Bhargava et al., (2004) they assume a function here.
+    // We will ignore this function and use 1.0 for now.
+    const double decay_function_value = 1.0;
+
+    // Argument for m_fiberLengthDepCurve, allocated once.
+    SimTK::Vector fiberLengthNormalized(1);
+
+    const int numMuscles = (int)m_muscles.size();
+    for (int i = 0; i < numMuscles; ++i) {
+        const double muscleMass = m_muscleMass[i];
+        const double excitation = inputs(i, Excitation);
         const double slowTwitchExcitation =
-            muscleParameter.get_ratio_slow_twitch_fibers()
-            * sin(SimTK::Pi/2 * excitation);
+            m_ratioSlowTwitch[i] * sin(SimTK::Pi/2 * excitation);
         const double fastTwitchExcitation =
-            (1 - muscleParameter.get_ratio_slow_twitch_fibers())
-            * (1 - cos(SimTK::Pi/2 * excitation));
-        // This small constant is added to the fiber velocity to prevent
-        // dividing by 0 (in case the actual fiber velocity is null) when using
-        // the Huber loss smoothing approach, thereby preventing singularities.
-        const double eps = 1e-16;
-
-        // Get the unnormalized total active force, isometricTotalActiveForce
-        // that 'would' be developed at the current activation and fiber length
-        // under isometric conditions (i.e., fiberVelocity=0).
-        const double isometricTotalActiveForce =
-            activation * muscle.getActiveForceLengthMultiplier(s)
-            * maximalIsometricForce;
+            (1 - m_ratioSlowTwitch[i]) * (1 - cos(SimTK::Pi/2 * excitation));
 
         // ACTIVATION HEAT RATE (W).
         // -------------------------
-        // This value is set to 1.0, as used by Anderson & Pandy (1999),
-        // however, in Bhargava et al., (2004) they assume a function here.
-        // We will ignore this function and use 1.0 for now.
-        const double decay_function_value = 1.0;
-        activationHeatRate =
-            muscleParameter.getMuscleMass() * decay_function_value
-            * ( (muscleParameter.get_activation_constant_slow_twitch()
-                        * slowTwitchExcitation)
-                + (muscleParameter.get_activation_constant_fast_twitch()
-                        * fastTwitchExcitation) );
+        const double activationHeatRate =
+            muscleMass * decay_function_value
+            * ( (m_activationConstantSlowTwitch[i] * slowTwitchExcitation)
+                + (m_activationConstantFastTwitch[i] * fastTwitchExcitation) );
 
         // MAINTENANCE HEAT RATE (W).
         // --------------------------
-        const double fiber_length_dependence = m_fiberLengthDepCurve.calcValue(
-                    SimTK::Vector(1, fiberLengthNormalized));
-        maintenanceHeatRate =
-            muscleParameter.getMuscleMass() * fiber_length_dependence
-                * ( (muscleParameter.get_maintenance_constant_slow_twitch()
-                            * slowTwitchExcitation)
-                + (muscleParameter.get_maintenance_constant_fast_twitch()
-                            * fastTwitchExcitation) );
+        fiberLengthNormalized[0] = inputs(i, NormalizedFiberLength);
+        const double fiber_length_dependence =
+                m_fiberLengthDepCurve.calcValue(fiberLengthNormalized);
+        const double maintenanceHeatRate =
+            muscleMass * fiber_length_dependence
+                * ( (m_maintenanceConstantSlowTwitch[i] * slowTwitchExcitation)
+                + (m_maintenanceConstantFastTwitch[i]
+                        * fastTwitchExcitation) );
+
+        activationRatesForMuscles[i] = activationHeatRate;
+        maintenanceRatesForMuscles[i] = maintenanceHeatRate;
+        if (activationAndMaintenanceOnly) continue;
+
+        const double fiberForceActive = inputs(i, ActiveFiberForce);
+        const double fiberForceTotal =
+            fiberForceActive + inputs(i, PassiveFiberForce);
+        const double fiberVelocity = inputs(i, FiberVelocity);
+
+        // Get the unnormalized total active force, isometricTotalActiveForce
+        // that 'would' be developed at the current activation and fiber length
+        // under isometric conditions (i.e., fiberVelocity=0).
+        const double isometricTotalActiveForce =
+            inputs(i, Activation) * inputs(i, ActiveForceLengthMultiplier)
+            * inputs(i, MaxIsometricForce);
 
         // SHORTENING HEAT RATE (W).
         // --> note that we define fiberVelocity<0 as shortening and
         //     fiberVelocity>0 as lengthening.
         // ---------------------------------------------------------
         double alpha;
-        if (get_use_force_dependent_shortening_prop_constant()) {
+        if (useForceDependentShorteningPropConstant) {
             // Even when using the Huber loss smoothing approach, we still rely
             // on a tanh approximation for the shortening heat rate when using
             // the force dependent shortening proportional constant. This is
@@ -427,66 +542,71 @@ void Bhargava2004Metabolics::calcMetabolicRate(
             // therefore easier to smooth the transition between both
             // contraction types with a tanh function than with a Huber loss
             // function.
-            alpha = m_tanh_conditional(fiberVelocity + eps,
+            alpha = tanhConditional(fiberVelocity + eps,
                     (0.16 * isometricTotalActiveForce)
                     + (0.18 * fiberForceTotal),
                     0.157 * fiberForceTotal,
-                    get_velocity_smoothing(),
+                    velocitySmoothing,
                     -1);
         } else {
             // This simpler value of alpha comes from Frank Anderson's 1999
             // dissertation "A Dynamic Optimization Solution for a Complete
             // Cycle of Normal Gait".
-            alpha = m_conditional(fiberVelocity + eps,
+            alpha = conditional(fiberVelocity + eps,
                     0.25 * fiberForceTotal,
                     0,
-                    get_velocity_smoothing(),
+                    velocitySmoothing,
                     -1);
         }
-        shorteningHeatRate = -alpha * (fiberVelocity + eps);
+        double shorteningHeatRate = -alpha * (fiberVelocity + eps);
 
         // MECHANICAL WORK RATE for the contractile element of the muscle (W).
         // --> note that we define fiberVelocity<0 as shortening and
         //     fiberVelocity>0 as lengthening.
         // -------------------------------------------------------------------
-        if (get_include_negative_mechanical_work())
-        {
+        double mechanicalWorkRate;
+        if (includeNegativeMechanicalWork) {
             mechanicalWorkRate = -fiberForceActive * fiberVelocity;
         } else {
-            mechanicalWorkRate = m_conditional(fiberVelocity + eps,
+            mechanicalWorkRate = conditional(fiberVelocity + eps,
                     -fiberForceActive * fiberVelocity,
                     0,
-                    get_velocity_smoothing(),
+                    velocitySmoothing,
                     -1);
         }
 
         // NAN CHECKING
         // ------------------------------------------
-        if (SimTK::isNaN(activationHeatRate))
-            std::cout << "WARNING::" << getName() << ": activationHeatRate ("
-                    << muscleParameter.getName() << ") = NaN!" << std::endl;
-        if (SimTK::isNaN(maintenanceHeatRate))
-            std::cout << "WARNING::" << getName() << ": maintenanceHeatRate ("
-                    << muscleParameter.getName() << ") = NaN!" << std::endl;
-        if (SimTK::isNaN(shorteningHeatRate))
-            std::cout << "WARNING::" << getName() << ": shorteningHeatRate ("
-                    << muscleParameter.getName() << ") = NaN!" << std::endl;
-        if (SimTK::isNaN(mechanicalWorkRate))
-            std::cout << "WARNING::" << getName() << ": mechanicalWorkRate ("
-                    <<  muscleParameter.getName() << ") = NaN!" << std::endl;
+        if (SimTK::isNaN(activationHeatRate + maintenanceHeatRate
+                    + shorteningHeatRate + mechanicalWorkRate)) {
+            const auto& name =
+                get_muscle_parameters(m_muscleParameterIndices[i]).getName();
+            if (SimTK::isNaN(activationHeatRate))
+                log_warn("{}: activationHeatRate ({}) = NaN!", getName(),
+                        name);
+            if (SimTK::isNaN(maintenanceHeatRate))
+                log_warn("{}: maintenanceHeatRate ({}) = NaN!", getName(),
+                        name);
+            if (SimTK::isNaN(shorteningHeatRate))
+                log_warn("{}: shorteningHeatRate ({}) = NaN!", getName(),
+                        name);
+            if (SimTK::isNaN(mechanicalWorkRate))
+                log_warn("{}: mechanicalWorkRate ({}) = NaN!", getName(),
+                        name);
+        }
 
         // If necessary, increase the shortening heat rate so that the total
         // power is non-negative.
-        if (get_forbid_negative_total_power()) {
+        if (forbidNegativeTotalPower) {
             const double Edot_W_beforeClamp = activationHeatRate
                 + maintenanceHeatRate + shorteningHeatRate
                 + mechanicalWorkRate;
-            if (get_use_smoothing()) {
-                const double Edot_W_beforeClamp_smoothed = m_conditional(
+            if (useSmoothing) {
+                const double Edot_W_beforeClamp_smoothed = conditional(
                         -Edot_W_beforeClamp,
                         0,
                         Edot_W_beforeClamp,
-                        get_power_smoothing(),
+                        powerSmoothing,
                         1);
                 shorteningHeatRate -= Edot_W_beforeClamp_smoothed;
             } else {
@@ -504,35 +624,29 @@ void Bhargava2004Metabolics::calcMetabolicRate(
         // --------------------------------------------------------------------
         double totalHeatRate = activationHeatRate + maintenanceHeatRate
             + shorteningHeatRate;
-        if (get_use_smoothing()) {
-            if (get_enforce_minimum_heat_rate_per_muscle())
+        if (useSmoothing) {
+            if (enforceMinimumHeatRatePerMuscle)
             {
-                totalHeatRate = m_conditional(
-                        -totalHeatRate + 1.0 * muscleParameter.getMuscleMass(),
+                totalHeatRate = conditional(
+                        -totalHeatRate + 1.0 * muscleMass,
                         totalHeatRate,
-                        1.0 * muscleParameter.getMuscleMass(),
-                        get_heat_rate_smoothing(),
+                        1.0 * muscleMass,
+                        heatRateSmoothing,
                         1);
             }
         } else {
-            if (get_enforce_minimum_heat_rate_per_muscle()
-                    && totalHeatRate < 1.0 * muscleParameter.getMuscleMass())
+            if (enforceMinimumHeatRatePerMuscle
+                    && totalHeatRate < 1.0 * muscleMass)
             {
-                totalHeatRate = 1.0 * muscleParameter.getMuscleMass();
+                totalHeatRate = 1.0 * muscleMass;
             }
         }
 
         // TOTAL METABOLIC ENERGY RATE (W).
         // --------------------------------
-        double Edot = totalHeatRate + mechanicalWorkRate;
-
-        totalRatesForMuscles[i] = Edot;
-        activationRatesForMuscles[i] = activationHeatRate;
-        maintenanceRatesForMuscles[i] = maintenanceHeatRate;
+        totalRatesForMuscles[i] = totalHeatRate + mechanicalWorkRate;
         shorteningRatesForMuscles[i] = shorteningHeatRate;
         mechanicalWorkRatesForMuscles[i] = mechanicalWorkRate;
-
-        ++i;
     }
 }
 
@@ -169,6 +169,13 @@ private:
 /// discontinuous function have successfully converged; therefore, we have
 /// included it in this implementation of the model.
 ///
+/// The rates for all muscles are computed together: the inputs from the
+/// muscles (activation, fiber velocity, etc.) are gathered into arrays, and
+/// the rates are computed from these arrays in a single loop in which the
+/// conditional statements (smoothed or not) are inlined. The rates are
+/// cached; obtaining only the activation or maintenance heat rates does not
+/// require computing the other rates.
+///
 /// https://doi.org/10.1016/s0021-9290(03)00239-2
 class OSIMMOCO_API Bhargava2004Metabolics : public ModelComponent {
     OpenSim_DECLARE_CONCRETE_OBJECT(
@@ -276,25 +283,53 @@ private:
     void extendFinalizeFromProperties() override;
     void extendRealizeTopology(SimTK::State&) const override;
     void extendAddToSystem(SimTK::MultibodySystem& system) const override;
-    void calcMetabolicRateForCache(const SimTK::State& s) const;
+    /// Compute the rates and store them in the cache variables. If
+    /// activationAndMaintenanceOnly is true, only the activation and
+    /// maintenance heat rates are computed; these do not depend on the fiber
+    /// velocity or forces.
+    void calcMetabolicRateForCache(
+            const SimTK::State& s, bool activationAndMaintenanceOnly) const;
     const SimTK::Vector& getMetabolicRate(const SimTK::State& s) const;
     const SimTK::Vector& getActivationRate(const SimTK::State& s) const;
     const SimTK::Vector& getMaintenanceRate(const SimTK::State& s) const;
     const SimTK::Vector& getShorteningRate(const SimTK::State& s) const;
     const SimTK::Vector& getMechanicalWorkRate(const SimTK::State& s) const;
     void calcMetabolicRate(const SimTK::State& s,
+            bool activationAndMaintenanceOnly,
+            SimTK::Vector& totalRatesForMuscles,
+            SimTK::Vector& activationRatesForMuscles,
+            SimTK::Vector& maintenanceRatesForMuscles,
+            SimTK::Vector& shorteningRatesForMuscles,
+            SimTK::Vector& mechanicalWorkRatesForMuscles) const;
+    /// The rate kernel, operating on the muscle inputs gathered by
+    /// calcMetabolicRate(). The Conditional and TanhConditional function
+    /// objects implement the (possibly smoothed) conditional statements.
+    template <typename Conditional, typename TanhConditional>
+    void calcMetabolicRateImpl(const SimTK::Matrix& inputs,
+            bool activationAndMaintenanceOnly,
             SimTK::Vector& totalRatesForMuscles,
             SimTK::Vector& activationRatesForMuscles,
             SimTK::Vector& maintenanceRatesForMuscles,
             SimTK::Vector& shorteningRatesForMuscles,
             SimTK::Vector& mechanicalWorkRatesForMuscles) const;
+
+    enum class Smoothing { None, Tanh, Huber };
+    Smoothing m_smoothing;
+
+    /// Maps muscle path to the index of the muscle in the rate vectors.
     mutable std::unordered_map<std::string, int> m_muscleIndices;
-    using ConditionalFunction =
-            double(const double&, const double&, const double&, const double&,
-                    const int&);
+    /// @name Per-muscle data, in the order of the rate vectors
+    /// @{
+    mutable std::vector<int> m_muscleParameterIndices;
+    mutable std::vector<SimTK::ReferencePtr<const Muscle>> m_muscles;
+    mutable std::vector<double> m_muscleMass;
+    mutable std::vector<double> m_ratioSlowTwitch;
+    mutable std::vector<double> m_activationConstantSlowTwitch;
+    mutable std::vector<double> m_activationConstantFastTwitch;
+    mutable std::vector<double> m_maintenanceConstantSlowTwitch;
+    mutable std::vector<double> m_maintenanceConstantFastTwitch;
+    /// @}
     PiecewiseLinearFunction m_fiberLengthDepCurve;
-    mutable std::function<ConditionalFunction> m_conditional;
-    mutable std::function<ConditionalFunction> m_tanh_conditional;
 };
 
 } // namespace OpenSim
@@ -543,94 +543,81 @@ void DeGrooteFregly2016Muscle::computeInitialFiberEquilibrium(
         SimTK::State& s) const {
     if (get_ignore_tendon_compliance()) return;
 
-    const auto& muscleTendonLength = getLength(s);
-    const auto& muscleTendonVelocity = getLengtheningSpeed(s);
-    const auto& activation = getActivation(s);
+    setNormalizedTendonForce(s,
+            calcEquilibriumNormTendonForce(getLength(s),
+                    getLengtheningSpeed(s), getActivation(s)));
+}
+
+SimTK::Real DeGrooteFregly2016Muscle::calcEquilibriumNormTendonForce(
+        const SimTK::Real& muscleTendonLength,
+        const SimTK::Real& muscleTendonVelocity,
+        const SimTK::Real& activation) const {
 
     // We have to use the implicit form of the model since the explicit form
     // will produce a zero residual for any guess of normalized tendon force.
     // The implicit form requires a value for normalized tendon force
     // derivative, so we'll set it to zero for simplicity.
     const SimTK::Real normTendonForceDerivative = 0.0;
+    const SimTK::Real maxIsometricForce = get_max_isometric_force();
 
     MuscleLengthInfo mli;
     FiberVelocityInfo fvi;
     MuscleDynamicsInfo mdi;
 
-    auto calcResidual = [this, &muscleTendonLength, &muscleTendonVelocity,
-                                &normTendonForceDerivative, &activation, &mli,
-                                &fvi,
-                                &mdi](const SimTK::Real& normTendonForce) {
-        calcMuscleLengthInfoHelper(muscleTendonLength, false, mli,
-                normTendonForce);
-        calcFiberVelocityInfoHelper(muscleTendonVelocity, activation, false,
-                false, mli, fvi, normTendonForce, normTendonForceDerivative);
-        calcMuscleDynamicsInfoHelper(activation, muscleTendonVelocity, false,
-                mli, fvi, mdi, normTendonForce);
-
-        return calcEquilibriumResidual(
-                mdi.tendonForce, mdi.fiberForceAlongTendon);
-    };
-
-    const auto equilNormTendonForce = solveBisection(calcResidual,
+    auto calcResidualAndDerivative =
+            [this, &muscleTendonLength, &muscleTendonVelocity,
+                    &normTendonForceDerivative, &activation,
+                    &maxIsometricForce, &mli, &fvi,
+                    &mdi](const SimTK::Real& normTendonForce,
+                    SimTK::Real& derivative) {
+                calcMuscleLengthInfoHelper(muscleTendonLength, false, mli,
+                        normTendonForce);
+                calcFiberVelocityInfoHelper(muscleTendonVelocity, activation,
+                        false, false, mli, fvi, normTendonForce,
+                        normTendonForceDerivative);
+                calcMuscleDynamicsInfoHelper(activation, muscleTendonVelocity,
+                        false, mli, fvi, mdi, normTendonForce);
+
+                // A change in normalized tendon force changes the tendon
+                // length by maxIsometricForce / tendonStiffness, and the fiber
+                // length along the tendon by the opposite amount. The change
+                // in fiber velocity is neglected, so the derivative is
+                // approximate; solveBracketedNewton() tolerates this.
+                derivative = calcLinearizedEquilibriumResidualDerivative(0,
+                        maxIsometricForce / mdi.tendonStiffness,
+                        mdi.tendonStiffness, mdi.fiberStiffnessAlongTendon);
+
+                return calcEquilibriumResidual(
+                        mdi.tendonForce, mdi.fiberForceAlongTendon);
+            };
+
+    return solveBracketedNewton(calcResidualAndDerivative,
             m_minNormTendonForce, m_maxNormTendonForce, 1e-10, 100);
-
-    setNormalizedTendonForce(s, equilNormTendonForce);
-
-    // TODO not working as well as bisection, revisist later.
-    //const double tolerance = std::max(
-    //        1e-8 * get_max_isometric_force(), SimTK::SignificantReal * 10);
-    //int maxIterations = 1000;
-
-    //try {
-    //    auto result = estimateMuscleFiberState(activation,
-    //            muscleTendonLength, muscleTendonVelocity,
-    //            normTendonForceDerivative, tolerance, maxIterations);
-
-    //    switch (result.first) {
-
-    //    case Success_Converged:
-    //        setNormalizedTendonForce(s, result.second["norm_tendon_force"]);
-    //        setActuation(s, get_max_isometric_force() *
-    //                                result.second["norm_tendon_force"]);
-    //        break;
-
-    //    case Warning_FiberAtLowerBound:
-    //        printf("\n\nDeGrooteFregly2016Muscle static solution:"
-    //               " %s is at its minimum fiber length of %f\n",
-    //                getName().c_str(), result.second["fiber_length"]);
-    //        setNormalizedTendonForce(s, result.second["norm_tendon_force"]);
-    //        setActuation(s, get_max_isometric_force() *
-    //                                result.second["norm_tendon_force"]);
-    //        break;
-
-    //    case Warning_FiberAtUpperBound:
-    //        printf("\n\nDeGrooteFregly2016Muscle static solution:"
-    //               " %s is at its maximum fiber length of %f\n",
-    //                getName().c_str(), result.second["fiber_length"]);
-    //        setNormalizedTendonForce(s, result.second["norm_tendon_force"]);
-    //        setActuation(s, get_max_isometric_force() *
-    //                                result.second["norm_tendon_force"]);
-    //        break;
-
-    //    case Failure_MaxIterationsReached:
-    //        std::ostringstream ss;
-    //        ss << "\n  Solution error " << abs(result.second["solution_error"])
-    //           << " exceeds tolerance of " << tolerance << "\n"
-    //           << "  Newton iterations reached limit of " << maxIterations
-    //           << "\n"
-    //           << "  Activation is " << activation << "\n"
-    //           << "  Fiber length is " << result.second["fiber_length"] << "\n";
-    //        OPENSIM_THROW_FRMOBJ(MuscleCannotEquilibrate, ss.str());
-    //    }
-
-    //} catch (const std::exception& x) {
-    //    OPENSIM_THROW_FRMOBJ(MuscleCannotEquilibrate,
-    //            "Internal exception encountered.\n" + std::string{x.what()});
-    //}
-
 }
 
+void DeGrooteFregly2016Muscle::equilibrateMuscles(
+        const Model& model, SimTK::State& state) {
+    model.realizeVelocity(state);
+
+    // Solve for all muscles before setting any state variables, as setting a
+    // state variable invalidates the realized stages.
+    std::vector<const DeGrooteFregly2016Muscle*> muscles;
+    std::vector<SimTK::Real> normTendonForces;
+    for (const auto& muscle :
+            model.getComponentList<DeGrooteFregly2016Muscle>()) {
+        if (!muscle.appliesForce(state) ||
+                muscle.get_ignore_tendon_compliance()) {
+            continue;
+        }
+        muscles.push_back(&muscle);
+        normTendonForces.push_back(muscle.calcEquilibriumNormTendonForce(
+                muscle.getLength(state), muscle.getLengtheningSpeed(state),
+                muscle.getActivation(state)));
+    }
+    for (int im = 0; im < (int)muscles.size(); ++im) {
+        muscles[im]->setNormalizedTendonForce(state, normTendonForces[im]);
+    }
+}
 
 std::pair<DeGrooteFregly2016Muscle::StatusFromEstimateMuscleFiberState,
         DeGrooteFregly2016Muscle::ValuesFromEstimateMuscleFiberState>
@@ -690,11 +690,28 @@ public:
     /// ignores the 'default_fiber_length' property in replaced muscles.
     static void replaceMuscles(
             Model& model, bool allowUnsupportedMuscles = false);
+
+    /// Compute the equilibrium normalized tendon force of every
+    /// DeGrooteFregly2016Muscle in the model that applies force and has a
+    /// compliant tendon, and set the normalized tendon force states. This is
+    /// equivalent to calling computeInitialFiberEquilibrium() on each of these
+    /// muscles, but the state is realized to Velocity only once rather than
+    /// once per muscle. The other states (e.g., activation and coordinate
+    /// values and speeds) must be set before calling this function.
+    static void equilibrateMuscles(const Model& model, SimTK::State& state);
     /// @}
 
 private:
     void constructProperties();
 
+    /// Solve for the normalized tendon force at which the tendon force and
+    /// the fiber force along the tendon are equal, assuming the derivative of
+    /// normalized tendon force is 0.
+    SimTK::Real calcEquilibriumNormTendonForce(
+            const SimTK::Real& muscleTendonLength,
+            const SimTK::Real& muscleTendonVelocity,
+            const SimTK::Real& activation) const;
+
     void calcMuscleLengthInfoHelper(const SimTK::Real& muscleTendonLength,
             const bool& ignoreTendonCompliance, MuscleLengthInfo& mli,
             const SimTK::Real& normTendonForce) const;
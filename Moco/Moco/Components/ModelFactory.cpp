@@ -19,6 +19,8 @@
 #include "ModelFactory.h"
 
 #include "../MocoUtilities.h"
+#include "MultiStationPlaneContactForce.h"
+#include "StationPlaneContactForce.h"
 
 #include <OpenSim/Actuators/CoordinateActuator.h>
 #include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
@@ -319,3 +321,288 @@ void ModelFactory::createReserveActuators(Model& model, double optimalForce,
     }
 }
 
+void ModelFactory::fitPolynomialMusclePaths(Model& model, int order,
+        int numSamples, double momentArmThreshold) {
+    OPENSIM_THROW_IF(order < 1, Exception,
+            "Expected order to be at least 1, but got {}.", order);
+    OPENSIM_THROW_IF(numSamples < 1, Exception,
+            "Expected numSamples to be at least 1, but got {}.", numSamples);
+
+    Model modelCopy(model);
+    SimTK::State state = modelCopy.initSystem();
+
+    std::vector<const Coordinate*> coords;
+    for (const auto& coord : modelCopy.getComponentList<Coordinate>()) {
+        if (!coord.getDefaultLocked() && !coord.isConstrained(state)) {
+            coords.push_back(&coord);
+        }
+    }
+    std::vector<const Muscle*> muscles;
+    for (const auto& muscle : modelCopy.getComponentList<Muscle>()) {
+        if (!muscle.getGeometryPath().get_use_approximation()) {
+            muscles.push_back(&muscle);
+        }
+    }
+    const int numCoords = (int)coords.size();
+    const int numMuscles = (int)muscles.size();
+    if (!numMuscles) return;
+
+    // Coordinates that are constrained (e.g., by a
+    // CoordinateCouplerConstraint) are not sampled, but must be consistent
+    // with the sampled coordinates.
+    const bool mustAssemble =
+            modelCopy.getMatterSubsystem().getNumConstraints() > 0;
+    SimTK::Random::Uniform random(0, 1);
+    random.setSeed(0);
+    auto setRandomPose = [&]() {
+        for (const auto* coord : coords) {
+            coord->setValue(state,
+                    coord->getRangeMin() +
+                            random.getValue() * (coord->getRangeMax() -
+                                                        coord->getRangeMin()),
+                    false);
+        }
+        if (mustAssemble) modelCopy.assemble(state);
+        modelCopy.realizePosition(state);
+    };
+
+    // Determine which coordinates each muscle spans.
+    // ----------------------------------------------
+    std::vector<std::vector<int>> spannedCoords(numMuscles);
+    const int numSpanSamples = std::min(numSamples, 50);
+    std::vector<std::vector<bool>> spans(
+            numMuscles, std::vector<bool>(numCoords, false));
+    for (int isample = 0; isample < numSpanSamples; ++isample) {
+        setRandomPose();
+        for (int im = 0; im < numMuscles; ++im) {
+            const auto& path = muscles[im]->getGeometryPath();
+            for (int ic = 0; ic < numCoords; ++ic) {
+                if (spans[im][ic]) continue;
+                const double momentArm =
+                        path.computeMomentArm(state, *coords[ic]);
+                if (std::abs(momentArm) > momentArmThreshold) {
+                    spans[im][ic] = true;
+                }
+            }
+        }
+    }
+    for (int im = 0; im < numMuscles; ++im) {
+        for (int ic = 0; ic < numCoords; ++ic) {
+            if (spans[im][ic]) spannedCoords[im].push_back(ic);
+        }
+    }
+
+    // Sample coordinate values, lengths, and moment arms.
+    // ---------------------------------------------------
+    SimTK::Matrix coordValues(numSamples, numCoords);
+    SimTK::Matrix lengths(numSamples, numMuscles);
+    // Moment arms about the spanned coordinates only.
+    std::vector<SimTK::Matrix> momentArms(numMuscles);
+    for (int im = 0; im < numMuscles; ++im) {
+        momentArms[im].resize(numSamples, (int)spannedCoords[im].size());
+    }
+    std::vector<long long> pathTimeInNs(numMuscles, 0);
+    for (int isample = 0; isample < numSamples; ++isample) {
+        setRandomPose();
+        for (int ic = 0; ic < numCoords; ++ic) {
+            coordValues(isample, ic) = coords[ic]->getValue(state);
+        }
+        for (int im = 0; im < numMuscles; ++im) {
+            const auto& path = muscles[im]->getGeometryPath();
+            const Stopwatch stopwatch;
+            lengths(isample, im) = path.getLength(state);
+            pathTimeInNs[im] += stopwatch.getElapsedTimeInNs();
+            for (int i = 0; i < (int)spannedCoords[im].size(); ++i) {
+                momentArms[im](isample, i) = path.computeMomentArm(
+                        state, *coords[spannedCoords[im][i]]);
+            }
+        }
+    }
+
+    // Fit the polynomials.
+    // --------------------
+    long long totalPathTimeInNs = 0;
+    long long totalPolynomialTimeInNs = 0;
+    int numFitted = 0;
+    for (int im = 0; im < numMuscles; ++im) {
+        const auto& muscleName = muscles[im]->getAbsolutePathString();
+        const int dimension = (int)spannedCoords[im].size();
+        if (dimension == 0 || dimension > 4) {
+            log_warn("Not fitting a polynomial path for muscle '{}', which "
+                     "spans {} coordinates (must be between 1 and 4).",
+                    muscleName, dimension);
+            continue;
+        }
+        const auto powers = SimTKMultivariatePolynomial<double>::createPowers(
+                dimension, order);
+        const int numTerms = (int)powers.size();
+
+        // The rows of the least-squares problem are the lengths for all
+        // samples followed by the derivatives of length with respect to each
+        // spanned coordinate (the negative of the moment arm).
+        const int numRows = numSamples * (1 + dimension);
+        SimTK::Matrix A(numRows, numTerms);
+        SimTK::Vector b(numRows);
+        for (int isample = 0; isample < numSamples; ++isample) {
+            std::array<double, 4> x{{0, 0, 0, 0}};
+            for (int i = 0; i < dimension; ++i) {
+                x[i] = coordValues(isample, spannedCoords[im][i]);
+            }
+            b[isample] = lengths(isample, im);
+            for (int i = 0; i < dimension; ++i) {
+                b[numSamples * (1 + i) + isample] =
+                        -momentArms[im](isample, i);
+            }
+            for (int iterm = 0; iterm < numTerms; ++iterm) {
+                const auto& nq = powers[iterm];
+                double value = 1;
+                for (int i = 0; i < dimension; ++i) {
+                    value *= std::pow(x[i], nq[i]);
+                }
+                A(isample, iterm) = value;
+                for (int j = 0; j < dimension; ++j) {
+                    double deriv = 0;
+                    if (nq[j] > 0) {
+                        deriv = nq[j] * std::pow(x[j], nq[j] - 1);
+                        for (int i = 0; i < dimension; ++i) {
+                            if (i != j) deriv *= std::pow(x[i], nq[i]);
+                        }
+                    }
+                    A(numSamples * (1 + j) + isample, iterm) = deriv;
+                }
+            }
+        }
+        SimTK::FactorQTZ qtz(A);
+        SimTK::Vector coefficients;
+        qtz.solve(b, coefficients);
+
+        const SimTK::Vector residuals = A * coefficients - b;
+        const double lengthRMS = std::sqrt(
+                residuals(0, numSamples).normSqr() / numSamples);
+        const double momentArmRMS = std::sqrt(
+                residuals(numSamples, numSamples * dimension).normSqr() /
+                (numSamples * dimension));
+
+        // Time the polynomial at the same samples.
+        const SimTKMultivariatePolynomial<double> polynomial(
+                coefficients, dimension, order);
+        SimTK::Vector x(dimension);
+        double sum = 0;
+        const Stopwatch stopwatch;
+        for (int isample = 0; isample < numSamples; ++isample) {
+            for (int i = 0; i < dimension; ++i) {
+                x[i] = coordValues(isample, spannedCoords[im][i]);
+            }
+            sum += polynomial.calcValue(x);
+        }
+        totalPolynomialTimeInNs += stopwatch.getElapsedTimeInNs();
+        totalPathTimeInNs += pathTimeInNs[im];
+        OPENSIM_THROW_IF(SimTK::isNaN(sum), Exception,
+                "Fitting a polynomial path for muscle '{}' produced NaN.",
+                muscleName);
+
+        std::vector<std::string> coordNames;
+        auto& path = model.updComponent<Muscle>(muscleName).updGeometryPath();
+        path.set_use_approximation(true);
+        path.updProperty_length_approximation().clear();
+        path.append_length_approximation(
+                MultivariatePolynomialFunction(coefficients, dimension, order));
+        path.updProperty_approximation_coordinates().clear();
+        for (int i = 0; i < dimension; ++i) {
+            const auto* coord = coords[spannedCoords[im][i]];
+            path.append_approximation_coordinates(
+                    coord->getAbsolutePathString());
+            coordNames.push_back(coord->getName());
+        }
+        ++numFitted;
+        log_info("Fit polynomial path for muscle '{}' (coordinates: {}); "
+                 "RMS error in length: {:.3g} mm, in moment arms: {:.3g} mm.",
+                muscleName, fmt::join(coordNames, ", "), 1000 * lengthRMS,
+                1000 * momentArmRMS);
+    }
+    if (numFitted) {
+        log_info("Computing the lengths of the {} fitted paths at {} poses "
+                 "took {} with the original paths and {} with the "
+                 "polynomials.",
+                numFitted, numSamples, Stopwatch::formatNs(totalPathTimeInNs),
+                Stopwatch::formatNs(totalPolynomialTimeInNs));
+    }
+}
+
+void ModelFactory::aggregateStationPlaneContactForces(Model& model) {
+    std::vector<const StationPlaneContactForce*> forces;
+    for (const auto& force :
+            model.getComponentList<StationPlaneContactForce>()) {
+        if (force.get_appliesForce()) forces.push_back(&force);
+    }
+
+    std::map<std::string, std::unique_ptr<MultiStationPlaneContactForce>>
+            aggregates;
+    auto addStation = [&](const StationPlaneContactForce& force,
+                              const std::string& contactModel)
+            -> MultiStationPlaneContactForce_Station& {
+        auto& aggregate = aggregates[contactModel];
+        if (!aggregate) {
+            aggregate = OpenSim::make_unique<MultiStationPlaneContactForce>();
+            aggregate->setName("contact_" + contactModel);
+            aggregate->set_contact_model(contactModel);
+        }
+        return aggregate->addStation(
+                force.getName(), force.getConnectee<Station>("station"));
+    };
+
+    std::vector<const StationPlaneContactForce*> forcesToRemove;
+    std::vector<std::string> forcesToDisable;
+    for (const auto* force : forces) {
+        if (const auto* avdb =
+                        dynamic_cast<const AckermannVanDenBogert2010Force*>(
+                                force)) {
+            auto& station = addStation(*force, "AckermannVanDenBogert2010");
+            station.set_stiffness(avdb->get_stiffness());
+            station.set_dissipation(avdb->get_dissipation());
+            station.set_friction_coefficient(avdb->get_friction_coefficient());
+            station.set_tangent_velocity_scaling_factor(
+                    avdb->get_tangent_velocity_scaling_factor());
+        } else if (const auto* em =
+                           dynamic_cast<const EspositoMiller2018Force*>(
+                                   force)) {
+            auto& station = addStation(*force, "EspositoMiller2018");
+            station.set_stiffness(em->get_stiffness());
+            station.set_dissipation(em->get_dissipation());
+            station.set_friction_coefficient(em->get_friction_coefficient());
+            station.set_tangent_velocity_scaling_factor(
+                    em->get_tangent_velocity_scaling_factor());
+            station.set_depth_offset(em->get_depth_offset());
+        } else if (const auto* mf =
+                           dynamic_cast<const MeyerFregly2016Force*>(force)) {
+            auto& station = addStation(*force, "MeyerFregly2016");
+            station.set_stiffness(mf->get_stiffness());
+            station.set_dissipation(mf->get_dissipation());
+            station.set_tscale(mf->get_tscale());
+        } else {
+            log_warn("StationPlaneContactForce {} is a {}, which cannot be "
+                     "aggregated; keeping it.",
+                    force->getAbsolutePathString(),
+                    force->getConcreteClassName());
+            continue;
+        }
+        if (model.getForceSet().getIndex(force, 0) == -1) {
+            forcesToDisable.push_back(force->getAbsolutePathString());
+        } else {
+            forcesToRemove.push_back(force);
+        }
+    }
+
+    for (const auto& path : forcesToDisable) {
+        model.updComponent<StationPlaneContactForce>(path).set_appliesForce(
+                false);
+    }
+    for (const auto* force : forcesToRemove) {
+        model.updForceSet().remove(model.getForceSet().getIndex(force, 0));
+    }
+    for (auto& entry : aggregates) {
+        log_info("Replaced {} StationPlaneContactForces with {}.",
+                entry.second->getNumStations(), entry.second->getName());
+        model.addForce(entry.second.release());
+    }
+}
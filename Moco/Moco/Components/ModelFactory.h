@@ -91,6 +91,38 @@ public:
             double bound = SimTK::NaN,
             bool skipCoordinatesWithExistingActuators = true);
 
+    /// Replace the GeometryPath of each muscle with a polynomial of the
+    /// coordinates that the muscle spans (see GeometryPath's
+    /// use_approximation and MultivariatePolynomialFunction), which is much
+    /// cheaper to evaluate than the original path, especially for paths with
+    /// wrapping.
+    ///
+    /// The coordinates are sampled uniformly within their ranges, and the
+    /// polynomial (of the given order) is fit, in the least-squares sense, to
+    /// the muscle's length and moment arms at the sampled poses. A muscle
+    /// spans a coordinate if the muscle's moment arm about the coordinate
+    /// exceeds momentArmThreshold in magnitude at any of a set of random
+    /// poses. Muscles that span more than 4 coordinates, and muscles whose
+    /// path already uses an approximation, are not changed. Locked and
+    /// constrained (e.g., coupled) coordinates are held at their default
+    /// values while sampling and are never part of the approximation. The
+    /// root-mean-square error of each fit, and the time to compute the
+    /// lengths of the original paths and of the polynomials, are logged.
+    static void fitPolynomialMusclePaths(Model& model, int order = 5,
+            int numSamples = 1000, double momentArmThreshold = 1e-4);
+
+    /// Replace the StationPlaneContactForces in the model with one
+    /// MultiStationPlaneContactForce for each type of contact model, which
+    /// applies the same forces at lower cost. Each station of the
+    /// MultiStationPlaneContactForce has the name and contact parameters of
+    /// the force it replaces and connects to the same Station. Forces in the
+    /// model's ForceSet are removed; other StationPlaneContactForces are
+    /// disabled (appliesForce is set to false). Forces that are already
+    /// disabled are not changed.
+    /// @note Components that refer to the replaced forces (e.g., MocoParameter)
+    /// must refer to the new MultiStationPlaneContactForce%s instead.
+    static void aggregateStationPlaneContactForces(Model& model);
+
     /// @}
 };
 
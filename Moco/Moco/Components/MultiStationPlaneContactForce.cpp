@@ -0,0 +1,289 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MultiStationPlaneContactForce.cpp                            *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "MultiStationPlaneContactForce.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <OpenSim/Simulation/Model/Model.h>
+
+using namespace OpenSim;
+
+//=============================================================================
+//  MultiStationPlaneContactForce_Station
+//=============================================================================
+
+MultiStationPlaneContactForce_Station::MultiStationPlaneContactForce_Station() {
+    constructProperties();
+}
+
+void MultiStationPlaneContactForce_Station::constructProperties() {
+    constructProperty_stiffness(5e7);
+    constructProperty_dissipation(1.0);
+    constructProperty_friction_coefficient(1.0);
+    constructProperty_tangent_velocity_scaling_factor(0.05);
+    constructProperty_depth_offset(0.001);
+    constructProperty_tscale(1.0);
+}
+
+//=============================================================================
+//  MultiStationPlaneContactForce
+//=============================================================================
+
+MultiStationPlaneContactForce::MultiStationPlaneContactForce() {
+    constructProperties();
+}
+
+void MultiStationPlaneContactForce::constructProperties() {
+    constructProperty_contact_model("AckermannVanDenBogert2010");
+    constructProperty_stations();
+}
+
+MultiStationPlaneContactForce_Station&
+MultiStationPlaneContactForce::addStation(
+        const std::string& name, const Station& station) {
+    append_stations(MultiStationPlaneContactForce_Station());
+    auto& entry = upd_stations(getProperty_stations().size() - 1);
+    entry.setName(name);
+    entry.connectSocket_station(station);
+    return entry;
+}
+
+void MultiStationPlaneContactForce::extendFinalizeFromProperties() {
+    Super::extendFinalizeFromProperties();
+    const auto& contactModel = get_contact_model();
+    if (contactModel == "AckermannVanDenBogert2010") {
+        m_contactModel = ContactModel::AckermannVanDenBogert2010;
+    } else if (contactModel == "EspositoMiller2018") {
+        m_contactModel = ContactModel::EspositoMiller2018;
+    } else if (contactModel == "MeyerFregly2016") {
+        m_contactModel = ContactModel::MeyerFregly2016;
+    } else {
+        OPENSIM_THROW_FRMOBJ(Exception,
+                "Expected contact_model to be 'AckermannVanDenBogert2010', "
+                "'EspositoMiller2018', or 'MeyerFregly2016', but got '{}'.",
+                contactModel);
+    }
+}
+
+void MultiStationPlaneContactForce::extendRealizeTopology(
+        SimTK::State& state) const {
+    Super::extendRealizeTopology(state);
+
+    const int numStations = getNumStations();
+    std::vector<SimTK::MobilizedBodyIndex> bodyOfStation(numStations);
+    for (int i = 0; i < numStations; ++i) {
+        const auto& frame = get_stations(i).getStation().getParentFrame();
+        bodyOfStation[i] = frame.getMobilizedBodyIndex();
+    }
+    m_order.resize(numStations);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::stable_sort(m_order.begin(), m_order.end(),
+            [&bodyOfStation](int a, int b) {
+                return bodyOfStation[a] < bodyOfStation[b];
+            });
+
+    m_bodies.clear();
+    m_bodyStart.clear();
+    m_locationInBody.resize(numStations);
+    m_stiffness.resize(numStations);
+    m_dissipation.resize(numStations);
+    m_frictionCoefficient.resize(numStations);
+    m_velocityScaling.resize(numStations);
+    m_depthOffsetSquared.resize(numStations);
+    m_tscale.resize(numStations);
+    for (int i = 0; i < numStations; ++i) {
+        const int istation = m_order[i];
+        if (m_bodies.empty() || m_bodies.back() != bodyOfStation[istation]) {
+            m_bodies.push_back(bodyOfStation[istation]);
+            m_bodyStart.push_back(i);
+        }
+        const auto& entry = get_stations(istation);
+        const auto& station = entry.getStation();
+        m_locationInBody[i] =
+                station.getParentFrame().findTransformInBaseFrame() *
+                station.get_location();
+        m_stiffness[i] = entry.get_stiffness();
+        m_dissipation[i] = entry.get_dissipation();
+        m_frictionCoefficient[i] = entry.get_friction_coefficient();
+        m_velocityScaling[i] = entry.get_tangent_velocity_scaling_factor();
+        m_depthOffsetSquared[i] = SimTK::square(entry.get_depth_offset());
+        m_tscale[i] = entry.get_tscale();
+    }
+    m_bodyStart.push_back(numStations);
+
+    m_offsetInGround.resize(numStations);
+    m_height.resize(numStations);
+    m_velNormal.resize(numStations);
+    m_velSliding.resize(numStations);
+    m_forceX.resize(numStations);
+    m_forceY.resize(numStations);
+}
+
+void MultiStationPlaneContactForce::calcContactForcesInBuffers(
+        const SimTK::State& s) const {
+    // Station kinematics, one body at a time.
+    const auto& matter = getModel().getMatterSubsystem();
+    for (int ibody = 0; ibody < (int)m_bodies.size(); ++ibody) {
+        const auto& mobod = matter.getMobilizedBody(m_bodies[ibody]);
+        const SimTK::Transform& X_GB = mobod.getBodyTransform(s);
+        const SimTK::SpatialVec& V_GB = mobod.getBodyVelocity(s);
+        for (int i = m_bodyStart[ibody]; i < m_bodyStart[ibody + 1]; ++i) {
+            const SimTK::Vec3 offset = X_GB.R() * m_locationInBody[i];
+            const SimTK::Vec3 velocity = V_GB[1] + V_GB[0] % offset;
+            m_offsetInGround[i] = offset;
+            m_height[i] = X_GB.p()[1] + offset[1];
+            m_velNormal[i] = velocity[1];
+            // TODO should project vel into ground.
+            m_velSliding[i] = velocity[0];
+        }
+    }
+
+    // Contact model, all stations at once. These are the same equations as
+    // in the StationPlaneContactForce classes.
+    const int numStations = (int)m_height.size();
+    const double* height = m_height.data();
+    const double* velNormal = m_velNormal.data();
+    const double* velSliding = m_velSliding.data();
+    const double* stiffness = m_stiffness.data();
+    const double* dissipation = m_dissipation.data();
+    double* forceX = m_forceX.data();
+    double* forceY = m_forceY.data();
+    const double voidStiffness = 1.0; // N/m
+    switch (m_contactModel) {
+    case ContactModel::AckermannVanDenBogert2010: {
+        const double* mu = m_frictionCoefficient.data();
+        const double* velScaling = m_velocityScaling.data();
+        for (int i = 0; i < numStations; ++i) {
+            const double depth = 0 - height[i];
+            const double depthRate = 0 - velNormal[i];
+            // The force from the spring is zero if depth <= 0.
+            const double pos = std::max(depth, 0.0);
+            const double Fy =
+                    std::max(0.0, stiffness[i] * pos * pos * pos *
+                                          (1 + dissipation[i] * depthRate)) +
+                    voidStiffness * depth;
+            const double transition = tanh(velSliding[i] / velScaling[i] / 2);
+            forceY[i] = Fy;
+            forceX[i] = -transition * mu[i] * Fy;
+        }
+        break;
+    }
+    case ContactModel::EspositoMiller2018: {
+        const double* mu = m_frictionCoefficient.data();
+        const double* velScaling = m_velocityScaling.data();
+        const double* depthOffsetSquared = m_depthOffsetSquared.data();
+        for (int i = 0; i < numStations; ++i) {
+            const double depth = 0 - height[i];
+            const double depthRate = 0 - velNormal[i];
+            const double dy =
+                    0.5 * (sqrt(depth * depth + depthOffsetSquared[i]) +
+                                  depth);
+            const double Fy =
+                    stiffness[i] * dy * dy * (1 + dissipation[i] * depthRate) +
+                    voidStiffness * depth;
+            const double transition = tanh(velSliding[i] / velScaling[i]);
+            forceY[i] = Fy;
+            forceX[i] = -transition * mu[i] * Fy;
+        }
+        break;
+    }
+    case ContactModel::MeyerFregly2016: {
+        const double* tscale = m_tscale.data();
+        const double h = 1e-3;
+        const double c = 5e-4;
+        const double ymax = 1e-2;
+        const double mu_d = 1;
+        const double latchvel = 0.05; // m/s
+        for (int i = 0; i < numStations; ++i) {
+            const double depthRate = 0 - velNormal[i];
+            const double klow = 1e-1 / (tscale[i] * tscale[i]);
+            const double vp = (stiffness[i] + klow) / (stiffness[i] - klow);
+            const double sp = (stiffness[i] - klow) / 2;
+            const double constant =
+                    -sp * (vp * ymax - c * log(cosh((ymax + h) / c)));
+            const double y = height[i];
+            double Fspring =
+                    -sp * (vp * y - c * log(cosh((y + h) / c))) - constant;
+            if (!SimTK::isFinite(Fspring)) Fspring = 0;
+            const double Fy = Fspring * (1 + dissipation[i] * depthRate);
+            forceY[i] = Fy;
+            forceX[i] = -Fy * mu_d * tanh(velSliding[i] / latchvel / 2);
+        }
+        break;
+    }
+    }
+}
+
+void MultiStationPlaneContactForce::calcContactForces(
+        const SimTK::State& s, SimTK::Vector_<SimTK::Vec3>& forces) const {
+    calcContactForcesInBuffers(s);
+    forces.resize(getNumStations());
+    for (int i = 0; i < (int)m_order.size(); ++i) {
+        forces[m_order[i]] = SimTK::Vec3(m_forceX[i], m_forceY[i], 0);
+    }
+}
+
+void MultiStationPlaneContactForce::computeForce(const SimTK::State& s,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector& /*generalizedForces*/) const {
+    calcContactForcesInBuffers(s);
+    const auto& matter = getModel().getMatterSubsystem();
+    SimTK::SpatialVec& groundForce = bodyForces[SimTK::GroundIndex];
+    for (int ibody = 0; ibody < (int)m_bodies.size(); ++ibody) {
+        const SimTK::Vec3& bodyOrigin =
+                matter.getMobilizedBody(m_bodies[ibody]).getBodyOriginLocation(
+                        s);
+        SimTK::SpatialVec bodyForce(SimTK::Vec3(0), SimTK::Vec3(0));
+        for (int i = m_bodyStart[ibody]; i < m_bodyStart[ibody + 1]; ++i) {
+            const SimTK::Vec3 force(m_forceX[i], m_forceY[i], 0);
+            bodyForce[0] += m_offsetInGround[i] % force;
+            bodyForce[1] += force;
+            // The equal and opposite force on ground, at the station.
+            groundForce[0] -= (bodyOrigin + m_offsetInGround[i]) % force;
+            groundForce[1] -= force;
+        }
+        bodyForces[m_bodies[ibody]] += bodyForce;
+    }
+}
+
+OpenSim::Array<std::string>
+MultiStationPlaneContactForce::getRecordLabels() const {
+    OpenSim::Array<std::string> labels;
+    for (int i = 0; i < getNumStations(); ++i) {
+        const auto& stationName = get_stations(i).getStation().getName();
+        labels.append(getName() + "." + stationName + ".force.X");
+        labels.append(getName() + "." + stationName + ".force.Y");
+        labels.append(getName() + "." + stationName + ".force.Z");
+    }
+    return labels;
+}
+
+OpenSim::Array<double> MultiStationPlaneContactForce::getRecordValues(
+        const SimTK::State& s) const {
+    OpenSim::Array<double> values;
+    SimTK::Vector_<SimTK::Vec3> forces;
+    calcContactForces(s, forces);
+    for (int i = 0; i < forces.size(); ++i) {
+        values.append(forces[i][0]);
+        values.append(forces[i][1]);
+        values.append(forces[i][2]);
+    }
+    return values;
+}
@@ -0,0 +1,167 @@
+#ifndef MOCO_MULTISTATIONPLANECONTACTFORCE_H
+#define MOCO_MULTISTATIONPLANECONTACTFORCE_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MultiStationPlaneContactForce.h                              *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "../osimMocoDLL.h"
+
+#include <OpenSim/Simulation/Model/Force.h>
+#include <OpenSim/Simulation/Model/Station.h>
+
+namespace OpenSim {
+
+/// A station that contacts the plane in a MultiStationPlaneContactForce, and
+/// the contact parameters for this station. Each contact model uses only
+/// some of the parameters; see MultiStationPlaneContactForce.
+class OSIMMOCO_API MultiStationPlaneContactForce_Station : public Component {
+    OpenSim_DECLARE_CONCRETE_OBJECT(
+            MultiStationPlaneContactForce_Station, Component);
+
+public:
+    OpenSim_DECLARE_PROPERTY(stiffness, double,
+            "Spring stiffness (default: 5e7).");
+    OpenSim_DECLARE_PROPERTY(dissipation, double,
+            "Dissipation coefficient in s/m (default: 1.0).");
+    OpenSim_DECLARE_PROPERTY(friction_coefficient, double,
+            "Friction coefficient (default: 1.0).");
+    OpenSim_DECLARE_PROPERTY(tangent_velocity_scaling_factor, double,
+            "Governs how rapidly friction develops (default: 0.05).");
+    OpenSim_DECLARE_PROPERTY(depth_offset, double,
+            "Depth offset of EspositoMiller2018 (default: 0.001).");
+    OpenSim_DECLARE_PROPERTY(tscale, double,
+            "tscale of MeyerFregly2016 (default: 1.0).");
+
+    OpenSim_DECLARE_SOCKET(station, Station,
+            "The body-fixed point that can contact the plane.");
+
+    MultiStationPlaneContactForce_Station();
+
+    const Station& getStation() const {
+        return getConnectee<Station>("station");
+    }
+
+private:
+    void constructProperties();
+};
+
+/// This class applies the contact forces for many stations with a ground
+/// plane y=0 and is equivalent to one StationPlaneContactForce (of the type
+/// given by the contact_model property) per station. It is much cheaper to
+/// evaluate than the separate forces for models with many contact stations
+/// (e.g., 6-12 per foot):
+///  - the stations are grouped by the body to which they are attached, and
+///    the kinematics of each body are obtained once;
+///  - the contact parameters and station kinematics are stored as separate
+///    arrays (structure-of-arrays), and the contact model is evaluated for
+///    all stations in a single loop that the compiler can vectorize;
+///  - the forces on each body are summed before they are applied.
+///
+/// The contact models use the following parameters of each station:
+///  - AckermannVanDenBogert2010: stiffness, dissipation,
+///    friction_coefficient, tangent_velocity_scaling_factor.
+///  - EspositoMiller2018: stiffness, dissipation, friction_coefficient,
+///    tangent_velocity_scaling_factor, depth_offset.
+///  - MeyerFregly2016: stiffness, dissipation, tscale.
+///
+/// Use ModOpAggregateStationPlaneContactForces (or
+/// ModelFactory::aggregateStationPlaneContactForces()) to replace the
+/// StationPlaneContactForces in a model with this class.
+///
+/// @note This component uses internal buffers while computing forces, so the
+/// same instance must not compute forces from multiple threads at once (Moco
+/// solvers use a separate copy of the model for each thread).
+class OSIMMOCO_API MultiStationPlaneContactForce : public Force {
+    OpenSim_DECLARE_CONCRETE_OBJECT(MultiStationPlaneContactForce, Force);
+
+public:
+    OpenSim_DECLARE_PROPERTY(contact_model, std::string,
+            "'AckermannVanDenBogert2010' (default), 'EspositoMiller2018', or "
+            "'MeyerFregly2016'.");
+    OpenSim_DECLARE_LIST_PROPERTY(stations,
+            MultiStationPlaneContactForce_Station,
+            "The stations that can contact the plane, and their contact "
+            "parameters.");
+
+    MultiStationPlaneContactForce();
+
+    int getNumStations() const { return getProperty_stations().size(); }
+
+    /// Add a station with the default contact parameters, and return it so
+    /// that its parameters can be edited.
+    MultiStationPlaneContactForce_Station& addStation(
+            const std::string& name, const Station& station);
+
+    /// Compute the force applied to the body to which each station is
+    /// attached, at the station, expressed in ground. The forces are in the
+    /// order of the stations property. The state must be realized to
+    /// Velocity.
+    void calcContactForces(
+            const SimTK::State& s, SimTK::Vector_<SimTK::Vec3>& forces) const;
+
+    void computeForce(const SimTK::State& s,
+            SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+            SimTK::Vector& generalizedForces) const override;
+
+    OpenSim::Array<std::string> getRecordLabels() const override;
+    OpenSim::Array<double> getRecordValues(
+            const SimTK::State& s) const override;
+
+private:
+    enum class ContactModel {
+        AckermannVanDenBogert2010,
+        EspositoMiller2018,
+        MeyerFregly2016
+    };
+
+    void constructProperties();
+    void extendFinalizeFromProperties() override;
+    void extendRealizeTopology(SimTK::State&) const override;
+
+    /// Compute the location and velocity of each station, and the offset from
+    /// the origin of the station's body to the station (expressed in ground),
+    /// and evaluate the contact model. The results are stored in the buffers
+    /// below, in the order of m_order.
+    void calcContactForcesInBuffers(const SimTK::State& s) const;
+
+    ContactModel m_contactModel;
+
+    /// @name Structure-of-arrays
+    /// Stations are sorted by body; the stations on body m_bodies[ibody] are
+    /// m_bodyStart[ibody] through m_bodyStart[ibody + 1] - 1. Element i
+    /// corresponds to the station m_order[i] in the stations property.
+    /// @{
+    mutable std::vector<SimTK::MobilizedBodyIndex> m_bodies;
+    mutable std::vector<int> m_bodyStart;
+    mutable std::vector<int> m_order;
+    mutable std::vector<SimTK::Vec3> m_locationInBody;
+    mutable std::vector<double> m_stiffness;
+    mutable std::vector<double> m_dissipation;
+    mutable std::vector<double> m_frictionCoefficient;
+    mutable std::vector<double> m_velocityScaling;
+    mutable std::vector<double> m_depthOffsetSquared;
+    mutable std::vector<double> m_tscale;
+    // Buffers for computing forces.
+    mutable std::vector<SimTK::Vec3> m_offsetInGround;
+    mutable std::vector<double> m_height, m_velNormal, m_velSliding;
+    mutable std::vector<double> m_forceX, m_forceY;
+    /// @}
+};
+
+} // namespace OpenSim
+
+#endif // MOCO_MULTISTATIONPLANECONTACTFORCE_H
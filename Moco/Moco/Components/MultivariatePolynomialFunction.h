@@ -21,6 +21,9 @@
 #include "../MocoUtilities.h"
 #include "../osimMocoDLL.h"
 
+#include <array>
+#include <vector>
+
 namespace OpenSim {
 
 template <class T>
@@ -64,125 +67,105 @@ public:
             coefficients(coefficients), dimension(dimension), order(order) {
         OPENSIM_THROW_IF(dimension < 0 || dimension > 4, Exception,
                 "Expected dimension >= 0 && <=4 but got {}.", dimension);
+        powers = createPowers(dimension, order);
+        OPENSIM_THROW_IF(coefficients.size() != (int)powers.size(), Exception,
+                "Expected {} coefficients but got {}.", powers.size(),
+                coefficients.size());
+    }
+    /// The powers of X, Y, Z, and W in each term of a polynomial with the
+    /// given dimension and order, in the order of the coefficients (see the
+    /// table above). The powers of the unused components are 0.
+    static std::vector<std::array<int, 4>> createPowers(
+            int dimension, int order) {
+        std::vector<std::array<int, 4>> powers;
         std::array<int, 4> nq {{0, 0, 0, 0}};
-        int coeff_nr = 0;
         for (nq[0] = 0; nq[0] < order + 1; ++nq[0]) {
-            int nq2_s;
-            if (dimension < 2) nq2_s = 0;
-            else nq2_s = order - nq[0];
+            const int nq2_s = dimension < 2 ? 0 : order - nq[0];
             for (nq[1] = 0; nq[1] < nq2_s + 1; ++nq[1]) {
-                int nq3_s;
-                if (dimension < 3) nq3_s = 0;
-                else nq3_s = order - nq[0] - nq[1];
+                const int nq3_s = dimension < 3 ? 0 : order - nq[0] - nq[1];
                 for (nq[2] = 0; nq[2] < nq3_s + 1; ++nq[2]) {
-                    int nq4_s;
-                    if (dimension < 4) nq4_s = 0;
-                    else nq4_s = order - nq[0] - nq[1] - nq[2];
+                    const int nq4_s = dimension < 4
+                            ? 0 : order - nq[0] - nq[1] - nq[2];
                     for (nq[3] = 0; nq[3] < nq4_s + 1; ++nq[3]) {
-                        ++coeff_nr;
+                        powers.push_back(nq);
                     }
                 }
             }
         }
-        OPENSIM_THROW_IF(coefficients.size() != coeff_nr, Exception,
-                "Expected {} coefficients but got {}.", coeff_nr,
-                coefficients.size());
+        return powers;
     }
     T calcValue(const SimTK::Vector& x) const override {
-        std::array<int, 4> nq {{0, 0, 0, 0}};
+        const double* xp = calcPowersOfX(x);
+        const int stride = order + 1;
         T value = static_cast<T>(0);
-        int coeff_nr = 0;
-        for (nq[0] = 0; nq[0] < order + 1; ++nq[0]) {
-            int nq2_s;
-            if (dimension < 2) nq2_s = 0;
-            else nq2_s = order - nq[0];
-            for (nq[1] = 0; nq[1] < nq2_s + 1; ++nq[1]) {
-                int nq3_s;
-                if (dimension < 3) nq3_s = 0;
-                else nq3_s = order - nq[0] - nq[1];
-                for (nq[2] = 0; nq[2] < nq3_s + 1; ++nq[2]) {
-                    int nq4_s;
-                    if (dimension < 4) nq4_s = 0;
-                    else nq4_s = order - nq[0] - nq[1] - nq[2];
-                    for (nq[3] = 0; nq[3] < nq4_s + 1; ++nq[3]) {
-                        T valueP = static_cast<T>(1);
-                        for (int i = 0; i < dimension; ++i) {
-                            valueP *= std::pow(x[i], nq[i]);
-                        }
-                        value += valueP * coefficients[coeff_nr];
-                        ++coeff_nr;
-                    }
-                }
-            }
+        for (int iterm = 0; iterm < (int)powers.size(); ++iterm) {
+            const auto& nq = powers[iterm];
+            value += coefficients[iterm] * (xp[nq[0]] * xp[stride + nq[1]] *
+                                            xp[2 * stride + nq[2]] *
+                                            xp[3 * stride + nq[3]]);
         }
         return value;
     }
+    /// Only first derivatives are supported. The derivative with respect to
+    /// a component outside [0, dimension) is 0.
     T calcDerivative(const SimTK::Array_<int>& derivComponent,
                      const SimTK::Vector& x) const override {
-        std::array<int, 4> nq {{0, 0, 0, 0}};
+        const int j = derivComponent[0];
+        if (j < 0 || j >= dimension) return static_cast<T>(0);
+        const double* xp = calcPowersOfX(x);
+        const int stride = order + 1;
         T value = static_cast<T>(0);
-        int nqNonNegative;
-        int coeff_nr = 0;
-        for (nq[0] = 0; nq[0] < order + 1; ++nq[0]) {
-            int nq2_s;
-            if (dimension < 2) nq2_s = 0;
-            else nq2_s = order - nq[0];
-            for (nq[1] = 0; nq[1] < nq2_s + 1; ++nq[1]) {
-                int nq3_s;
-                if (dimension < 3) nq3_s = 0;
-                else nq3_s = order - nq[0] - nq[1];
-                for (nq[2] = 0; nq[2] < nq3_s + 1; ++nq[2]) {
-                    int nq4_s;
-                    if (dimension < 4) nq4_s = 0;
-                    else nq4_s = order - nq[0] - nq[1] - nq[2];
-                    for (nq[3] = 0; nq[3] < nq4_s + 1; ++nq[3]) {
-                        if (derivComponent[0] == 0) {
-                            nqNonNegative = nq[0] - 1;
-                            if (nqNonNegative < 0) nqNonNegative = 0;
-                            T valueP = nq[0] * std::pow(x[0], nqNonNegative);
-                            for (int i = 0; i < dimension; ++i) {
-                                if (i == derivComponent[0]) continue;
-                                valueP *= std::pow(x[i], nq[i]);
-                            }
-                            value += valueP * coefficients[coeff_nr];
-                        }
-                        else if (derivComponent[0] == 1) {
-                            nqNonNegative = nq[1] - 1;
-                            if (nqNonNegative < 0) nqNonNegative = 0;
-                            T valueP = nq[1] * std::pow(x[1], nqNonNegative);
-                            for (int i = 0; i < dimension; ++i) {
-                                if (i == derivComponent[0]) continue;
-                                valueP *= std::pow(x[i], nq[i]);
-                            }
-                            value += valueP * coefficients[coeff_nr];
-                        }
-                        else if (derivComponent[0] == 2) {
-                            nqNonNegative = nq[2] - 1;
-                            if (nqNonNegative < 0) nqNonNegative = 0;
-                            T valueP = nq[2] * std::pow(x[2], nqNonNegative);
-                            for (int i = 0; i < dimension; ++i) {
-                                if (i == derivComponent[0]) continue;
-                                valueP *= std::pow(x[i], nq[i]);
-                            }
-                            value += valueP * coefficients[coeff_nr];
-                        }
-                        else if (derivComponent[0] == 3) {
-                            nqNonNegative = nq[3] - 1;
-                            if (nqNonNegative < 0) nqNonNegative = 0;
-                            T valueP = nq[3] * std::pow(x[3], nqNonNegative);
-                            for (int i = 0; i < dimension; ++i) {
-                                if (i == derivComponent[0]) continue;
-                                valueP *= std::pow(x[i], nq[i]);
-                            }
-                            value += valueP * coefficients[coeff_nr];
-                        }
-                        ++coeff_nr;
-                    }
-                }
+        for (int iterm = 0; iterm < (int)powers.size(); ++iterm) {
+            const auto& nq = powers[iterm];
+            if (nq[j] == 0) continue;
+            double term = nq[j] * xp[j * stride + nq[j] - 1];
+            for (int i = 0; i < 4; ++i) {
+                if (i != j) term *= xp[i * stride + nq[i]];
             }
+            value += coefficients[iterm] * term;
         }
         return value;
     }
+    /// Compute the value and the gradient (the first derivative with respect
+    /// to each component) in a single pass over the terms. This is faster
+    /// than calling calcValue() and calcDerivative() for each component.
+    void calcValueAndGradient(const SimTK::Vector& x, T& value,
+            SimTK::Vector_<T>& gradient) const {
+        const double* xp = calcPowersOfX(x);
+        const int stride = order + 1;
+        value = static_cast<T>(0);
+        gradient.resize(dimension);
+        gradient.setToZero();
+        for (int iterm = 0; iterm < (int)powers.size(); ++iterm) {
+            const auto& nq = powers[iterm];
+            const std::array<double, 4> factors{{xp[nq[0]],
+                    xp[stride + nq[1]], xp[2 * stride + nq[2]],
+                    xp[3 * stride + nq[3]]}};
+            value += coefficients[iterm] *
+                     (factors[0] * factors[1] * factors[2] * factors[3]);
+            for (int j = 0; j < dimension; ++j) {
+                if (nq[j] == 0) continue;
+                double term = nq[j] * xp[j * stride + nq[j] - 1];
+                for (int i = 0; i < 4; ++i) {
+                    if (i != j) term *= factors[i];
+                }
+                gradient[j] += coefficients[iterm] * term;
+            }
+        }
+    }
+    /// Evaluate the polynomial at multiple points; each row of `x` is a
+    /// point. The loops over the points are innermost and operate on
+    /// contiguous memory, so that the compiler can vectorize them.
+    void calcValues(const SimTK::Matrix& x, SimTK::Vector_<T>& values) const {
+        SimTK::Matrix_<T> gradients;
+        calcValuesAndGradientsImpl(x, values, gradients, false);
+    }
+    /// Evaluate the polynomial and its gradient at multiple points; each row
+    /// of `x` is a point. Row i of `gradients` is the gradient at point i.
+    void calcValuesAndGradients(const SimTK::Matrix& x,
+            SimTK::Vector_<T>& values, SimTK::Matrix_<T>& gradients) const {
+        calcValuesAndGradientsImpl(x, values, gradients, true);
+    }
     int getArgumentSize() const override {
         return dimension;
     }
@@ -197,9 +180,91 @@ public:
         return calcDerivative(SimTK::ArrayViewConst_<int>(derivComponent), x);
     }
 private:
+    /// A per-thread buffer, so that evaluating the polynomial does not
+    /// allocate memory.
+    static std::vector<double>& updBuffer() {
+        static thread_local std::vector<double> buffer;
+        return buffer;
+    }
+    /// Return a table whose element i * (order + 1) + k is x[i]^k, for all 4
+    /// components (x[i] is 1 for the unused components).
+    const double* calcPowersOfX(const SimTK::Vector& x) const {
+        const int stride = order + 1;
+        auto& table = updBuffer();
+        table.resize(4 * stride);
+        for (int i = 0; i < 4; ++i) {
+            const double xi = i < dimension ? x[i] : 1.0;
+            double* row = table.data() + i * stride;
+            row[0] = 1;
+            for (int k = 1; k < stride; ++k) row[k] = row[k - 1] * xi;
+        }
+        return table.data();
+    }
+    void calcValuesAndGradientsImpl(const SimTK::Matrix& x,
+            SimTK::Vector_<T>& values, SimTK::Matrix_<T>& gradients,
+            bool calcGradients) const {
+        OPENSIM_THROW_IF(x.ncol() != dimension, Exception,
+                "Expected x to have {} columns but it has {}.", dimension,
+                x.ncol());
+        const int numPoints = x.nrow();
+        values.resize(numPoints);
+        values.setToZero();
+        if (calcGradients) {
+            gradients.resize(numPoints, dimension);
+            gradients.setToZero();
+        }
+        if (numPoints == 0) return;
+
+        // Element (i * (order + 1) + k) * numPoints + p is x(p, i)^k.
+        const int stride = order + 1;
+        auto& table = updBuffer();
+        table.resize(4 * stride * numPoints);
+        for (int i = 0; i < 4; ++i) {
+            double* row0 = table.data() + i * stride * numPoints;
+            for (int p = 0; p < numPoints; ++p) {
+                row0[p] = 1;
+            }
+            for (int k = 1; k < stride; ++k) {
+                double* row = row0 + k * numPoints;
+                const double* previous = row - numPoints;
+                for (int p = 0; p < numPoints; ++p) {
+                    row[p] = previous[p] * (i < dimension ? x(p, i) : 1.0);
+                }
+            }
+        }
+        auto getPowers = [&](int i, int k) {
+            return table.data() + (i * stride + k) * numPoints;
+        };
+
+        T* v = &values[0];
+        for (int iterm = 0; iterm < (int)powers.size(); ++iterm) {
+            const auto& nq = powers[iterm];
+            const T c = coefficients[iterm];
+            const double* f0 = getPowers(0, nq[0]);
+            const double* f1 = getPowers(1, nq[1]);
+            const double* f2 = getPowers(2, nq[2]);
+            const double* f3 = getPowers(3, nq[3]);
+            for (int p = 0; p < numPoints; ++p) {
+                v[p] += c * (f0[p] * f1[p] * f2[p] * f3[p]);
+            }
+            if (!calcGradients) continue;
+            for (int j = 0; j < dimension; ++j) {
+                if (nq[j] == 0) continue;
+                std::array<const double*, 4> f{{f0, f1, f2, f3}};
+                f[j] = getPowers(j, nq[j] - 1);
+                const T cj = c * static_cast<double>(nq[j]);
+                T* g = &gradients(0, j);
+                for (int p = 0; p < numPoints; ++p) {
+                    g[p] += cj * (f[0][p] * f[1][p] * f[2][p] * f[3][p]);
+                }
+            }
+        }
+    }
+
     SimTK::Vector_<T> coefficients;
     int dimension;
     int order;
+    std::vector<std::array<int, 4>> powers;
 };
 
 class OSIMMOCO_API MultivariatePolynomialFunction : public Function {
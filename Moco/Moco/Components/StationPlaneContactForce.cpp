@@ -53,3 +53,113 @@ void StationPlaneContactForce::generateDecorations(
         geoms.push_back(sphere);
     }
 }
+
+SimTK::Vec3 AckermannVanDenBogert2010Force::calcContactForce(
+        const SimTK::Vec3& location, const SimTK::Vec3& velocity) const {
+    SimTK::Vec3 force(0);
+    const SimTK::Real y = location[1];
+    const SimTK::Real velNormal = velocity[1];
+    // TODO should project vel into ground.
+    const SimTK::Real velSliding = velocity[0];
+    const SimTK::Real depth = 0 - y;
+    const SimTK::Real depthRate = 0 - velNormal;
+    const SimTK::Real& a = get_stiffness();
+    const SimTK::Real& b = get_dissipation();
+    if (depth > 0) {
+        force[1] = fmax(0, a * pow(depth, 3) * (1 + b * depthRate));
+    }
+    const SimTK::Real voidStiffness = 1.0; // N/m
+    force[1] += voidStiffness * depth;
+
+    const SimTK::Real velSlidingScaling =
+            get_tangent_velocity_scaling_factor();
+    // The paper used (1 - exp(-x)) / (1 + exp(-x)) = tanh(2x).
+    // tanh() has a wider domain than using exp().
+    const SimTK::Real transition = tanh(velSliding / velSlidingScaling / 2);
+
+    const SimTK::Real frictionForce =
+            -transition * get_friction_coefficient() * force[1];
+
+    force[0] = frictionForce;
+    return force;
+}
+
+SimTK::Vec3 MeyerFregly2016Force::calcContactForce(
+        const SimTK::Vec3& location, const SimTK::Vec3& velocity) const {
+    SimTK::Vec3 force(0);
+    const SimTK::Real y = location[1];
+    const SimTK::Real velNormal = velocity[1];
+    // TODO should project vel into ground.
+    const SimTK::Real velSliding = velocity[0];
+    // const SimTK::Real depth = 0 - y;
+    const SimTK::Real depthRate = 0 - velNormal;
+    const SimTK::Real Kval = get_stiffness();
+    const SimTK::Real Cval = get_dissipation();
+    const SimTK::Real tscale = get_tscale();
+    const SimTK::Real klow = 1e-1 / (tscale * tscale);
+    const SimTK::Real h = 1e-3;
+    const SimTK::Real c = 5e-4;
+    const SimTK::Real ymax = 1e-2;
+
+    /// Normal force.
+    const SimTK::Real vp = (Kval + klow) / (Kval - klow);
+    const SimTK::Real sp = (Kval - klow) / 2;
+
+    const SimTK::Real constant =
+            -sp * (vp * ymax - c * log(cosh((ymax + h) / c)));
+
+    SimTK::Real Fspring =
+            -sp * (vp * y - c * log(cosh((y + h) / c))) - constant;
+    if (SimTK::isNaN(Fspring) || SimTK::isInf(Fspring)) {
+        Fspring = 0;
+    }
+
+    const SimTK::Real Fy = Fspring * (1 + Cval * depthRate);
+
+    force[1] = Fy;
+
+    /// Friction force.
+    const SimTK::Real mu_d = 1;
+    const SimTK::Real latchvel = 0.05; // m/s
+
+    const SimTK::Real mu = mu_d * tanh(velSliding / latchvel / 2);
+    force[0] = -force[1] * mu;
+
+    return force;
+}
+
+SimTK::Vec3 EspositoMiller2018Force::calcContactForce(
+        const SimTK::Vec3& location, const SimTK::Vec3& velocity) const {
+    using SimTK::square;
+    SimTK::Vec3 force(0);
+    const SimTK::Real height = location[1];
+    const SimTK::Real velNormal = velocity[1];
+    // TODO should project vel into ground.
+    const SimTK::Real velSliding = velocity[0];
+
+    // The Appendix of Esposito and Miller 2018 uses height above ground,
+    // but we use penetration depth, so some signs are reversed.
+
+    // Normal force.
+    const SimTK::Real depth = 0 - height;
+    const SimTK::Real depthRate = 0 - velNormal;
+    const SimTK::Real a = get_stiffness();
+    const SimTK::Real b = get_dissipation();
+
+    // dy approaches 0 as y -> inf
+    //               depth as y -> -inf
+    const SimTK::Real dy =
+            0.5 * (sqrt(square(depth) + m_depthOffsetSquared) + depth);
+    const SimTK::Real voidStiffness = 1.0; // N/m
+    force[1] = a * square(dy) * (1 + b * depthRate) + voidStiffness * depth;
+
+    // Friction (TODO handle 3D).
+    const SimTK::Real velSlidingScaling =
+            get_tangent_velocity_scaling_factor();
+    const SimTK::Real transition = tanh(velSliding / velSlidingScaling);
+
+    const SimTK::Real frictionForce =
+            -transition * get_friction_coefficient() * force[1];
+    force[0] = frictionForce;
+    return force;
+}
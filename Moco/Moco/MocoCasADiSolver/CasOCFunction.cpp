@@ -20,6 +20,8 @@
 
 #include "CasOCProblem.h"
 
+#include <algorithm>
+
 using namespace CasOC;
 
 casadi::Sparsity calcJacobianSparsityWithPerturbation(const VectorDM& x0s,
@@ -104,6 +106,72 @@ casadi::Sparsity Function::get_jacobian_sparsity() const {
             x0s, (int)this->nnz_out(), function);
 }
 
+VectorDM Function::eval(const VectorDM& args) const {
+    VectorDM out((int)n_out());
+    for (casadi_int i = 0; i < n_out(); ++i) {
+        out[i] = casadi::DM(sparsity_out(i));
+    }
+    evalInto(args, out);
+    return out;
+}
+
+std::unique_ptr<Function::EvalBuffers> Function::takeEvalBuffers() const {
+    {
+        std::lock_guard<std::mutex> lock(m_evalBuffersMutex);
+        if (!m_evalBuffers.empty()) {
+            std::unique_ptr<EvalBuffers> buffers =
+                    std::move(m_evalBuffers.back());
+            m_evalBuffers.pop_back();
+            return buffers;
+        }
+    }
+    std::unique_ptr<EvalBuffers> buffers(new EvalBuffers());
+    buffers->args.resize(n_in());
+    for (casadi_int i = 0; i < n_in(); ++i) {
+        buffers->args[i] = casadi::DM(sparsity_in(i));
+    }
+    buffers->out.resize(n_out());
+    for (casadi_int i = 0; i < n_out(); ++i) {
+        buffers->out[i] = casadi::DM(sparsity_out(i));
+    }
+    return buffers;
+}
+
+void Function::leaveEvalBuffers(std::unique_ptr<EvalBuffers> buffers) const {
+    std::lock_guard<std::mutex> lock(m_evalBuffersMutex);
+    m_evalBuffers.push_back(std::move(buffers));
+}
+
+int Function::eval_buffer(const double** arg,
+        const std::vector<casadi_int>& sizes_arg, double** res,
+        const std::vector<casadi_int>& sizes_res) const {
+    // If evalInto() throws, the buffers are destroyed rather than returned to
+    // the pool.
+    std::unique_ptr<EvalBuffers> buffers = takeEvalBuffers();
+
+    // A null pointer indicates an input of zeros or an output that is not
+    // needed.
+    for (int i = 0; i < (int)sizes_arg.size(); ++i) {
+        double* data = buffers->args[i].ptr();
+        if (arg[i]) {
+            std::copy_n(arg[i], sizes_arg[i], data);
+        } else {
+            std::fill_n(data, sizes_arg[i], 0.0);
+        }
+    }
+    for (int i = 0; i < (int)sizes_res.size(); ++i) {
+        std::fill_n(buffers->out[i].ptr(), sizes_res[i], 0.0);
+    }
+
+    evalInto(buffers->args, buffers->out);
+
+    for (int i = 0; i < (int)sizes_res.size(); ++i) {
+        if (res[i]) std::copy_n(buffers->out[i].ptr(), sizes_res[i], res[i]);
+    }
+    leaveEvalBuffers(std::move(buffers));
+    return 0;
+}
+
 void Function::constructFunction(const Problem* casProblem,
         const std::string& name, const std::string& finiteDiffScheme,
         std::shared_ptr<const std::vector<VariablesDM>>
@@ -134,29 +202,24 @@ casadi::Sparsity Function::get_sparsity_in(casadi_int i) {
     }
 }
 
-VectorDM PathConstraint::eval(const VectorDM& args) const {
+void PathConstraint::evalInto(const VectorDM& args, VectorDM& out) const {
     Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
             args.at(3), args.at(4), args.at(5)};
-    VectorDM out{casadi::DM(sparsity_out(0))};
     m_casProblem->calcPathConstraint(m_index, input, out[0]);
-    return out;
 }
 
-VectorDM CostIntegrand::eval(const VectorDM& args) const {
+void CostIntegrand::evalInto(const VectorDM& args, VectorDM& out) const {
     Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
             args.at(3), args.at(4), args.at(5)};
-    VectorDM out{casadi::DM(casadi::Sparsity::scalar())};
     m_casProblem->calcCostIntegrand(m_index, input, *out[0].ptr());
-    return out;
 }
 
-VectorDM EndpointConstraintIntegrand::eval(const VectorDM& args) const {
+void EndpointConstraintIntegrand::evalInto(
+        const VectorDM& args, VectorDM& out) const {
     Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
                                    args.at(3), args.at(4), args.at(5)};
-    VectorDM out{casadi::DM(casadi::Sparsity::scalar())};
     m_casProblem->calcEndpointConstraintIntegrand(
             m_index, input, *out[0].ptr());
-    return out;
 }
 
 casadi::Sparsity Endpoint::get_sparsity_in(casadi_int i) {
@@ -188,21 +251,17 @@ casadi::Sparsity Endpoint::get_sparsity_in(casadi_int i) {
         return casadi::Sparsity(0, 0);
     }
 }
-VectorDM Cost::eval(const VectorDM& args) const {
+void Cost::evalInto(const VectorDM& args, VectorDM& out) const {
     Problem::CostInput input{args.at(0).scalar(), args.at(1), args.at(2),
             args.at(3), args.at(4), args.at(5).scalar(), args.at(6), args.at(7),
             args.at(8), args.at(9), args.at(10), args.at(11).scalar()};
-    VectorDM out{casadi::DM(sparsity_out(0))};
     m_casProblem->calcCost(m_index, input, out.at(0));
-    return out;
 }
-VectorDM EndpointConstraint::eval(const VectorDM& args) const {
+void EndpointConstraint::evalInto(const VectorDM& args, VectorDM& out) const {
     Problem::CostInput input{args.at(0).scalar(), args.at(1), args.at(2),
             args.at(3), args.at(4), args.at(5).scalar(), args.at(6), args.at(7),
             args.at(8), args.at(9), args.at(10), args.at(11).scalar()};
-    VectorDM out{casadi::DM(sparsity_out(0))};
     m_casProblem->calcEndpointConstraint(m_index, input, out.at(0));
-    return out;
 }
 
 template <bool CalcKCErrors>
@@ -230,18 +289,13 @@ casadi::Sparsity MultibodySystemExplicit<CalcKCErrors>::get_sparsity_out(
 }
 
 template <bool CalcKCErrors>
-VectorDM MultibodySystemExplicit<CalcKCErrors>::eval(
-        const VectorDM& args) const {
+void MultibodySystemExplicit<CalcKCErrors>::evalInto(
+        const VectorDM& args, VectorDM& out) const {
     Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
             args.at(3), args.at(4), args.at(5)};
-    VectorDM out((int)n_out());
-    for (casadi_int i = 0; i < n_out(); ++i) {
-        out[i] = casadi::DM(sparsity_out(i));
-    }
     Problem::MultibodySystemExplicitOutput output{out[0], out[1], out[2],
             out[3]};
     m_casProblem->calcMultibodySystemExplicit(input, CalcKCErrors, output);
-    return out;
 }
 
 template class CasOC::MultibodySystemExplicit<false>;
@@ -283,11 +337,9 @@ casadi::DM VelocityCorrection::getSubsetPoint(
             fullPoint.at(slacks)(Slice(), itime), fullPoint.at(parameters)});
 }
 
-VectorDM VelocityCorrection::eval(const VectorDM& args) const {
-    VectorDM out{casadi::DM(sparsity_out(0))};
+void VelocityCorrection::evalInto(const VectorDM& args, VectorDM& out) const {
     m_casProblem->calcVelocityCorrection(
             args.at(0).scalar(), args.at(1), args.at(2), args.at(3), out[0]);
-    return out;
 }
 
 template <bool CalcKCErrors>
@@ -315,19 +367,13 @@ casadi::Sparsity MultibodySystemImplicit<CalcKCErrors>::get_sparsity_out(
 }
 
 template <bool CalcKCErrors>
-VectorDM MultibodySystemImplicit<CalcKCErrors>::eval(
-        const VectorDM& args) const {
+void MultibodySystemImplicit<CalcKCErrors>::evalInto(
+        const VectorDM& args, VectorDM& out) const {
     Problem::ContinuousInput input{args.at(0).scalar(), args.at(1), args.at(2),
             args.at(3), args.at(4), args.at(5)};
-    VectorDM out((int)n_out());
-    for (casadi_int i = 0; i < n_out(); ++i) {
-        out[i] = casadi::DM(sparsity_out(i));
-    }
-
-    Problem::MultibodySystemImplicitOutput output{out[0], out[1], out[2], 
+    Problem::MultibodySystemImplicitOutput output{out[0], out[1], out[2],
             out[3]};
     m_casProblem->calcMultibodySystemImplicit(input, CalcKCErrors, output);
-    return out;
 }
 
 template class CasOC::MultibodySystemImplicit<false>;
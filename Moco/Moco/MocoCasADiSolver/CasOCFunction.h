@@ -20,6 +20,8 @@
 
 #include "CasOCIterate.h"
 
+#include <mutex>
+
 #include <OpenSim/Common/Exception.h>
 
 namespace CasOC {
@@ -63,10 +65,40 @@ public:
     }
     casadi::Sparsity get_jacobian_sparsity() const override;
 
+    /// This allocates the outputs and invokes evalInto(). CasADi does not use
+    /// this during optimization; see eval_buffer().
+    VectorDM eval(const VectorDM& args) const override;
+    /// CasADi evaluates the function through this raw-pointer interface
+    /// (once per mesh point per NLP function evaluation, and many more times
+    /// for finite differences), possibly from multiple threads. We copy the
+    /// inputs into buffers owned by this function: each concurrent
+    /// evaluation takes a set of buffers from a pool, which grows to the
+    /// number of threads that evaluate the function at once, and returns
+    /// them afterwards. Therefore, after the first evaluations, evaluating
+    /// the function does not allocate memory.
+    bool has_eval_buffer() const override { return true; }
+    int eval_buffer(const double** arg,
+            const std::vector<casadi_int>& sizes_arg, double** res,
+            const std::vector<casadi_int>& sizes_res) const override;
+
 protected:
+    /// Compute the outputs of the function. The elements of `out` have the
+    /// sparsity of the function's outputs and are zero.
+    virtual void evalInto(const VectorDM& args, VectorDM& out) const = 0;
+
     const Problem* m_casProblem;
 
 private:
+    /// Inputs and outputs (with the sparsity of this function's inputs and
+    /// outputs) for one evaluation through eval_buffer().
+    struct EvalBuffers {
+        VectorDM args;
+        VectorDM out;
+    };
+    /// Take buffers from the pool, creating them if the pool is empty.
+    std::unique_ptr<EvalBuffers> takeEvalBuffers() const;
+    void leaveEvalBuffers(std::unique_ptr<EvalBuffers> buffers) const;
+
     /// Here, "point" refers to a vector of all variables in the optimization
     /// problem.
     VectorDM getSubsetPointsForSparsityDetection() const {
@@ -91,6 +123,9 @@ private:
 
     std::shared_ptr<const std::vector<VariablesDM>>
             m_fullPointsForSparsityDetection;
+
+    mutable std::mutex m_evalBuffersMutex;
+    mutable std::vector<std::unique_ptr<EvalBuffers>> m_evalBuffers;
 };
 
 class PathConstraint : public Function {
@@ -117,7 +152,7 @@ public:
         } else
             return casadi::Sparsity(0, 0);
     }
-    VectorDM eval(const VectorDM& args) const override;
+    void evalInto(const VectorDM& args, VectorDM& out) const override;
 
 protected:
     int m_index = -1;
@@ -154,12 +189,12 @@ protected:
 
 class CostIntegrand : public Integrand {
 public:
-    VectorDM eval(const VectorDM& args) const override;
+    void evalInto(const VectorDM& args, VectorDM& out) const override;
 };
 
 class EndpointConstraintIntegrand : public Integrand {
 public:
-    VectorDM eval(const VectorDM& args) const override;
+    void evalInto(const VectorDM& args, VectorDM& out) const override;
 };
 
 /// This function takes initial states/controls, final states/controls, and an
@@ -241,13 +276,13 @@ protected:
 /// This invokes CasOC::Problem::calcCost().
 class Cost : public Endpoint {
 public:
-    VectorDM eval(const VectorDM& args) const override;
+    void evalInto(const VectorDM& args, VectorDM& out) const override;
 };
 
 /// This invokes CasOC::Problem::calcEndpointConstraint().
 class EndpointConstraint : public Endpoint {
 public:
-    VectorDM eval(const VectorDM& args) const override;
+    void evalInto(const VectorDM& args, VectorDM& out) const override;
 
 };
 
@@ -267,7 +302,7 @@ public:
         }
     }
     casadi::Sparsity get_sparsity_out(casadi_int i) override final;
-    VectorDM eval(const VectorDM& args) const override;
+    void evalInto(const VectorDM& args, VectorDM& out) const override;
 };
 
 /// This function should compute a velocity correction term to make feasible
@@ -293,7 +328,7 @@ public:
     }
     casadi::Sparsity get_sparsity_in(casadi_int i) override final;
     casadi::Sparsity get_sparsity_out(casadi_int i) override final;
-    VectorDM eval(const VectorDM& args) const override;
+    void evalInto(const VectorDM& args, VectorDM& out) const override;
     casadi::DM getSubsetPoint(const VariablesDM& fullPoint) const override;
 };
 
@@ -310,7 +345,7 @@ class MultibodySystemImplicit : public Function {
         }
     }
     casadi::Sparsity get_sparsity_out(casadi_int i) override final;
-    VectorDM eval(const VectorDM& args) const override;
+    void evalInto(const VectorDM& args, VectorDM& out) const override;
 };
 
 } // namespace CasOC
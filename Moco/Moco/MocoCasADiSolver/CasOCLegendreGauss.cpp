@@ -0,0 +1,181 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: CasOCLegendreGauss.cpp                                       *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include "CasOCLegendreGauss.h"
+
+using casadi::DM;
+using casadi::MX;
+using casadi::Slice;
+
+namespace CasOC {
+
+namespace {
+
+/// The Legendre-Gauss-Lobatto points on [0, 1]: 0, 1, and the roots of the
+/// derivative of the Legendre polynomial of the given degree. We use Newton's
+/// method, starting from the Chebyshev-Gauss-Lobatto points.
+std::vector<double> createLegendreGaussLobattoPoints(int degree) {
+    const int N = degree;
+    std::vector<double> x(N + 1);
+    for (int i = 0; i <= N; ++i) x[i] = -std::cos(SimTK::Pi * i / N);
+    for (int iter = 0; iter < 100; ++iter) {
+        double maxChange = 0;
+        for (int i = 0; i <= N; ++i) {
+            // Legendre polynomials P_{N-1}(x) and P_N(x).
+            double Pkm1 = 1;
+            double Pk = x[i];
+            for (int k = 1; k < N; ++k) {
+                const double Pkp1 =
+                        ((2 * k + 1) * x[i] * Pk - k * Pkm1) / (k + 1);
+                Pkm1 = Pk;
+                Pk = Pkp1;
+            }
+            const double change = (x[i] * Pk - Pkm1) / ((N + 1) * Pk);
+            x[i] -= change;
+            maxChange = std::max(maxChange, std::abs(change));
+        }
+        if (maxChange < 1e-15) break;
+    }
+    std::vector<double> points(N + 1);
+    for (int i = 0; i <= N; ++i) points[i] = 0.5 * (x[i] + 1);
+    points.front() = 0;
+    points.back() = 1;
+    return points;
+}
+
+/// The integral, from 0 to `upper`, of the Lagrange polynomial that is 1 at
+/// nodes[k] and 0 at the other nodes.
+double integrateLagrangePolynomial(
+        const std::vector<double>& nodes, int k, double upper) {
+    // Coefficients of the polynomial, in increasing order of power.
+    std::vector<double> coeffs{1.0};
+    double denominator = 1;
+    for (int r = 0; r < (int)nodes.size(); ++r) {
+        if (r == k) continue;
+        // Multiply by (t - nodes[r]).
+        std::vector<double> product(coeffs.size() + 1, 0.0);
+        for (int n = 0; n < (int)coeffs.size(); ++n) {
+            product[n + 1] += coeffs[n];
+            product[n] -= nodes[r] * coeffs[n];
+        }
+        coeffs = product;
+        denominator *= nodes[k] - nodes[r];
+    }
+    double integral = 0;
+    double power = upper;
+    for (int n = 0; n < (int)coeffs.size(); ++n) {
+        integral += coeffs[n] * power / (n + 1);
+        power *= upper;
+    }
+    return integral / denominator;
+}
+
+} // anonymous namespace
+
+LegendreGauss::LegendreGauss(const Solver& solver, const Problem& problem,
+        Points points, int degree)
+        : Transcription(solver, problem), m_degree(degree) {
+    OPENSIM_THROW_IF(degree < 1 || degree > 9, OpenSim::Exception,
+            "Expected the degree of the Legendre-Gauss transcription to be "
+            "between 1 and 9, but got {}.",
+            degree);
+    OPENSIM_THROW_IF(problem.getEnforceConstraintDerivatives(),
+            OpenSim::Exception,
+            "Enforcing kinematic constraint derivatives "
+            "not supported with Legendre-Gauss transcription.");
+
+    // The collocation points, at which the state derivatives are
+    // interpolated; k is the index of the collocation point within
+    // m_intervalPoints.
+    std::vector<double> collocationPoints;
+    int firstCollocationIndex;
+    if (points == Points::Radau) {
+        collocationPoints = casadi::collocation_points(degree, "radau");
+        m_intervalPoints = collocationPoints;
+        m_intervalPoints.insert(m_intervalPoints.begin(), 0.0);
+        firstCollocationIndex = 1;
+    } else {
+        collocationPoints = createLegendreGaussLobattoPoints(degree);
+        m_intervalPoints = collocationPoints;
+        firstCollocationIndex = 0;
+    }
+    m_integrationMatrix = DM::zeros(degree, degree + 1);
+    for (int j = 1; j <= degree; ++j) {
+        for (int ic = 0; ic < (int)collocationPoints.size(); ++ic) {
+            m_integrationMatrix(j - 1, firstCollocationIndex + ic) =
+                    integrateLagrangePolynomial(
+                            collocationPoints, ic, m_intervalPoints[j]);
+        }
+    }
+
+    const auto& mesh = m_solver.getMesh();
+    const int numMeshIntervals = (int)mesh.size() - 1;
+    DM grid = DM::zeros(1, numMeshIntervals * degree + 1);
+    for (int imesh = 0; imesh < numMeshIntervals; ++imesh) {
+        const double h = mesh[imesh + 1] - mesh[imesh];
+        for (int k = 0; k < degree; ++k) {
+            grid(imesh * degree + k) = mesh[imesh] + h * m_intervalPoints[k];
+        }
+    }
+    grid(numMeshIntervals * degree) = mesh.back();
+
+    createVariablesAndSetBounds(grid, degree * m_problem.getNumStates());
+}
+
+DM LegendreGauss::createQuadratureCoefficientsImpl() const {
+    const auto& mesh = m_solver.getMesh();
+    DM quadCoeffs(m_numGridPoints, 1);
+    // The quadrature weights are the integrals over the whole mesh interval
+    // (last row of the integration matrix). The weights overlap at the mesh
+    // points.
+    for (int imesh = 0; imesh < m_numMeshIntervals; ++imesh) {
+        const double h = mesh[imesh + 1] - mesh[imesh];
+        for (int k = 0; k <= m_degree; ++k) {
+            quadCoeffs(imesh * m_degree + k) +=
+                    h * m_integrationMatrix(m_degree - 1, k);
+        }
+    }
+    return quadCoeffs;
+}
+
+DM LegendreGauss::createMeshIndicesImpl() const {
+    DM indices = DM::zeros(1, m_numGridPoints);
+    for (int i = 0; i < m_numGridPoints; i += m_degree) { indices(i) = 1; }
+    return indices;
+}
+
+void LegendreGauss::calcDefectsImpl(const casadi::MX& x,
+        const casadi::MX& xdot, casadi::MX& defects) const {
+    // For more information, see doxygen documentation for the class.
+    const MX integrationMatrixTranspose = m_integrationMatrix.T();
+    for (int imesh = 0; imesh < m_numMeshIntervals; ++imesh) {
+        const int igrid = imesh * m_degree;
+        const auto h = m_times(igrid + m_degree) - m_times(igrid);
+        const auto x_0 = x(Slice(), igrid);
+        // States at the grid points after the start point (one per column).
+        const auto x_j = x(Slice(), Slice(igrid + 1, igrid + m_degree + 1));
+        const auto xdot_k = xdot(Slice(), Slice(igrid, igrid + m_degree + 1));
+        // Stacking the columns places all state variables for the first grid
+        // point first.
+        const auto integrals =
+                MX::mtimes(xdot_k, integrationMatrixTranspose);
+        defects(Slice(), imesh) =
+                MX::vec(x_j - MX::repmat(x_0, 1, m_degree) - h * integrals);
+    }
+}
+
+} // namespace CasOC
@@ -0,0 +1,79 @@
+#ifndef MOCO_CASOCLEGENDREGAUSS_H
+#define MOCO_CASOCLEGENDREGAUSS_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: CasOCLegendreGauss.h                                         *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "CasOCTranscription.h"
+
+namespace CasOC {
+
+/// Enforce the differential equations in the problem using orthogonal
+/// collocation (a pseudospectral method) with a polynomial of a given degree
+/// within each mesh interval. The collocation points are either the
+/// Legendre-Gauss-Radau points (including the end of each mesh interval) or
+/// the Legendre-Gauss-Lobatto points (including both ends of each mesh
+/// interval). The integral in the objective function is approximated by the
+/// Gauss quadrature rule for the collocation points.
+///
+/// Each mesh interval contains `degree` new grid points: the mesh interval
+/// start point is shared with the previous mesh interval. The Radau scheme is
+/// accurate to order 2 * degree - 1 and the Lobatto scheme to order
+/// 2 * degree, so a solution of a given accuracy requires fewer mesh
+/// intervals than with trapezoidal or Hermite-Simpson transcription. With
+/// degree 1, the Radau scheme is backward Euler and the Lobatto scheme is
+/// trapezoidal; with degree 2, the Lobatto scheme is equivalent to
+/// Hermite-Simpson.
+///
+/// Defect constraints.
+/// -------------------
+/// The defects are in integral form: for each grid point j in a mesh interval
+/// (other than the start point), and for each state variable,
+///     x_j - x_0 - h * sum_k A(j, k) * xdot_k = 0,
+/// where A(j, k) is the integral, from the start of the mesh interval to grid
+/// point j, of the Lagrange polynomial for collocation point k.
+///
+/// Kinematic constraints and path constraints.
+/// -------------------------------------------
+/// Kinematic constraint and path constraint errors are enforced only at the
+/// mesh points. Enforcing the derivatives of kinematic constraints is not
+/// supported.
+class LegendreGauss : public Transcription {
+public:
+    enum class Points { Radau, Lobatto };
+    LegendreGauss(const Solver& solver, const Problem& problem, Points points,
+            int degree);
+
+private:
+    casadi::DM createQuadratureCoefficientsImpl() const override;
+    casadi::DM createMeshIndicesImpl() const override;
+    void calcDefectsImpl(const casadi::MX& x, const casadi::MX& xdot,
+            casadi::MX& defects) const override;
+
+    int m_degree;
+    /// The points (degree + 1) in [0, 1] of each mesh interval; the first is
+    /// 0 and the last is 1.
+    std::vector<double> m_intervalPoints;
+    /// Row j - 1 contains the integration weights A(j, k) for grid point j
+    /// (degree x (degree + 1)). For Radau, the mesh interval start point is
+    /// not a collocation point, so the first column is zero.
+    casadi::DM m_integrationMatrix;
+};
+
+} // namespace CasOC
+
+#endif // MOCO_CASOCLEGENDREGAUSS_H
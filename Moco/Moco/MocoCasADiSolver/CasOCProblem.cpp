@@ -47,4 +47,103 @@ Problem::createKinematicConstraintEquationNamesImpl() const {
     return names;
 }
 
+template <typename T>
+static bool namesEqual(const std::vector<T>& a, const std::vector<T>& b) {
+    if (a.size() != b.size()) return false;
+    for (int i = 0; i < (int)a.size(); ++i) {
+        if (a[i].name != b[i].name) return false;
+    }
+    return true;
+}
+
+bool Problem::isStructurallyEqual(const Problem& other) const {
+    if (m_dynamicsMode != other.m_dynamicsMode) return false;
+    if (m_prescribedKinematics != other.m_prescribedKinematics) return false;
+    if (m_enforceConstraintDerivatives != other.m_enforceConstraintDerivatives)
+        return false;
+    if (m_auxiliaryDerivativeNames != other.m_auxiliaryDerivativeNames)
+        return false;
+    if (getNumKinematicConstraintEquations() !=
+            other.getNumKinematicConstraintEquations())
+        return false;
+    if (getNumMultibodyDynamicsEquations() !=
+            other.getNumMultibodyDynamicsEquations())
+        return false;
+    if (!namesEqual(m_stateInfos, other.m_stateInfos)) return false;
+    for (int is = 0; is < (int)m_stateInfos.size(); ++is) {
+        if (m_stateInfos[is].type != other.m_stateInfos[is].type) return false;
+    }
+    if (!namesEqual(m_controlInfos, other.m_controlInfos)) return false;
+    if (!namesEqual(m_multiplierInfos, other.m_multiplierInfos)) return false;
+    if (!namesEqual(m_slackInfos, other.m_slackInfos)) return false;
+    if (!namesEqual(m_paramInfos, other.m_paramInfos)) return false;
+    if (!namesEqual(m_costInfos, other.m_costInfos)) return false;
+    for (int ic = 0; ic < (int)m_costInfos.size(); ++ic) {
+        const auto& info = m_costInfos[ic];
+        const auto& otherInfo = other.m_costInfos[ic];
+        if (info.num_outputs != otherInfo.num_outputs) return false;
+        if (bool(info.integrand_function) !=
+                bool(otherInfo.integrand_function))
+            return false;
+    }
+    if (!namesEqual(m_endpointConstraintInfos,
+                other.m_endpointConstraintInfos))
+        return false;
+    for (int iec = 0; iec < (int)m_endpointConstraintInfos.size(); ++iec) {
+        const auto& info = m_endpointConstraintInfos[iec];
+        const auto& otherInfo = other.m_endpointConstraintInfos[iec];
+        if (info.num_outputs != otherInfo.num_outputs) return false;
+        if (bool(info.integrand_function) !=
+                bool(otherInfo.integrand_function))
+            return false;
+    }
+    if (!namesEqual(m_pathInfos, other.m_pathInfos)) return false;
+    for (int ipc = 0; ipc < (int)m_pathInfos.size(); ++ipc) {
+        if (m_pathInfos[ipc].size() != other.m_pathInfos[ipc].size())
+            return false;
+    }
+    return true;
+}
+
+void Problem::copyBoundsFrom(const Problem& other) {
+    OPENSIM_THROW_IF(!isStructurallyEqual(other), Exception,
+            "Cannot copy bounds from a problem with a different structure.");
+    m_timeInitialBounds = other.m_timeInitialBounds;
+    m_timeFinalBounds = other.m_timeFinalBounds;
+    m_kinematicConstraintBounds = other.m_kinematicConstraintBounds;
+    for (int is = 0; is < (int)m_stateInfos.size(); ++is) {
+        const auto& otherInfo = other.m_stateInfos[is];
+        m_stateInfos[is].bounds = otherInfo.bounds;
+        m_stateInfos[is].initialBounds = otherInfo.initialBounds;
+        m_stateInfos[is].finalBounds = otherInfo.finalBounds;
+    }
+    for (int ic = 0; ic < (int)m_controlInfos.size(); ++ic) {
+        const auto& otherInfo = other.m_controlInfos[ic];
+        m_controlInfos[ic].bounds = otherInfo.bounds;
+        m_controlInfos[ic].initialBounds = otherInfo.initialBounds;
+        m_controlInfos[ic].finalBounds = otherInfo.finalBounds;
+    }
+    for (int im = 0; im < (int)m_multiplierInfos.size(); ++im) {
+        const auto& otherInfo = other.m_multiplierInfos[im];
+        m_multiplierInfos[im].bounds = otherInfo.bounds;
+        m_multiplierInfos[im].initialBounds = otherInfo.initialBounds;
+        m_multiplierInfos[im].finalBounds = otherInfo.finalBounds;
+    }
+    for (int isl = 0; isl < (int)m_slackInfos.size(); ++isl) {
+        m_slackInfos[isl].bounds = other.m_slackInfos[isl].bounds;
+    }
+    for (int ip = 0; ip < (int)m_paramInfos.size(); ++ip) {
+        m_paramInfos[ip].bounds = other.m_paramInfos[ip].bounds;
+    }
+    for (int iec = 0; iec < (int)m_endpointConstraintInfos.size(); ++iec) {
+        const auto& otherInfo = other.m_endpointConstraintInfos[iec];
+        m_endpointConstraintInfos[iec].lowerBounds = otherInfo.lowerBounds;
+        m_endpointConstraintInfos[iec].upperBounds = otherInfo.upperBounds;
+    }
+    for (int ipc = 0; ipc < (int)m_pathInfos.size(); ++ipc) {
+        m_pathInfos[ipc].lowerBounds = other.m_pathInfos[ipc].lowerBounds;
+        m_pathInfos[ipc].upperBounds = other.m_pathInfos[ipc].upperBounds;
+    }
+}
+
 } // namespace CasOC
@@ -191,6 +191,10 @@ protected:
         else if (type == StateType::Auxiliary)
             ++m_numAuxiliaryStates;
     }
+    /// Change the initial bounds of a state that was added with addState().
+    void setStateInitialBounds(int index, Bounds bounds) {
+        m_stateInfos[index].initialBounds = std::move(bounds);
+    }
     /// Add an algebraic variable/"state" to the problem.
     void addControl(std::string name, Bounds bounds, Bounds initialBounds,
             Bounds finalBounds) {
@@ -301,6 +305,18 @@ protected:
         m_auxiliaryDerivativeNames = names;
         m_numAuxiliaryResiduals = (int)names.size();
     }
+    /// Copy the bounds on time, variables, and constraints from another
+    /// problem. The problems must be structurally equal (see
+    /// isStructurallyEqual()).
+    void copyBoundsFrom(const Problem& other);
+
+public:
+    /// Do this problem and the other problem have the same variables, costs,
+    /// and constraints (names and sizes), and the same dynamics mode? If so, a
+    /// nonlinear program transcribed from this problem has the same structure
+    /// as one transcribed from the other problem; only the bounds and the
+    /// numerical values computed by the calc*() functions may differ.
+    bool isStructurallyEqual(const Problem& other) const;
 
 public:
     /// Kinematic constraint errors should be ordered as so:
@@ -341,7 +357,9 @@ public:
     /// This is invoked once for each iterate in the optimization process.
     virtual void intermediateCallbackImpl() const {}
     /// Process an intermediate iterate. The frequency with which this is
-    /// evaluated is governed by Solver::getOutputInterval().
+    /// evaluated is governed by Solver::getCallbackInterval(). This is
+    /// invoked on a separate thread, concurrently with the optimization, and
+    /// may skip iterates if it is slower than the optimizer.
     virtual void intermediateCallbackWithIterateImpl(
             const CasOC::Iterate&) const {}
     /// @}
@@ -17,6 +17,7 @@
 
 #include "../MocoUtilities.h"
 #include "CasOCHermiteSimpson.h"
+#include "CasOCLegendreGauss.h"
 #include "CasOCProblem.h"
 #include "CasOCTranscription.h"
 #include "CasOCTrapezoidal.h"
@@ -25,12 +26,31 @@ using OpenSim::Exception;
 
 namespace CasOC {
 
+std::mutex& getTranscriptionMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+Solver::Solver(const Problem& problem) : m_problem(problem) {}
+
+Solver::~Solver() = default;
+
 std::unique_ptr<Transcription> Solver::createTranscription() const {
     std::unique_ptr<Transcription> transcription;
     if (m_transcriptionScheme == "trapezoidal") {
         transcription = OpenSim::make_unique<Trapezoidal>(*this, m_problem);
     } else if (m_transcriptionScheme == "hermite-simpson") {
         transcription = OpenSim::make_unique<HermiteSimpson>(*this, m_problem);
+    } else if (OpenSim::startsWith(
+                       m_transcriptionScheme, "legendre-gauss-radau-")) {
+        const int degree = std::stoi(m_transcriptionScheme.substr(21));
+        transcription = OpenSim::make_unique<LegendreGauss>(*this, m_problem,
+                LegendreGauss::Points::Radau, degree);
+    } else if (OpenSim::startsWith(
+                       m_transcriptionScheme, "legendre-gauss-lobatto-")) {
+        const int degree = std::stoi(m_transcriptionScheme.substr(23));
+        transcription = OpenSim::make_unique<LegendreGauss>(*this, m_problem,
+                LegendreGauss::Points::Lobatto, degree);
     } else {
         OPENSIM_THROW(Exception, "Unknown transcription scheme '{}'.",
                 m_transcriptionScheme);
@@ -39,11 +59,13 @@ std::unique_ptr<Transcription> Solver::createTranscription() const {
 }
 
 Iterate Solver::createInitialGuessFromBounds() const {
+    std::lock_guard<std::mutex> lock(getTranscriptionMutex());
     auto transcription = createTranscription();
     return transcription->createInitialGuessFromBounds();
 }
 
 Iterate Solver::createRandomIterateWithinBounds() const {
+    std::lock_guard<std::mutex> lock(getTranscriptionMutex());
     auto transcription = createTranscription();
     return transcription->createRandomIterateWithinBounds();
 }
@@ -68,27 +90,43 @@ void Solver::setParallelism(std::string parallelism, int numThreads) {
 }
 
 Solution Solver::solve(const Iterate& guess) const {
-    auto transcription = createTranscription();
-    auto pointsForSparsityDetection =
-            std::make_shared<std::vector<VariablesDM>>();
-    if (m_sparsity_detection == "initial-guess") {
-        // TODO: This guess has not been interpolated.
-        pointsForSparsityDetection->push_back(guess.variables);
-    } else if (m_sparsity_detection == "random") {
-        // Make sure the exact same sparsity pattern is used every time.
-        auto randGen = OpenSim::make_unique<SimTK::Random::Uniform>(-1, 1);
-        randGen->setSeed(0);
-        for (int i = 0; i < m_sparsity_detection_random_count; ++i) {
-            pointsForSparsityDetection->push_back(
-                    transcription->createRandomIterateWithinBounds(
-                                         randGen.get())
-                            .variables);
+    if (m_reuseNLP && m_transcription) {
+        // The problem's bounds may have changed since the last solve.
+        m_transcription->updateBounds();
+        return m_transcription->solve(guess);
+    }
+    std::unique_ptr<Transcription> transcription;
+    {
+        std::lock_guard<std::mutex> lock(getTranscriptionMutex());
+        transcription = createTranscription();
+        auto pointsForSparsityDetection =
+                std::make_shared<std::vector<VariablesDM>>();
+        if (m_sparsity_detection == "initial-guess") {
+            // TODO: This guess has not been interpolated.
+            pointsForSparsityDetection->push_back(guess.variables);
+        } else if (m_sparsity_detection == "random") {
+            // Make sure the exact same sparsity pattern is used every time.
+            auto randGen = OpenSim::make_unique<SimTK::Random::Uniform>(-1, 1);
+            randGen->setSeed(0);
+            for (int i = 0; i < m_sparsity_detection_random_count; ++i) {
+                pointsForSparsityDetection->push_back(
+                        transcription->createRandomIterateWithinBounds(
+                                             randGen.get())
+                                .variables);
+            }
         }
+        m_problem.initialize(m_finite_difference_scheme,
+                std::const_pointer_cast<const std::vector<VariablesDM>>(
+                        pointsForSparsityDetection));
+    }
+    if (m_reuseNLP) {
+        m_transcription = std::move(transcription);
+        return m_transcription->solve(guess);
     }
-    m_problem.initialize(m_finite_difference_scheme,
-            std::const_pointer_cast<const std::vector<VariablesDM>>(
-                    pointsForSparsityDetection));
-    return transcription->solve(guess);
+    Solution solution = transcription->solve(guess);
+    std::lock_guard<std::mutex> lock(getTranscriptionMutex());
+    transcription.reset();
+    return solution;
 }
 
 } // namespace CasOC
@@ -19,6 +19,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "CasOCProblem.h"
+#include <mutex>
 
 namespace OpenSim {
 class MocoCasADiSolver;
@@ -28,13 +29,19 @@ namespace CasOC {
 
 class Transcription;
 
+/// Constructing CasADi symbolic expressions is not threadsafe. Hold a lock on
+/// this mutex while transcribing a problem so that separate problems can be
+/// solved concurrently (e.g., the time windows of MocoCasADiSolver).
+std::mutex& getTranscriptionMutex();
+
 /// Once you have built your CasOC::Problem, create a CasOC::Solver to configure
 /// how you want to solve the problem, then invoke solve() to solve your
 /// problem. This class assumes that the problem is solved using direct
 /// collocation.
 class Solver {
 public:
-    Solver(const Problem& problem) : m_problem(problem) {}
+    Solver(const Problem& problem);
+    ~Solver();
     void setNumMeshIntervals(int numMeshIntervals) {
         for (int i = 0; i < (numMeshIntervals + 1); ++i) {
             m_mesh.push_back(i / (double)(numMeshIntervals));
@@ -164,6 +171,19 @@ public:
     }
     const casadi::Dict getSolverOptions() const { return m_solverOptions; }
 
+    /// If true, the transcription (and the NLP solver function it creates) is
+    /// kept after the first call to solve() and reused by subsequent calls to
+    /// solve(). Building the symbolic expression graph, detecting sparsity,
+    /// and the NLP solver's symbolic setup are then performed only once;
+    /// subsequent solves update only the initial guess and the bounds
+    /// (which are re-read from the problem). Do not change the settings of
+    /// this solver or the structure of the problem between solves.
+    /// @note Default is false.
+    void setReuseNLP(bool tf) { m_reuseNLP = tf; }
+    bool getReuseNLP() const { return m_reuseNLP; }
+    /// Has solve() created an NLP that the next call to solve() will reuse?
+    bool hasReusableNLP() const { return (bool)m_transcription; }
+
     /// The contents of this iterate depends on the transcription scheme.
     Iterate createInitialGuessFromBounds() const;
     /// The contents of this iterate depends on the transcription scheme.
@@ -196,6 +216,8 @@ private:
     casadi::Dict m_pluginOptions;
     casadi::Dict m_solverOptions;
     std::string m_optimSolver;
+    bool m_reuseNLP = false;
+    mutable std::unique_ptr<Transcription> m_transcription;
 };
 
 } // namespace CasOC
@@ -17,6 +17,10 @@
  * -------------------------------------------------------------------------- */
 #include "CasOCTranscription.h"
 
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
 using casadi::DM;
 using casadi::MX;
 using casadi::MXVector;
@@ -26,6 +30,101 @@ namespace CasOC {
 
 // http://casadi.sourceforge.net/api/html/d7/df0/solvers_2callback_8py-example.html
 
+/// Expands intermediate iterates and passes them to
+/// Problem::intermediateCallbackWithIterate() (which, for Moco, writes them
+/// to files) on a separate thread, so that the optimizer does not wait on
+/// file output. If the optimizer produces iterates faster than they can be
+/// processed, the oldest queued iterates are dropped.
+class IterateWriter {
+public:
+    IterateWriter(const Transcription& transcription, const Problem& problem)
+            : m_transcription(transcription), m_problem(problem) {}
+    ~IterateWriter() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_queue.clear();
+        }
+        m_condition.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+    /// `variables` is the flattened vector of NLP variables.
+    void push(int iteration, DM variables) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_thread.joinable()) {
+                m_thread = std::thread(&IterateWriter::run, this);
+            }
+            if ((int)m_queue.size() == m_maxQueueSize) {
+                m_queue.pop_front();
+                ++m_numDropped;
+            }
+            m_queue.emplace_back(iteration, std::move(variables));
+        }
+        m_condition.notify_all();
+    }
+    /// Wait until all queued iterates have been processed. This rethrows the
+    /// first exception thrown while processing the iterates.
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+        if (m_numDropped) {
+            std::cout << "[CasOC] Warning: " << m_numDropped
+                      << " intermediate iterate(s) were not processed "
+                         "because processing fell behind the optimizer."
+                      << std::endl;
+            m_numDropped = 0;
+        }
+        if (m_exception) {
+            std::exception_ptr exception = m_exception;
+            m_exception = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_condition.wait(
+                    lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_stop) return;
+            std::pair<int, DM> entry = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_busy = true;
+            lock.unlock();
+            std::exception_ptr exception;
+            try {
+                Iterate iterate = m_problem.createIterate<Iterate>();
+                iterate.variables =
+                        m_transcription.expandVariables(entry.second);
+                iterate.times = m_transcription.createTimes(
+                        iterate.variables[initial_time],
+                        iterate.variables[final_time]);
+                iterate.iteration = entry.first;
+                m_problem.intermediateCallbackWithIterate(iterate);
+            } catch (...) { exception = std::current_exception(); }
+            lock.lock();
+            if (exception && !m_exception) m_exception = exception;
+            m_busy = false;
+            m_condition.notify_all();
+        }
+    }
+
+    const Transcription& m_transcription;
+    const Problem& m_problem;
+    // Each entry holds a copy of the NLP variables, so the queue is short.
+    const int m_maxQueueSize = 8;
+    std::deque<std::pair<int, DM>> m_queue;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop = false;
+    bool m_busy = false;
+    int m_numDropped = 0;
+    std::exception_ptr m_exception;
+};
+
 /// This class allows us to observe intermediate iterates throughout the
 /// optimization.
 class NlpsolCallback : public casadi::Callback {
@@ -33,9 +132,9 @@ public:
     NlpsolCallback(const Transcription& transcription, const Problem& problem,
             casadi_int numVariables, casadi_int numConstraints,
             casadi_int outputInterval)
-            : m_transcription(transcription), m_problem(problem),
-              m_numVariables(numVariables), m_numConstraints(numConstraints),
-              m_callbackInterval(outputInterval) {
+            : m_numVariables(numVariables), m_numConstraints(numConstraints),
+              m_callbackInterval(outputInterval),
+              m_writer(transcription, problem), m_problem(problem) {
         construct("NlpsolCallback", {});
     }
     casadi_int get_n_in() override { return casadi::nlpsol_n_out(); }
@@ -58,25 +157,24 @@ public:
     }
     std::vector<DM> eval(const std::vector<DM>& args) const override {
         if (m_callbackInterval > 0 && evalCount % m_callbackInterval == 0) {
-            Iterate iterate = m_problem.createIterate<Iterate>();
-            iterate.variables = m_transcription.expandVariables(args.at(0));
-            iterate.times =
-                    m_transcription.createTimes(iterate.variables[initial_time],
-                            iterate.variables[final_time]);
-            iterate.iteration = evalCount;
-            m_problem.intermediateCallbackWithIterate(iterate);
+            // Only copy the variables here; the writer thread does the rest.
+            m_writer.push(evalCount, args.at(0));
         }
         m_problem.intermediateCallback();
         ++evalCount;
         return {0};
     }
+    /// Wait for intermediate iterates to be processed; see IterateWriter.
+    void waitForIterates() const { m_writer.wait(); }
+    /// Restart the iteration count (e.g., when the NLP is solved again).
+    void resetIterationCount() const { evalCount = 0; }
 
 private:
-    const Transcription& m_transcription;
-    const Problem& m_problem;
     casadi_int m_numVariables;
     casadi_int m_numConstraints;
     casadi_int m_callbackInterval;
+    mutable IterateWriter m_writer;
+    const Problem& m_problem;
     mutable int evalCount = 0;
 };
 
@@ -172,6 +270,10 @@ void Transcription::createVariablesAndSetBounds(const casadi::DM& grid,
 
     // Set variable bounds.
     // --------------------
+    setVariableBoundsFromProblem();
+}
+
+void Transcription::setVariableBoundsFromProblem() {
     auto initializeBounds = [&](VariablesDM& bounds) {
         for (auto& kv : m_vars) {
             bounds[kv.first] = DM(kv.second.rows(), kv.second.columns());
@@ -272,28 +374,16 @@ void Transcription::transcribe() {
     m_xdot = MX(NS, m_numGridPoints);
     m_constraints.defects = MX(casadi::Sparsity::dense(
             m_numDefectsPerMeshInterval, m_numMeshIntervals));
-    m_constraintsLowerBounds.defects =
-            DM::zeros(m_numDefectsPerMeshInterval, m_numMeshIntervals);
-    m_constraintsUpperBounds.defects =
-            DM::zeros(m_numDefectsPerMeshInterval, m_numMeshIntervals);
 
     // Initialize memory for implicit multibody residuals.
     // ---------------------------------------------------
     m_constraints.multibody_residuals = MX(casadi::Sparsity::dense(
             m_numMultibodyResiduals, m_numGridPoints));
-    m_constraintsLowerBounds.multibody_residuals =
-            DM::zeros(m_numMultibodyResiduals, m_numGridPoints);
-    m_constraintsUpperBounds.multibody_residuals =
-            DM::zeros(m_numMultibodyResiduals, m_numGridPoints);
 
     // Initialize memory for implicit auxiliary residuals.
     // ---------------------------------------------------
     m_constraints.auxiliary_residuals = MX(casadi::Sparsity::dense(
             m_numAuxiliaryResiduals, m_numGridPoints));
-    m_constraintsLowerBounds.auxiliary_residuals =
-            DM::zeros(m_numAuxiliaryResiduals, m_numGridPoints);
-    m_constraintsUpperBounds.auxiliary_residuals =
-            DM::zeros(m_numAuxiliaryResiduals, m_numGridPoints);
 
     // Initialize memory for kinematic constraints.
     // --------------------------------------------
@@ -302,12 +392,6 @@ void Transcription::transcribe() {
     m_constraints.kinematic = MX(
             casadi::Sparsity::dense(numKinematicConstraints, m_numMeshPoints));
 
-    const auto& kcBounds = m_problem.getKinematicConstraintBounds();
-    m_constraintsLowerBounds.kinematic = casadi::DM::repmat(
-            kcBounds.lower, numKinematicConstraints, m_numMeshPoints);
-    m_constraintsUpperBounds.kinematic = casadi::DM::repmat(
-            kcBounds.upper, numKinematicConstraints, m_numMeshPoints);
-
     // qdot
     // ----
     const MX u = m_vars[states](Slice(NQ, NQ + NU), Slice());
@@ -418,18 +502,12 @@ void Transcription::transcribe() {
     // maximize CasADi's ability to take derivatives efficiently.
     int numPathConstraints = (int)m_problem.getPathConstraintInfos().size();
     m_constraints.path.resize(numPathConstraints);
-    m_constraintsLowerBounds.path.resize(numPathConstraints);
-    m_constraintsUpperBounds.path.resize(numPathConstraints);
     for (int ipc = 0; ipc < (int)m_constraints.path.size(); ++ipc) {
         const auto& info = m_problem.getPathConstraintInfos()[ipc];
         // TODO: Is it sufficiently general to apply these to mesh points?
         const auto out = evalOnTrajectory(*info.function,
                 {states, controls, multipliers, derivatives}, m_meshIndices);
         m_constraints.path[ipc] = out.at(0);
-        m_constraintsLowerBounds.path[ipc] =
-                casadi::DM::repmat(info.lowerBounds, 1, m_numMeshPoints);
-        m_constraintsUpperBounds.path[ipc] =
-                casadi::DM::repmat(info.upperBounds, 1, m_numMeshPoints);
     }
 
     // Interpolating controls.
@@ -437,12 +515,67 @@ void Transcription::transcribe() {
     m_constraints.interp_controls =
             casadi::DM(casadi::Sparsity::dense(m_problem.getNumControls(),
                     (int)m_pointsForInterpControls.numel()));
+
+    calcInterpolatingControls();
+
+    // Constraint bounds.
+    // ==================
+    setConstraintBoundsFromProblem();
+}
+
+void Transcription::setConstraintBoundsFromProblem() {
+    // Defects, residuals, and interpolating controls.
+    // -----------------------------------------------
+    m_constraintsLowerBounds.defects =
+            DM::zeros(m_numDefectsPerMeshInterval, m_numMeshIntervals);
+    m_constraintsUpperBounds.defects =
+            DM::zeros(m_numDefectsPerMeshInterval, m_numMeshIntervals);
+    m_constraintsLowerBounds.multibody_residuals =
+            DM::zeros(m_numMultibodyResiduals, m_numGridPoints);
+    m_constraintsUpperBounds.multibody_residuals =
+            DM::zeros(m_numMultibodyResiduals, m_numGridPoints);
+    m_constraintsLowerBounds.auxiliary_residuals =
+            DM::zeros(m_numAuxiliaryResiduals, m_numGridPoints);
+    m_constraintsUpperBounds.auxiliary_residuals =
+            DM::zeros(m_numAuxiliaryResiduals, m_numGridPoints);
     const auto boundsOnInterpControls = casadi::DM::zeros(
             m_problem.getNumControls(), (int)m_pointsForInterpControls.numel());
     m_constraintsLowerBounds.interp_controls = boundsOnInterpControls;
     m_constraintsUpperBounds.interp_controls = boundsOnInterpControls;
 
-    calcInterpolatingControls();
+    // Kinematic constraints.
+    // ----------------------
+    const int numKinematicConstraints =
+            m_problem.getNumKinematicConstraintEquations();
+    const auto& kcBounds = m_problem.getKinematicConstraintBounds();
+    m_constraintsLowerBounds.kinematic = casadi::DM::repmat(
+            kcBounds.lower, numKinematicConstraints, m_numMeshPoints);
+    m_constraintsUpperBounds.kinematic = casadi::DM::repmat(
+            kcBounds.upper, numKinematicConstraints, m_numMeshPoints);
+
+    // Endpoint constraints.
+    // ---------------------
+    const auto& endpointInfos = m_problem.getEndpointConstraintInfos();
+    m_constraintsLowerBounds.endpoint.resize(endpointInfos.size());
+    m_constraintsUpperBounds.endpoint.resize(endpointInfos.size());
+    for (int iec = 0; iec < (int)endpointInfos.size(); ++iec) {
+        m_constraintsLowerBounds.endpoint[iec] = endpointInfos[iec].lowerBounds;
+        m_constraintsUpperBounds.endpoint[iec] = endpointInfos[iec].upperBounds;
+    }
+
+    // Path constraints.
+    // -----------------
+    const auto& pathInfos = m_problem.getPathConstraintInfos();
+    m_constraintsLowerBounds.path.resize(pathInfos.size());
+    m_constraintsUpperBounds.path.resize(pathInfos.size());
+    for (int ipc = 0; ipc < (int)pathInfos.size(); ++ipc) {
+        m_constraintsLowerBounds.path[ipc] =
+                casadi::DM::repmat(pathInfos[ipc].lowerBounds, 1,
+                        m_numMeshPoints);
+        m_constraintsUpperBounds.path[ipc] =
+                casadi::DM::repmat(pathInfos[ipc].upperBounds, 1,
+                        m_numMeshPoints);
+    }
 }
 
 void Transcription::setObjectiveAndEndpointConstraints() {
@@ -550,8 +683,6 @@ void Transcription::setObjectiveAndEndpointConstraints() {
     int numEndpointConstraints =
             (int)m_problem.getEndpointConstraintInfos().size();
     m_constraints.endpoint.resize(numEndpointConstraints);
-    m_constraintsLowerBounds.endpoint.resize(numEndpointConstraints);
-    m_constraintsUpperBounds.endpoint.resize(numEndpointConstraints);
     for (int iec = 0; iec < (int)m_constraints.endpoint.size(); ++iec) {
         const auto& info = m_problem.getEndpointConstraintInfos()[iec];
 
@@ -579,54 +710,15 @@ void Transcription::setObjectiveAndEndpointConstraints() {
                         integral},
                 endpointOut);
         m_constraints.endpoint[iec] = endpointOut.at(0);
-        m_constraintsLowerBounds.endpoint[iec] = info.lowerBounds;
-        m_constraintsUpperBounds.endpoint[iec] = info.upperBounds;
     }
 }
 
-Solution Transcription::solve(const Iterate& guessOrig) {
+void Transcription::createNlpFunction() {
 
     // Define the NLP.
     // ---------------
     transcribe();
 
-    // Resample the guess.
-    // -------------------
-    const auto guessTimes = createTimes(guessOrig.variables.at(initial_time),
-            guessOrig.variables.at(final_time));
-    auto guess = guessOrig.resample(guessTimes);
-
-    // Adjust guesses for the slack variables to ensure they are the correct
-    // length (i.e. slacks.size2() == m_numPointsIgnoringConstraints).
-    if (guess.variables.find(Var::slacks) != guess.variables.end()) {
-        auto& slacks = guess.variables.at(Var::slacks);
-
-        // If slack variables provided in the guess are equal to the grid
-        // length, remove the elements on the mesh points where the slack
-        // variables are not defined.
-        if (slacks.size2() == m_numGridPoints) {
-            casadi::DM meshIndices = createMeshIndices();
-            std::vector<casadi_int> slackColumnsToRemove;
-            for (int itime = 0; itime < m_numGridPoints; ++itime) {
-                if (meshIndices(itime).__nonzero__()) {
-                    slackColumnsToRemove.push_back(itime);
-                }
-            }
-            // The first argument is an empty vector since we don't want to
-            // remove an entire row.
-            slacks.remove(std::vector<casadi_int>(), slackColumnsToRemove);
-        }
-
-        // Check that either that the slack variables provided in the guess
-        // are the correct length, or that the correct number of columns
-        // were removed.
-        OPENSIM_THROW_IF(slacks.size2() != m_numMeshInteriorPoints,
-                OpenSim::Exception,
-                "Expected slack variables to be length {}, but they are length "
-                "{}.",
-                m_numMeshInteriorPoints, slacks.size2());
-    }
-
     // Create the CasADi NLP function.
     // -------------------------------
     // Option handling is copied from casadi::OptiNode::solver().
@@ -635,21 +727,22 @@ Solution Transcription::solve(const Iterate& guessOrig) {
         options[m_solver.getOptimSolver()] = m_solver.getSolverOptions();
     }
 
-    auto x = flattenVariables(m_vars);
-    casadi_int numVariables = x.numel();
+    m_flatVariables = flattenVariables(m_vars);
+    casadi_int numVariables = m_flatVariables.numel();
 
     // The m_constraints symbolic vector holds all of the expressions for
     // the constraint functions.
-    auto g = flattenConstraints(m_constraints);
-    casadi_int numConstraints = g.numel();
+    m_flatConstraints = flattenConstraints(m_constraints);
+    casadi_int numConstraints = m_flatConstraints.numel();
 
-    NlpsolCallback callback(*this, m_problem, numVariables, numConstraints,
-            m_solver.getCallbackInterval());
-    options["iteration_callback"] = callback;
+    // The callback must outlive the NLP function.
+    m_nlpsolCallback = std::make_shared<NlpsolCallback>(*this, m_problem,
+            numVariables, numConstraints, m_solver.getCallbackInterval());
+    options["iteration_callback"] = *m_nlpsolCallback;
 
     // The inputs to nlpsol() are symbolic (casadi::MX).
     casadi::MXDict nlp;
-    nlp.emplace(std::make_pair("x", x));
+    nlp.emplace(std::make_pair("x", m_flatVariables));
     // The objective symbolic variable holds an expression graph including
     // all the calculations performed on the variables x.
     casadi::MX objective = MX::sum1(m_objectiveTerms);
@@ -657,7 +750,7 @@ Solution Transcription::solve(const Iterate& guessOrig) {
         objective = 0;
     }
     nlp.emplace(std::make_pair("f", objective));
-    nlp.emplace(std::make_pair("g", g));
+    nlp.emplace(std::make_pair("g", m_flatConstraints));
     if (!m_solver.getWriteSparsity().empty()) {
         const auto prefix = m_solver.getWriteSparsity();
         auto gradient = casadi::MX::gradient(nlp["f"], nlp["x"]);
@@ -675,18 +768,75 @@ Solution Transcription::solve(const Iterate& guessOrig) {
         jacobian.sparsity().to_file(
                 prefix + "constraint_Jacobian_sparsity.mtx");
     }
-    const casadi::Function nlpFunc =
-            casadi::nlpsol("nlp", m_solver.getOptimSolver(), nlp, options);
+    m_nlpFunc = casadi::nlpsol("nlp", m_solver.getOptimSolver(), nlp, options);
+    m_objectiveFunc = casadi::Function(
+            "objective", {m_flatVariables}, {m_objectiveTerms});
+    // Used to report constraint violations if the solve fails; create it now
+    // while the caller holds the transcription mutex.
+    m_constraintFunc = casadi::Function(
+            "constraints", {m_flatVariables}, {m_flatConstraints});
+}
+
+Solution Transcription::solve(const Iterate& guessOrig) {
+
+    // Define the NLP, if we have not done so already.
+    // -----------------------------------------------
+    if (m_nlpFunc.is_null()) {
+        std::lock_guard<std::mutex> lock(getTranscriptionMutex());
+        createNlpFunction();
+    } else {
+        // Do not let iterates from a previous solve interleave with this one.
+        m_nlpsolCallback->waitForIterates();
+        m_nlpsolCallback->resetIterationCount();
+    }
+
+    // Resample the guess.
+    // -------------------
+    const auto guessTimes = createTimes(guessOrig.variables.at(initial_time),
+            guessOrig.variables.at(final_time));
+    auto guess = guessOrig.resample(guessTimes);
+
+    // Adjust guesses for the slack variables to ensure they are the correct
+    // length (i.e. slacks.size2() == m_numPointsIgnoringConstraints).
+    if (guess.variables.find(Var::slacks) != guess.variables.end()) {
+        auto& slacks = guess.variables.at(Var::slacks);
+
+        // If slack variables provided in the guess are equal to the grid
+        // length, remove the elements on the mesh points where the slack
+        // variables are not defined.
+        if (slacks.size2() == m_numGridPoints) {
+            casadi::DM meshIndices = createMeshIndices();
+            std::vector<casadi_int> slackColumnsToRemove;
+            for (int itime = 0; itime < m_numGridPoints; ++itime) {
+                if (meshIndices(itime).__nonzero__()) {
+                    slackColumnsToRemove.push_back(itime);
+                }
+            }
+            // The first argument is an empty vector since we don't want to
+            // remove an entire row.
+            slacks.remove(std::vector<casadi_int>(), slackColumnsToRemove);
+        }
+
+        // Check that either that the slack variables provided in the guess
+        // are the correct length, or that the correct number of columns
+        // were removed.
+        OPENSIM_THROW_IF(slacks.size2() != m_numMeshInteriorPoints,
+                OpenSim::Exception,
+                "Expected slack variables to be length {}, but they are length "
+                "{}.",
+                m_numMeshInteriorPoints, slacks.size2());
+    }
 
     // Run the optimization (evaluate the CasADi NLP function).
     // --------------------------------------------------------
     // The inputs and outputs of nlpFunc are numeric (casadi::DM).
     const casadi::DMDict nlpResult =
-            nlpFunc(casadi::DMDict{{"x0", flattenVariables(guess.variables)},
+            m_nlpFunc(casadi::DMDict{{"x0", flattenVariables(guess.variables)},
                     {"lbx", flattenVariables(m_lowerBounds)},
                     {"ubx", flattenVariables(m_upperBounds)},
                     {"lbg", flattenConstraints(m_constraintsLowerBounds)},
                     {"ubg", flattenConstraints(m_constraintsUpperBounds)}});
+    m_nlpsolCallback->waitForIterates();
 
     // Create a CasOC::Solution.
     // -------------------------
@@ -696,14 +846,13 @@ Solution Transcription::solve(const Iterate& guessOrig) {
     solution.objective = nlpResult.at("f").scalar();
 
     casadi::DMVector finalVarsDMV{finalVariables};
-    casadi::Function objectiveFunc("objective", {x}, {m_objectiveTerms});
     casadi::DMVector objectiveOut;
-    objectiveFunc.call(finalVarsDMV, objectiveOut);
+    m_objectiveFunc.call(finalVarsDMV, objectiveOut);
     solution.objective_breakdown = expandObjectiveTerms(objectiveOut[0]);
 
     solution.times = createTimes(
             solution.variables[initial_time], solution.variables[final_time]);
-    solution.stats = nlpFunc.stats();
+    solution.stats = m_nlpFunc.stats();
 
     // Print breakdown of objective.
     printObjectiveBreakdown(solution, objectiveOut[0]);
@@ -712,9 +861,8 @@ Solution Transcription::solve(const Iterate& guessOrig) {
 
         // For some reason, nlpResult.at("g") is all 0. So we calculate the
         // constraints ourselves.
-        casadi::Function constraintFunc("constraints", {x}, {g});
         casadi::DMVector constraintsOut;
-        constraintFunc.call(finalVarsDMV, constraintsOut);
+        m_constraintFunc.call(finalVarsDMV, constraintsOut);
         printConstraintValues(solution, expandConstraints(constraintsOut[0]));
     }
     return solution;
@@ -22,6 +22,9 @@
 
 namespace CasOC {
 
+class IterateWriter;
+class NlpsolCallback;
+
 /// This is the base class for transcription schemes that convert a
 /// CasOC::Problem into a general nonlinear programming problem. If you are
 /// creating a new derived class, make sure to override all virtual functions
@@ -60,8 +63,23 @@ public:
         return meshIndices;
     }
 
+    /// Solve the nonlinear program. The first call transcribes the problem
+    /// and creates the NLP solver function (this includes building the
+    /// symbolic expression graph and the solver's symbolic setup for the
+    /// derivative sparsity patterns). Subsequent calls reuse the NLP solver
+    /// function; only the numerical inputs (initial guess and bounds) change.
+    /// Call updateBounds() before solve() if the bounds in the problem have
+    /// changed since the last call.
     Solution solve(const Iterate& guessOrig);
 
+    /// Copy the variable and constraint bounds from the problem. Use this
+    /// if the bounds in the problem have changed since this transcription
+    /// was created.
+    void updateBounds() {
+        setVariableBoundsFromProblem();
+        setConstraintBoundsFromProblem();
+    }
+
 protected:
     /// This must be called in the constructor of derived classes so that
     /// overridden virtual methods are accessible to the base class. This
@@ -148,6 +166,15 @@ private:
     Constraints<casadi::DM> m_constraintsLowerBounds;
     Constraints<casadi::DM> m_constraintsUpperBounds;
 
+    // These are created by the first call to solve() and reused by subsequent
+    // calls.
+    casadi::MX m_flatVariables;
+    casadi::MX m_flatConstraints;
+    std::shared_ptr<NlpsolCallback> m_nlpsolCallback;
+    casadi::Function m_nlpFunc;
+    casadi::Function m_objectiveFunc;
+    casadi::Function m_constraintFunc;
+
 private:
     /// Override this function in your derived class to compute a vector of
     /// quadrature coeffecients (of length m_numGridPoints) required to set the
@@ -170,6 +197,10 @@ private:
 
     void transcribe();
     void setObjectiveAndEndpointConstraints();
+    /// Create the NLP solver function from the transcribed problem.
+    void createNlpFunction();
+    void setVariableBoundsFromProblem();
+    void setConstraintBoundsFromProblem();
     void calcDefects() {
         calcDefectsImpl(m_vars.at(states), m_xdot, m_constraints.defects);
     }
@@ -396,6 +427,7 @@ private:
     }
 
 
+    friend class IterateWriter;
     friend class NlpsolCallback;
 };
 
@@ -21,7 +21,9 @@
 #include "../MocoUtilities.h"
 #include "CasOCSolver.h"
 #include "MocoCasOCProblem.h"
+#include <algorithm>
 #include <casadi/casadi.hpp>
+#include <thread>
 
 using casadi::Callback;
 using casadi::Dict;
@@ -32,6 +34,13 @@ using casadi::Sparsity;
 
 using namespace OpenSim;
 
+struct MocoCasADiSolver::Session {
+    std::string settingsFingerprint;
+    std::unique_ptr<MocoCasOCProblem> casProblem;
+    std::unique_ptr<CasOC::Solver> casSolver;
+    int numSolves = 0;
+};
+
 MocoCasADiSolver::MocoCasADiSolver() { constructProperties(); }
 
 void MocoCasADiSolver::constructProperties() {
@@ -40,6 +49,11 @@ void MocoCasADiSolver::constructProperties() {
     constructProperty_optim_write_sparsity("");
     constructProperty_optim_finite_difference_scheme("central");
     constructProperty_parallel();
+    constructProperty_reuse_nlp(false);
+    constructProperty_num_time_windows(1);
+    constructProperty_time_window_overlap(0.25);
+    constructProperty_time_window_max_consensus_iterations(3);
+    constructProperty_time_window_continuity_tolerance(1e-3);
     constructProperty_output_interval(0);
 
     constructProperty_minimize_implicit_multibody_accelerations(false);
@@ -124,8 +138,7 @@ const MocoTrajectory& MocoCasADiSolver::getGuess() const {
     return m_guessToUse.getRef();
 }
 
-std::unique_ptr<MocoCasOCProblem> MocoCasADiSolver::createCasOCProblem() const {
-    const auto& problemRep = getProblemRep();
+int MocoCasADiSolver::getNumThreads() const {
     int parallel = 1;
     int parallelEV = getMocoParallelEnvironmentVariable();
     if (getProperty_parallel().size()) {
@@ -141,6 +154,12 @@ std::unique_ptr<MocoCasOCProblem> MocoCasADiSolver::createCasOCProblem() const {
     } else {
         numThreads = parallel;
     }
+    return numThreads;
+}
+
+std::unique_ptr<MocoCasOCProblem> MocoCasADiSolver::createCasOCProblem() const {
+    const auto& problemRep = getProblemRep();
+    const int numThreads = getNumThreads();
 
     checkPropertyInSet(
             *this, getProperty_multibody_dynamics_mode(), {"explicit", "implicit"});
@@ -166,8 +185,16 @@ std::unique_ptr<CasOC::Solver> MocoCasADiSolver::createCasOCSolver(
     // -------------------
     Dict solverOptions;
     checkPropertyInSet(*this, getProperty_optim_solver(), {"ipopt", "snopt"});
-    checkPropertyInSet(*this, getProperty_transcription_scheme(),
-            {"trapezoidal", "hermite-simpson"});
+    std::set<std::string> transcriptionSchemes{
+            "trapezoidal", "hermite-simpson"};
+    for (int degree = 1; degree <= 9; ++degree) {
+        transcriptionSchemes.insert(
+                fmt::format("legendre-gauss-radau-{}", degree));
+        transcriptionSchemes.insert(
+                fmt::format("legendre-gauss-lobatto-{}", degree));
+    }
+    checkPropertyInSet(
+            *this, getProperty_transcription_scheme(), transcriptionSchemes);
     OPENSIM_THROW_IF(casProblem.getNumKinematicConstraintEquations() != 0 &&
                              get_transcription_scheme() == "trapezoidal",
             OpenSim::Exception,
@@ -309,7 +336,55 @@ std::unique_ptr<CasOC::Solver> MocoCasADiSolver::createCasOCSolver(
     return casSolver;
 }
 
+std::string MocoCasADiSolver::createSettingsFingerprint() const {
+    std::string fingerprint;
+    for (int iprop = 0; iprop < getNumProperties(); ++iprop) {
+        const auto& prop = getPropertyByIndex(iprop);
+        // The guess does not affect the structure of the NLP.
+        if (prop.getName() == "guess_file") continue;
+        fingerprint += prop.getName() + "=" + prop.toString() + ";";
+    }
+    // The number of threads may also come from the environment variable.
+    fingerprint += "parallel_environment_variable=" +
+                   std::to_string(getMocoParallelEnvironmentVariable()) + ";";
+    return fingerprint;
+}
+
+MocoCasADiSolver::Session& MocoCasADiSolver::updateSession(
+        std::unique_ptr<MocoCasOCProblem> casProblem) const {
+    const std::string fingerprint = createSettingsFingerprint();
+    if (m_session && m_session->settingsFingerprint == fingerprint &&
+            m_session->casProblem->isStructurallyEqual(*casProblem) &&
+            m_session->casProblem->getJarSize() == casProblem->getJarSize()) {
+        // The CasADi functions in the existing NLP refer to the existing
+        // MocoCasOCProblem, so we give it the new problem's numerical data.
+        m_session->casProblem->updateNumericalDataFrom(*casProblem);
+        if (get_verbosity()) {
+            log_info("Reusing the nonlinear program from a previous solve "
+                     "(solve {} with this program).",
+                    m_session->numSolves + 1);
+        }
+    } else {
+        if (m_session && get_verbosity()) {
+            log_info("The solver settings or the problem structure changed; "
+                     "creating a new nonlinear program.");
+        }
+        auto session = std::make_shared<Session>();
+        session->settingsFingerprint = fingerprint;
+        session->casSolver = createCasOCSolver(*casProblem);
+        session->casSolver->setReuseNLP(true);
+        session->casProblem = std::move(casProblem);
+        m_session = session;
+    }
+    ++m_session->numSolves;
+    return *m_session;
+}
+
 MocoSolution MocoCasADiSolver::solveImpl() const {
+    checkPropertyInRangeOrSet(*this, getProperty_num_time_windows(), 1,
+            std::numeric_limits<int>::max(), {});
+    if (get_num_time_windows() > 1) return solveTimeWindows();
+
     const Stopwatch stopwatch;
 
     if (get_verbosity()) {
@@ -319,16 +394,86 @@ MocoSolution MocoCasADiSolver::solveImpl() const {
         log_info(std::string(72, '-'));
         getProblemRep().printDescription();
     }
-    auto casProblem = createCasOCProblem();
-    auto casSolver = createCasOCSolver(*casProblem);
+    std::unique_ptr<MocoCasOCProblem> casProblem = createCasOCProblem();
+    std::unique_ptr<CasOC::Solver> casSolver;
+    // If reusing the NLP, the problem and solver are owned by the session.
+    const MocoCasOCProblem* casProblemToUse = casProblem.get();
+    const CasOC::Solver* casSolverToUse = nullptr;
+    if (get_reuse_nlp()) {
+        const Session& session = updateSession(std::move(casProblem));
+        casProblemToUse = session.casProblem.get();
+        casSolverToUse = session.casSolver.get();
+    } else {
+        m_session.reset();
+        casSolver = createCasOCSolver(*casProblem);
+        casSolverToUse = casSolver.get();
+    }
     if (get_verbosity()) {
-        log_info("Number of threads: {}", casProblem->getJarSize());
+        log_info("Number of threads: {}", casProblemToUse->getJarSize());
+    }
+
+    // CasADi's caches (e.g., of Sparsity patterns) are shared by all threads,
+    // so the CasOC Functions owned by the problem must be destroyed while
+    // holding the transcription lock, as they are created (this matters when
+    // solving time windows concurrently).
+    const auto destroyCasOCProblem = [&]() {
+        std::lock_guard<std::mutex> lock(CasOC::getTranscriptionMutex());
+        casSolver.reset();
+        casProblem.reset();
+    };
+    MocoSolution solution;
+    try {
+        solution = solveCasOCProblem(stopwatch, *casSolverToUse, getGuess());
+    } catch (...) {
+        destroyCasOCProblem();
+        throw;
+    }
+    destroyCasOCProblem();
+    return solution;
+}
+
+MocoSolution MocoCasADiSolver::solveHorizon(bool updateProblemRep,
+        double initialTime, double finalTime,
+        const std::map<std::string, double>& initialStates,
+        const MocoTrajectory& guess) const {
+    const Stopwatch stopwatch;
+    if (updateProblemRep || !m_session) {
+        updateSession(createCasOCProblem());
+    } else {
+        ++m_session->numSolves;
+    }
+    MocoCasOCProblem& casProblem = *m_session->casProblem;
+
+    // States without a provided value keep the initial bounds from the
+    // problem.
+    const auto& problemRep = getProblemRep();
+    std::vector<CasOC::Bounds> stateInitialBounds;
+    for (const auto& info : casProblem.getStateInfos()) {
+        const auto it = initialStates.find(info.name);
+        if (it != initialStates.end()) {
+            stateInitialBounds.emplace_back(it->second, it->second);
+        } else {
+            stateInitialBounds.push_back(convertBounds(
+                    problemRep.getStateInfo(info.name).getInitialBounds()));
+        }
+    }
+    for (const auto& kv : initialStates) {
+        OPENSIM_THROW_IF(!problemRep.getStateInfo(kv.first).getBounds()
+                                  .isWithinBounds(kv.second),
+                Exception,
+                "Initial value {} for state '{}' is outside its bounds.",
+                kv.second, kv.first);
     }
+    casProblem.setTimeAndStateInitialBounds({initialTime, initialTime},
+            {finalTime, finalTime}, stateInitialBounds);
+    return solveCasOCProblem(stopwatch, *m_session->casSolver, guess);
+}
 
-    MocoTrajectory guess = getGuess();
+MocoSolution MocoCasADiSolver::solveCasOCProblem(const Stopwatch& stopwatch,
+        const CasOC::Solver& casSolver, const MocoTrajectory& guess) const {
     CasOC::Iterate casGuess;
     if (guess.empty()) {
-        casGuess = casSolver->createInitialGuessFromBounds();
+        casGuess = casSolver.createInitialGuessFromBounds();
     } else {
         casGuess = convertToCasOCIterate(guess);
     }
@@ -339,7 +484,7 @@ MocoSolution MocoCasADiSolver::solveImpl() const {
     Logger::setLevel(Logger::Level::Warn);
     CasOC::Solution casSolution;
     try {
-        casSolution = casSolver->solve(casGuess);
+        casSolution = casSolver.solve(casGuess);
     } catch (...) {
         OpenSim::Logger::setLevel(origLoggerLevel);
     }
@@ -413,3 +558,312 @@ MocoSolution MocoCasADiSolver::solveImpl() const {
     }
     return mocoSolution;
 }
+
+namespace {
+/// Interpolate the value of a state variable of a trajectory at the given
+/// time.
+double interpolateState(const MocoTrajectory& trajectory,
+        const std::string& name, double time) {
+    return interpolate(trajectory.getTime(),
+            SimTK::Vector(trajectory.getState(name)), createVector({time}))[0];
+}
+
+/// Concatenate the solutions of consecutive time windows: window i contributes
+/// its points with times in [startTimes[i], startTimes[i + 1]), and the last
+/// window contributes all of its points.
+MocoSolution stitchTimeWindows(const std::vector<MocoSolution>& windows,
+        const std::vector<double>& startTimes) {
+    const int numWindows = (int)windows.size();
+    std::vector<std::pair<int, int>> windowAndIndex;
+    for (int iw = 0; iw < numWindows; ++iw) {
+        const auto& time = windows[iw].getTime();
+        for (int itime = 0; itime < time.size(); ++itime) {
+            if (iw == numWindows - 1 || time[itime] < startTimes[iw + 1]) {
+                windowAndIndex.emplace_back(iw, itime);
+            }
+        }
+    }
+
+    const auto& first = windows[0];
+    const int numTimes = (int)windowAndIndex.size();
+    SimTK::Vector time(numTimes);
+    SimTK::Matrix states;
+    SimTK::Matrix controls;
+    SimTK::Matrix multipliers;
+    SimTK::Matrix derivatives;
+    SimTK::Matrix slacks;
+    if (!first.getStateNames().empty()) {
+        states.resize(numTimes, (int)first.getStateNames().size());
+    }
+    if (!first.getControlNames().empty()) {
+        controls.resize(numTimes, (int)first.getControlNames().size());
+    }
+    if (!first.getMultiplierNames().empty()) {
+        multipliers.resize(numTimes, (int)first.getMultiplierNames().size());
+    }
+    if (!first.getDerivativeNames().empty()) {
+        derivatives.resize(numTimes, (int)first.getDerivativeNames().size());
+    }
+    if (!first.getSlackNames().empty()) {
+        slacks.resize(numTimes, (int)first.getSlackNames().size());
+    }
+    for (int itime = 0; itime < numTimes; ++itime) {
+        const auto& window = windows[windowAndIndex[itime].first];
+        const int index = windowAndIndex[itime].second;
+        time[itime] = window.getTime()[index];
+        if (states.ncol()) states[itime] = window.getStatesTrajectory()[index];
+        if (controls.ncol()) {
+            controls[itime] = window.getControlsTrajectory()[index];
+        }
+        if (multipliers.ncol()) {
+            multipliers[itime] = window.getMultipliersTrajectory()[index];
+        }
+        if (derivatives.ncol()) {
+            derivatives[itime] = window.getDerivativesTrajectory()[index];
+        }
+        if (slacks.ncol()) slacks[itime] = window.getSlacksTrajectory()[index];
+    }
+
+    MocoSolution solution(time, first.getStateNames(),
+            first.getControlNames(), first.getMultiplierNames(),
+            first.getDerivativeNames(), first.getParameterNames(), states,
+            controls, multipliers, derivatives, first.getParameters());
+    for (int isl = 0; isl < (int)first.getSlackNames().size(); ++isl) {
+        solution.appendSlack(first.getSlackNames()[isl], slacks.col(isl));
+    }
+    return solution;
+}
+} // anonymous namespace
+
+MocoSolution MocoCasADiSolver::solveTimeWindow(double startTime,
+        double endTime, bool isFirst, bool isLast, int numMeshIntervals,
+        const MocoTrajectory* previousWindow,
+        const MocoTrajectory& guess) const {
+    const auto& problemRep = getProblemRep();
+
+    // The original initial and final bounds apply only to the ends of the
+    // entire time horizon.
+    MocoProblem problem(getProblem());
+    MocoPhase& phase = problem.updPhase(0);
+    phase.setTimeBounds(startTime, endTime);
+    for (const auto& name : problemRep.createStateInfoNames()) {
+        const auto& info = problemRep.getStateInfo(name);
+        MocoInitialBounds initialBounds;
+        if (isFirst) {
+            initialBounds = info.getInitialBounds();
+        } else if (previousWindow) {
+            const auto& previousNames = previousWindow->getStateNames();
+            if (std::find(previousNames.begin(), previousNames.end(), name) !=
+                    previousNames.end()) {
+                initialBounds = MocoInitialBounds(
+                        interpolateState(*previousWindow, name, startTime));
+            }
+        }
+        phase.setStateInfo(name, info.getBounds(), initialBounds,
+                isLast ? info.getFinalBounds() : MocoFinalBounds());
+    }
+    for (const auto& name : problemRep.createControlInfoNames()) {
+        const auto& info = problemRep.getControlInfo(name);
+        phase.setControlInfo(name, info.getBounds(),
+                isFirst ? info.getInitialBounds() : MocoInitialBounds(),
+                isLast ? info.getFinalBounds() : MocoFinalBounds());
+    }
+
+    MocoCasADiSolver solver(*this);
+    solver.set_num_time_windows(1);
+    solver.set_num_mesh_intervals(numMeshIntervals);
+    // A custom mesh would override num_mesh_intervals.
+    solver.updProperty_mesh().clear();
+    solver.set_parallel(0);
+    solver.set_reuse_nlp(false);
+    solver.set_verbosity(0);
+    solver.set_output_interval(0);
+    solver.set_optim_write_sparsity("");
+    solver.resetProblem(problem);
+    solver.clearGuess();
+    if (!guess.empty()) solver.setGuess(guess);
+    MocoSolution solution = solver.solveImpl();
+    // Keep access to failed windows; success() is still available.
+    solution.unseal();
+    return solution;
+}
+
+MocoSolution MocoCasADiSolver::solveTimeWindows() const {
+    const Stopwatch stopwatch;
+    const auto& problemRep = getProblemRep();
+
+    checkPropertyInRangeOrSet(
+            *this, getProperty_time_window_overlap(), 0.0, 1.0, {});
+    checkPropertyInRangeOrSet(*this,
+            getProperty_time_window_max_consensus_iterations(), 0,
+            std::numeric_limits<int>::max(), {});
+    checkPropertyInRangeOrSet(*this,
+            getProperty_time_window_continuity_tolerance(), 0.0,
+            SimTK::NTraits<double>::getInfinity(), {});
+    OPENSIM_THROW_IF(!problemRep.getTimeInitialBounds().isEquality() ||
+                             !problemRep.getTimeFinalBounds().isEquality(),
+            Exception,
+            "Solving in time windows requires fixed initial and final "
+            "times.");
+    OPENSIM_THROW_IF(problemRep.getNumParameters(), Exception,
+            "Solving in time windows does not support parameters.");
+    OPENSIM_THROW_IF(problemRep.getNumEndpointConstraints(), Exception,
+            "Solving in time windows does not support endpoint constraints.");
+    for (int ic = 0; ic < problemRep.getNumCosts(); ++ic) {
+        const auto& cost = problemRep.getCostByIndex(ic);
+        OPENSIM_THROW_IF(cost.getNumIntegrals() == 0, Exception,
+                "Solving in time windows requires all costs to be integrals, "
+                "but cost '{}' has no integral.",
+                cost.getName());
+    }
+
+    const int numWindows = get_num_time_windows();
+    const double initialTime = problemRep.getTimeInitialBounds().getLower();
+    const double finalTime = problemRep.getTimeFinalBounds().getLower();
+    const double windowDuration = (finalTime - initialTime) / numWindows;
+    std::vector<double> startTimes(numWindows + 1);
+    for (int iw = 0; iw < numWindows; ++iw) {
+        startTimes[iw] = initialTime + iw * windowDuration;
+    }
+    startTimes[numWindows] = finalTime;
+    std::vector<double> endTimes(numWindows);
+    std::vector<int> numMeshIntervals(numWindows);
+    for (int iw = 0; iw < numWindows; ++iw) {
+        endTimes[iw] = iw == numWindows - 1
+                               ? finalTime
+                               : std::min(finalTime,
+                                         startTimes[iw + 1] +
+                                                 get_time_window_overlap() *
+                                                         windowDuration);
+        numMeshIntervals[iw] = std::max(1,
+                (int)std::ceil(get_num_mesh_intervals() *
+                               (endTimes[iw] - startTimes[iw]) /
+                               (finalTime - initialTime)));
+    }
+    const int numThreads = std::max(1, std::min(getNumThreads(), numWindows));
+
+    if (get_verbosity()) {
+        log_info(std::string(72, '='));
+        log_info("MocoCasADiSolver starting.");
+        log_info(getMocoFormattedDateTime(false, "%c"));
+        log_info(std::string(72, '-'));
+        problemRep.printDescription();
+        log_info("Solving {} time windows using {} thread(s).", numWindows,
+                numThreads);
+    }
+
+    // Use the provided guess (if any) for the first pass.
+    const MocoTrajectory& guess = getGuess();
+    std::vector<MocoTrajectory> guesses(numWindows);
+    if (!guess.empty()) {
+        for (int iw = 0; iw < numWindows; ++iw) {
+            guesses[iw] = guess;
+            guesses[iw].resample(createVectorLinspace(numMeshIntervals[iw] + 1,
+                    startTimes[iw], endTimes[iw]));
+        }
+    }
+
+    // The logger level is global, so we cannot let each window change it
+    // (see solveImpl()); the windows leave the level as we set it here.
+    Logger::Level origLoggerLevel = Logger::getLevel();
+    Logger::setLevel(Logger::Level::Warn);
+
+    std::vector<MocoSolution> windows(numWindows);
+    std::vector<MocoSolution> previousWindows;
+    int numIterations = 0;
+    double continuityError = SimTK::Infinity;
+    std::vector<double> continuityErrors;
+    const double tolerance = get_time_window_continuity_tolerance();
+    try {
+        for (int iteration = 0;
+                iteration <= get_time_window_max_consensus_iterations();
+                ++iteration) {
+            previousWindows = windows;
+            runTasksInParallel(numWindows, numThreads, [&](int iw) {
+                const MocoTrajectory* previousWindow =
+                        iteration > 0 && iw > 0 ? &previousWindows[iw - 1]
+                                                : nullptr;
+                windows[iw] = solveTimeWindow(startTimes[iw], endTimes[iw],
+                        iw == 0, iw == numWindows - 1, numMeshIntervals[iw],
+                        previousWindow,
+                        iteration > 0 ? previousWindows[iw] : guesses[iw]);
+            });
+
+            continuityError = 0;
+            for (int iw = 1; iw < numWindows; ++iw) {
+                for (const auto& name : windows[iw].getStateNames()) {
+                    const double previous = interpolateState(
+                            windows[iw - 1], name, startTimes[iw]);
+                    continuityError = std::max(continuityError,
+                            std::abs(previous - windows[iw].getState(name)[0]));
+                }
+            }
+            for (const auto& window : windows) {
+                numIterations += window.getNumIterations();
+            }
+            continuityErrors.push_back(continuityError);
+            if (continuityError < tolerance) break;
+        }
+    } catch (...) {
+        Logger::setLevel(origLoggerLevel);
+        throw;
+    }
+    Logger::setLevel(origLoggerLevel);
+    if (get_verbosity()) {
+        for (int ipass = 0; ipass < (int)continuityErrors.size(); ++ipass) {
+            log_info("Time windows pass {}: largest state discontinuity "
+                     "between windows: {}.",
+                    ipass, continuityErrors[ipass]);
+        }
+    }
+
+    MocoSolution mocoSolution = stitchTimeWindows(windows, startTimes);
+
+    bool success = true;
+    std::string status = windows.back().getStatus();
+    for (int iw = 0; iw < numWindows; ++iw) {
+        if (!windows[iw].success()) {
+            success = false;
+            status = fmt::format(
+                    "Time window {}: {}", iw, windows[iw].getStatus());
+            break;
+        }
+    }
+    if (success && !(continuityError < tolerance)) {
+        success = false;
+        status = fmt::format("Time windows did not reach the continuity "
+                             "tolerance (largest state discontinuity: {}).",
+                continuityError);
+    }
+    // The costs are integrals, so the objective is (approximately) the sum
+    // of the objectives of the windows.
+    double objective = 0;
+    std::vector<std::pair<std::string, double>> objectiveBreakdown;
+    for (const auto& name : windows[0].getObjectiveTermNames()) {
+        objectiveBreakdown.emplace_back(name, 0);
+    }
+    for (const auto& window : windows) {
+        objective += window.getObjective();
+        for (auto& term : objectiveBreakdown) {
+            term.second += window.getObjectiveTerm(term.first);
+        }
+    }
+
+    const long long elapsed = stopwatch.getElapsedTimeInNs();
+    setSolutionStats(mocoSolution, success, objective, status, numIterations,
+            SimTK::nsToSec(elapsed), objectiveBreakdown);
+
+    if (get_verbosity()) {
+        log_info(std::string(72, '-'));
+        log_info("Elapsed real time: {}.", stopwatch.formatNs(elapsed));
+        log_info(getMocoFormattedDateTime(false, "%c"));
+        if (mocoSolution) {
+            log_info("MocoCasADiSolver succeeded!");
+        } else {
+            log_warn("MocoCasADiSolver did NOT succeed:");
+            log_warn("  {}", mocoSolution.getStatus());
+        }
+        log_info(std::string(72, '='));
+    }
+    return mocoSolution;
+}
@@ -27,6 +27,7 @@ class Solver;
 namespace OpenSim {
 
 class MocoCasOCProblem;
+class Stopwatch;
 
 /// This solver uses the CasADi library (https://casadi.org) to convert the
 /// MocoProblem into a generic nonlinear programming problem. CasADi efficiently
@@ -95,13 +96,66 @@ class MocoCasOCProblem;
 /// handling problems with MocoParameters. Many parameters require invoking
 /// Model::initSystem() to take effect, and this function is expensive (for
 /// CasADi, we must invoke this function for every time point, while in Tropter,
-/// we can invoke the function only once for every NLP iterate). However, if you
-/// know that all parameters in your problem do not require Model::initSystem(),
-/// you can substantially speed up your optimization by setting the
-/// parameters_require_initsystem property to false. Be careful, though: you
-/// will end up with incorrect results if your parameter does indeed require
-/// Model::initSystem(). To protect against this, ensure that you obtain the
-/// same results whether this setting is true or false.
+/// we can invoke the function only once for every NLP iterate). Moco detects
+/// some parameters that do not need Model::initSystem() (see
+/// MocoParameter::getUpdateMethod()): body mass properties (mass,
+/// mass_center, inertia) are applied directly to the Simbody System, and
+/// properties that components read directly (a muscle's
+/// max_isometric_force; the stiffness, dissipation, or friction_coefficient
+/// of a StationPlaneContactForce) only require discarding cached values.
+/// If all parameters are of these kinds, Model::initSystem() is never
+/// invoked. If you know that your other parameters do not require
+/// Model::initSystem() either, you can substantially speed up your
+/// optimization by setting the parameters_require_initsystem property to
+/// false. Be careful, though: you will end up with incorrect results if your
+/// parameter does indeed require Model::initSystem(). To protect against
+/// this, ensure that you obtain the same results whether this setting is true
+/// or false.
+///
+/// Reusing the NLP across solves
+/// =============================
+/// Before the first iteration, the solver transcribes the MocoProblem into a
+/// nonlinear program (NLP): it builds a symbolic expression graph, detects the
+/// sparsity of the problem's derivatives (see optim_sparsity_detection), and
+/// the NLP solver (e.g., IPOPT) performs its own symbolic setup. If you solve
+/// the same problem many times with different numerical data (e.g., changing
+/// bounds, goal weights, reference data, or initial guesses), set the
+/// `reuse_nlp` property to true. The first solve creates the NLP as usual
+/// and keeps it; subsequent solves reuse it as long as the solver's settings
+/// and the problem's structure (its variables, goals, and constraints) have
+/// not changed, and thus only pay for the numerical optimization. If the
+/// settings or the structure have changed, the NLP is created again.
+/// If optim_sparsity_detection is 'initial-guess', the sparsity pattern is
+/// detected from the initial guess of the first solve only.
+///
+/// Solving long trials in time windows
+/// ===================================
+/// The size of the NLP grows linearly with the duration of the trial, and the
+/// cost of factorizing the NLP solver's linear systems grows faster than that.
+/// For long trials (e.g., several gait cycles), you can set
+/// `num_time_windows` to split the time horizon into this many windows of
+/// equal duration, solve the windows concurrently (each with its own copy of
+/// the problem and a proportional share of `num_mesh_intervals`), and stitch
+/// the window solutions into a solution for the entire horizon. Each window
+/// except the last extends past the start of the next window by
+/// `time_window_overlap` times the window duration, so that the next window
+/// does not start where the previous window's solution is affected by its free
+/// final state. The windows are first solved independently. Then, in each
+/// consensus iteration, the initial state of each window is set to the state
+/// of the previous window's solution at that time, and all windows are solved
+/// again (warm-started from their previous solutions), until the largest
+/// discontinuity in the states between adjacent windows is less than
+/// `time_window_continuity_tolerance` or after
+/// `time_window_max_consensus_iterations` iterations.
+/// The number of windows solved at the same time is determined by the
+/// `parallel` property (or the OPENSIM_MOCO_PARALLEL environment variable),
+/// and each window is solved without parallelization.
+///
+/// This mode requires fixed initial and final times, and supports only
+/// problems without parameters and endpoint constraints, and whose costs are
+/// all integrals (e.g., effort and tracking costs). Costs are evaluated
+/// separately in each window, so the overlaps are counted twice in the
+/// objective. The custom `mesh` and `reuse_nlp` are not used in this mode.
 ///
 /// @note The software license of CasADi (LGPL) is more restrictive than that of
 /// the rest of Moco (Apache 2.0).
@@ -114,7 +168,8 @@ class OSIMMOCO_API MocoCasADiSolver : public MocoDirectCollocationSolver {
 public:
     OpenSim_DECLARE_PROPERTY(parameters_require_initsystem, bool,
             "Do some MocoParameters in the problem require invoking "
-            "initSystem() to take effect properly? "
+            "initSystem() to take effect properly? If true, initSystem() is "
+            "still avoided for parameters known not to require it. "
             "This substantialy slows down problems with parameter variables "
             "(default: true).");
     OpenSim_DECLARE_PROPERTY(optim_sparsity_detection, std::string,
@@ -135,11 +190,33 @@ public:
             "0: not parallel; 1: use all cores (default); greater than 1: use"
             "this number of threads. This overrides the OPENSIM_MOCO_PARALLEL "
             "environment variable.");
+    OpenSim_DECLARE_PROPERTY(reuse_nlp, bool,
+            "Keep the nonlinear program (symbolic expression graph, "
+            "derivative sparsity patterns, and NLP solver) created by solve() "
+            "and reuse it in subsequent solves if the solver settings and the "
+            "structure of the problem have not changed (default: false).");
+    OpenSim_DECLARE_PROPERTY(num_time_windows, int,
+            "Split the time horizon into this many overlapping windows, solve "
+            "the windows concurrently, and stitch the solutions together "
+            "(default: 1, solve the entire horizon at once).");
+    OpenSim_DECLARE_PROPERTY(time_window_overlap, double,
+            "Extend each time window (except the last) past the start of the "
+            "next window by this fraction of the window duration "
+            "(default: 0.25).");
+    OpenSim_DECLARE_PROPERTY(time_window_max_consensus_iterations, int,
+            "Maximum number of times the windows are re-solved with their "
+            "initial states set from the previous windows (default: 3).");
+    OpenSim_DECLARE_PROPERTY(time_window_continuity_tolerance, double,
+            "Stop the consensus iterations once the largest difference "
+            "in state values between adjacent windows is less than this "
+            "(default: 1e-3).");
     OpenSim_DECLARE_PROPERTY(output_interval, int,
             "Write intermediate trajectories to file. 0, the default, "
             "indicates no intermediate trajectories are saved, 1 indicates "
             "each iteration is saved, 5 indicates every fifth iteration is "
-            "saved, etc.");
+            "saved, etc. Files are written on a separate thread; if writing "
+            "falls behind the optimizer, the oldest pending iterates are "
+            "skipped.");
 
     OpenSim_DECLARE_PROPERTY(minimize_implicit_multibody_accelerations, bool,
             "Minimize the integral of the squared acceleration continuous "
@@ -222,6 +299,48 @@ protected:
 private:
     void constructProperties();
 
+    /// The number of threads to use, from the `parallel` property or the
+    /// OPENSIM_MOCO_PARALLEL environment variable.
+    int getNumThreads() const;
+
+    /// Solve the CasOC problem and convert the result to a MocoSolution.
+    MocoSolution solveCasOCProblem(const Stopwatch& stopwatch,
+            const CasOC::Solver& casSolver,
+            const MocoTrajectory& guess) const;
+
+    /// Solve the problem over [initialTime, finalTime] with the provided
+    /// initial state values, reusing the NLP (see reuse_nlp). If
+    /// updateProblemRep is false and an NLP exists, the existing
+    /// MocoProblemRep%s are reused and only the bounds change; otherwise, the
+    /// MocoProblemRep%s are created from the problem passed to
+    /// resetProblem(). This is used by MocoRecedingHorizon.
+    MocoSolution solveHorizon(bool updateProblemRep, double initialTime,
+            double finalTime, const std::map<std::string, double>& initialStates,
+            const MocoTrajectory& guess) const;
+    friend class MocoRecedingHorizon;
+
+    /// Solve the problem in time windows (see num_time_windows).
+    MocoSolution solveTimeWindows() const;
+    /// Solve the problem over [startTime, endTime] only. The original initial
+    /// and final bounds are used only if the window is first or last,
+    /// respectively. If previousWindow is provided, the initial states are
+    /// set to its states at startTime.
+    MocoSolution solveTimeWindow(double startTime, double endTime,
+            bool isFirst, bool isLast, int numMeshIntervals,
+            const MocoTrajectory* previousWindow,
+            const MocoTrajectory& guess) const;
+
+    /// The CasOC problem and solver (and, within the solver, the transcribed
+    /// NLP) kept across solves when reuse_nlp is true.
+    struct Session;
+    /// Create a string that changes if any of this solver's settings that
+    /// affect the structure of the NLP change.
+    std::string createSettingsFingerprint() const;
+    /// Return the session to use for solving casProblem, reusing the
+    /// existing session if possible.
+    Session& updateSession(std::unique_ptr<MocoCasOCProblem> casProblem) const;
+    mutable SimTK::ResetOnCopy<std::shared_ptr<Session>> m_session;
+
     // When a copy of the solver is made, we want to keep any guess specified
     // by the API, but want to discard anything we've cached by loading a file.
     MocoTrajectory m_guessFromAPI;
@@ -72,6 +72,15 @@ MocoCasOCProblem::MocoCasOCProblem(const MocoCasADiSolver& mocoCasADiSolver,
                 convertBounds(info.getInitialBounds()),
                 convertBounds(info.getFinalBounds()));
     }
+    // Avoid hash lookups when copying coordinates into SimTK::State.
+    m_coordinateQIndices.resize(getNumCoordinates());
+    m_coordinateQIndicesAreContiguous = true;
+    for (int isv = 0; isv < getNumCoordinates(); ++isv) {
+        m_coordinateQIndices[isv] = m_yIndexMap.at(isv);
+        if (m_coordinateQIndices[isv] != isv) {
+            m_coordinateQIndicesAreContiguous = false;
+        }
+    }
 
     auto controlNames =
             createControlNamesFromModel(model, m_modelControlIndices);
@@ -207,6 +216,25 @@ MocoCasOCProblem::MocoCasOCProblem(const MocoCasADiSolver& mocoCasADiSolver,
 
         // Set kinematic constraint information on the CasOC::Problem.
         setEnforceConstraintDerivatives(enforceConstraintDerivs);
+
+        // QErr contains the position-level equations; UErr contains the
+        // derivatives of the position-level equations followed by the
+        // velocity-level equations, and UDotErr contains the second
+        // derivatives of the position-level equations, the derivatives of the
+        // velocity-level equations, and the acceleration-level equations.
+        auto& layout = m_kinematicConstraintErrorLayout;
+        layout.qerrSize = total_mp;
+        if (enforceConstraintDerivs) {
+            layout.uerrOffset = 0;
+            layout.uerrSize = total_mp + total_mv;
+            layout.udoterrOffset = 0;
+            layout.udoterrSize = total_mp + total_mv + total_ma;
+        } else {
+            layout.uerrOffset = total_mp;
+            layout.uerrSize = total_mv;
+            layout.udoterrOffset = total_mp + total_mv;
+            layout.udoterrSize = total_ma;
+        }
         // The bounds are the same for all kinematic constraints in the
         // MocoProblem, so just grab the bounds from the first constraint.
         // TODO: This behavior may be unexpected for users.
@@ -43,10 +43,15 @@ inline CasOC::Bounds convertBounds(const MocoFinalBounds& mb) {
 /// This converts a SimTK::Matrix to a casadi::DM matrix, transposing the
 /// data in the process.
 inline casadi::DM convertToCasADiDMTranspose(const SimTK::Matrix& simtkMatrix) {
-    casadi::DM out(simtkMatrix.ncol(), simtkMatrix.nrow());
+    // Write directly into the (column-major) nonzeros of a dense matrix;
+    // assigning elements of a DM one at a time is slow, as each assignment
+    // may change the sparsity pattern.
+    casadi::DM out(
+            casadi::Sparsity::dense(simtkMatrix.ncol(), simtkMatrix.nrow()));
+    double* data = out.ptr();
     for (int irow = 0; irow < simtkMatrix.nrow(); ++irow) {
         for (int icol = 0; icol < simtkMatrix.ncol(); ++icol) {
-            out(icol, irow) = simtkMatrix(irow, icol);
+            *data++ = simtkMatrix(irow, icol);
         }
     }
     return out;
@@ -116,6 +121,17 @@ VectorType convertToSimTKVector(const casadi::DM& casVector) {
 /// SimTK::Matrix, transposing the data in the process.
 inline SimTK::Matrix convertToSimTKMatrix(const casadi::DM& casMatrix) {
     SimTK::Matrix simtkMatrix((int)casMatrix.columns(), (int)casMatrix.rows());
+    if (casMatrix.is_dense()) {
+        // Read the (column-major) nonzeros directly, rather than creating a
+        // DM for each element.
+        const double* data = casMatrix.ptr();
+        for (int icol = 0; icol < simtkMatrix.nrow(); ++icol) {
+            for (int irow = 0; irow < simtkMatrix.ncol(); ++irow) {
+                simtkMatrix(icol, irow) = *data++;
+            }
+        }
+        return simtkMatrix;
+    }
     for (int irow = 0; irow < casMatrix.rows(); ++irow) {
         for (int icol = 0; icol < casMatrix.columns(); ++icol) {
             simtkMatrix(icol, irow) = double(casMatrix(irow, icol));
@@ -199,6 +215,38 @@ public:
 
     int getJarSize() const { return (int)m_jar->size(); }
 
+    /// Change the time bounds and the initial bounds of the states (in the
+    /// order of getStateInfos()) without changing the structure of the
+    /// problem, so that a transcribed NLP can be reused for a different time
+    /// horizon (see MocoRecedingHorizon).
+    void setTimeAndStateInitialBounds(CasOC::Bounds initialTime,
+            CasOC::Bounds finalTime,
+            const std::vector<CasOC::Bounds>& stateInitialBounds) {
+        OPENSIM_THROW_IF((int)stateInitialBounds.size() != getNumStates(),
+                Exception, "Expected initial bounds for {} states, but got {}.",
+                getNumStates(), stateInitialBounds.size());
+        setTimeBounds(std::move(initialTime), std::move(finalTime));
+        for (int is = 0; is < getNumStates(); ++is) {
+            setStateInitialBounds(is, stateInitialBounds[is]);
+        }
+    }
+
+    /// Take the MocoProblemRep%s and the bounds from another, structurally
+    /// equal, MocoCasOCProblem (see CasOC::Problem::isStructurallyEqual()).
+    /// The CasADi functions created by initialize() still refer to this
+    /// object, so this allows a previously-transcribed NLP to use new
+    /// numerical data (bounds, goal weights, reference data, model property
+    /// values, etc.) without transcribing the problem again.
+    void updateNumericalDataFrom(MocoCasOCProblem& other) {
+        OPENSIM_THROW_IF(other.getJarSize() != getJarSize(), Exception,
+                "Expected the other problem to have {} problem "
+                "representations, but it has {}.",
+                getJarSize(), other.getJarSize());
+        copyBoundsFrom(other);
+        m_jar = std::move(other.m_jar);
+        m_paramsRequireInitSystem = other.m_paramsRequireInitSystem;
+    }
+
 private:
     void calcMultibodySystemExplicit(const ContinuousInput& input,
             bool calcKCErrors,
@@ -525,17 +573,21 @@ private:
             simtkState.setTime(time);
             // Assign the generalized coordinates. We know we have NU
             // generalized speeds because we do not yet support quaternions.
-            for (int isv = 0; isv < getNumCoordinates(); ++isv) {
-                simtkState.updQ()[m_yIndexMap.at(isv)] = *(states.ptr() + isv);
+            const double* statesData = states.ptr();
+            double* y = simtkState.updY().updContiguousScalarData();
+            if (m_coordinateQIndicesAreContiguous) {
+                std::copy_n(statesData, getNumCoordinates(), y);
+            } else {
+                for (int isv = 0; isv < getNumCoordinates(); ++isv) {
+                    y[m_coordinateQIndices[isv]] = statesData[isv];
+                }
             }
-            std::copy_n(states.ptr() + getNumCoordinates(), getNumSpeeds(),
-                    simtkState.updY().updContiguousScalarData() +
-                            simtkState.getNQ());
+            std::copy_n(statesData + getNumCoordinates(), getNumSpeeds(),
+                    y + simtkState.getNQ());
             if (copyAuxStates) {
-                std::copy_n(states.ptr() + getNumCoordinates() + getNumSpeeds(),
+                std::copy_n(statesData + getNumCoordinates() + getNumSpeeds(),
                         getNumAuxiliaryStates(),
-                        simtkState.updY().updContiguousScalarData() +
-                                simtkState.getNQ() + simtkState.getNU());
+                        y + simtkState.getNQ() + simtkState.getNU());
             }
             // Prescribing motion requires that time is updated.
             model.getSystem().prescribe(simtkState);
@@ -671,17 +723,9 @@ private:
         // constraints would be redundant, and we need not enforce them.
         if (isPrescribedKinematics()) return;
 
-        // The total number of scalar holonomic, non-holonomic, and acceleration
-        // constraint equations enabled in the model. This does not count
-        // equations for derivatives of holonomic and non-holonomic constraints.
-        const int total_mp = getNumHolonomicConstraintEquations();
-        const int total_mv = getNumNonHolonomicConstraintEquations();
-        const int total_ma = getNumAccelerationConstraintEquations();
-
-        // Position-level errors.
-        const auto& qerr = stateBase.getQErr();
+        const auto& layout = m_kinematicConstraintErrorLayout;
 
-        if (getEnforceConstraintDerivatives() || total_ma) {
+        if (layout.udoterrSize) {
             // Calculate udoterr. We cannot use State::getUDotErr()
             // because that uses Simbody's multipliers and UDot,
             // whereas we have our own multipliers and UDot. Here, we use
@@ -691,44 +735,23 @@ private:
             const auto& matter = modelBase.getMatterSubsystem();
             matter.calcConstraintAccelerationErrors(stateBase,
                     simtkStateDisabledConstraints.getUDot(), m_pvaerr);
-        } else {
-            m_pvaerr = SimTK::NaN;
-        }
-
-        const auto& uerr = stateBase.getUErr();
-        int uerrOffset;
-        int uerrSize;
-        const auto& udoterr = m_pvaerr;
-        int udoterrOffset;
-        int udoterrSize;
-        // TODO These offsets and sizes could be computed once.
-        if (getEnforceConstraintDerivatives()) {
-            // Velocity-level errors.
-            uerrOffset = 0;
-            uerrSize = uerr.size();
-            // Acceleration-level errors.
-            udoterrOffset = 0;
-            udoterrSize = udoterr.size();
-        } else {
-            // Velocity-level errors. Skip derivatives of position-level
-            // constraint equations.
-            uerrOffset = total_mp;
-            uerrSize = total_mv;
-            // Acceleration-level errors. Skip derivatives of velocity-
-            // and position-level constraint equations.
-            udoterrOffset = total_mp + total_mv;
-            udoterrSize = total_ma;
         }
 
         // This way of copying the data avoids a threadsafety issue in
         // CasADi related to cached Sparsity objects.
-        std::copy_n(qerr.getContiguousScalarData(), qerr.size(),
-                kinematic_constraint_errors.ptr());
-        std::copy_n(uerr.getContiguousScalarData() + uerrOffset, uerrSize,
-                kinematic_constraint_errors.ptr() + qerr.size());
-        std::copy_n(udoterr.getContiguousScalarData() + udoterrOffset,
-                udoterrSize,
-                kinematic_constraint_errors.ptr() + qerr.size() + uerrSize);
+        double* errors = kinematic_constraint_errors.ptr();
+        std::copy_n(stateBase.getQErr().getContiguousScalarData(),
+                layout.qerrSize, errors);
+        errors += layout.qerrSize;
+        std::copy_n(stateBase.getUErr().getContiguousScalarData() +
+                            layout.uerrOffset,
+                layout.uerrSize, errors);
+        errors += layout.uerrSize;
+        if (layout.udoterrSize) {
+            std::copy_n(m_pvaerr.getContiguousScalarData() +
+                                layout.udoterrOffset,
+                    layout.udoterrSize, errors);
+        }
     }
 
     void copyImplicitResidualsToOutput(const MocoProblemRep& mocoProblemRep,
@@ -736,12 +759,10 @@ private:
         if (getNumAuxiliaryResidualEquations()) {
             const auto& residualOutputs =
                     mocoProblemRep.getImplicitResidualReferencePtrs();
-            SimTK::Vector auxResiduals((int)residualOutputs.size(), 0.0);
+            double* residuals = auxiliary_residuals.ptr();
             for (int i = 0; i < (int)residualOutputs.size(); ++i) {
-                auxResiduals[i] = residualOutputs[i]->getValue(state);
+                residuals[i] = residualOutputs[i]->getValue(state);
             }
-            std::copy_n(auxResiduals.getContiguousScalarData(),
-                    auxResiduals.size(), auxiliary_residuals.ptr());
         }
     }
 
@@ -749,6 +770,24 @@ private:
     bool m_paramsRequireInitSystem = true;
     std::string m_formattedTimeString;
     std::unordered_map<int, int> m_yIndexMap;
+    /// The index in Q of each coordinate state (in the order of the states).
+    std::vector<int> m_coordinateQIndices;
+    /// True if m_coordinateQIndices is 0, 1, 2, ... (Q has no empty slots), in
+    /// which case the coordinates are copied into Q as a block.
+    bool m_coordinateQIndicesAreContiguous = false;
+    /// Where the kinematic constraint errors come from in Simbody's QErr,
+    /// UErr, and UDotErr, computed once in the constructor. If constraint
+    /// derivatives are not enforced, the UErr and UDotErr entries for the
+    /// derivatives of the position- (and velocity-) level equations are
+    /// skipped.
+    struct KinematicConstraintErrorLayout {
+        int qerrSize = 0;
+        int uerrOffset = 0;
+        int uerrSize = 0;
+        int udoterrOffset = 0;
+        int udoterrSize = 0;
+    };
+    KinematicConstraintErrorLayout m_kinematicConstraintErrorLayout;
     std::vector<int> m_modelControlIndices;
     std::unique_ptr<FileDeletionThrower> m_fileDeletionThrower;
     // Local memory to hold constraint forces.
@@ -48,6 +48,17 @@ namespace OpenSim {
 /// including model kinematic constraints, the 'hermite-simpson' option is
 /// required (see Kinematic constraints section below).
 ///
+/// MocoCasADiSolver also supports pseudospectral (orthogonal collocation)
+/// schemes, 'legendre-gauss-radau-#' and 'legendre-gauss-lobatto-#', where #
+/// is the degree (1-9) of the polynomial that approximates the states within
+/// each mesh interval. Each mesh interval contains # grid points (in addition
+/// to the mesh interval start point), and the accuracy of these schemes
+/// increases rapidly with the degree, so fewer mesh intervals are needed than
+/// for 'hermite-simpson' (e.g., 'legendre-gauss-radau-3' with 25 mesh
+/// intervals rather than 'hermite-simpson' with 100). Path constraints are
+/// enforced only at the mesh points, and these schemes do not support
+/// enforcing kinematic constraint derivatives.
+///
 /// Path constraints on controls with Hermite-Simpson transcription
 /// ---------------------------------------------------------------
 /// For Hermite-Simpson transcription, the direct collocation solvers enforce
@@ -98,7 +109,10 @@ public:
             "2 for output from CasADi and the underlying solver (default: 2).");
     OpenSim_DECLARE_PROPERTY(transcription_scheme, std::string,
             "'trapezoidal' for trapezoidal transcription, or 'hermite-simpson' "
-            "(default) for separated Hermite-Simpson transcription.");
+            "(default) for separated Hermite-Simpson transcription. "
+            "MocoCasADiSolver also supports 'legendre-gauss-radau-#' and "
+            "'legendre-gauss-lobatto-#', where # is the polynomial degree "
+            "(1-9).");
     OpenSim_DECLARE_PROPERTY(interpolate_control_midpoints, bool,
             "If the transcription scheme is set to 'hermite-simpson', then "
             "enable this property to constrain the control values at mesh "
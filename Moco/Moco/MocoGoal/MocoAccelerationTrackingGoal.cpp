@@ -87,7 +87,7 @@ void MocoAccelerationTrackingGoal::initializeOnModelImpl(
         m_acceleration_weights.push_back(weight);
     }
 
-    m_ref_splines = GCVSplineSet(accelerationTable.flatten(
+    m_ref_splines = createGCVSplineSetReusingFits(accelerationTable.flatten(
         {"/acceleration_x", "/acceleration_y", "/acceleration_z"}));
 
     setRequirements(1, 1);
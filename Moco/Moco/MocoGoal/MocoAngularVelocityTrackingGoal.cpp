@@ -128,8 +128,9 @@ void MocoAngularVelocityTrackingGoal::initializeOnModelImpl(
         m_angular_velocity_weights.push_back(weight);
     }
 
-    m_ref_splines = GCVSplineSet(angularVelocityTable.flatten(
-        {"/angular_velocity_x", "/angular_velocity_y", "/angular_velocity_z"}));
+    m_ref_splines = createGCVSplineSetReusingFits(
+            angularVelocityTable.flatten({"/angular_velocity_x",
+                    "/angular_velocity_y", "/angular_velocity_z"}));
 
     setRequirements(1, 1, SimTK::Stage::Velocity);
 }
@@ -17,6 +17,9 @@
  * -------------------------------------------------------------------------- */
 
 #include "MocoContactTrackingGoal.h"
+
+#include "../MocoUtilities.h"
+
 #include "OpenSim/Simulation/Model/SmoothSphereHalfSpaceForce.h"
 
 using namespace OpenSim;
@@ -101,7 +104,7 @@ void MocoContactTrackingGoal::initializeOnModelImpl(const Model& model) const {
     const std::string dataFilePath = getAbsolutePathnameFromXMLDocument(
             extLoads->getDocumentFileName(), extLoads->getDataFileName());
     TimeSeriesTable data(dataFilePath);
-    GCVSplineSet allRefSplines(data);
+    GCVSplineSet allRefSplines = createGCVSplineSetReusingFits(data);
 
     // Each ExternalForce has an applied_to_body property. For the ExternalForce
     // to be properly paired with a group of contact force components, the
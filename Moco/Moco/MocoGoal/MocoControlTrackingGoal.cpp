@@ -82,7 +82,7 @@ void MocoControlTrackingGoal::initializeOnModelImpl(const Model& model) const {
     checkRedundantLabels(tableToUse.getColumnLabels());
 
     // Convert data table to spline set.
-    auto allSplines = GCVSplineSet(tableToUse);
+    auto allSplines = createGCVSplineSetReusingFits(tableToUse);
 
     if (!controlsToTrack.empty()) {
         // The goal is in 'manual' labeling mode; perform error-checking.
@@ -17,6 +17,8 @@
  * -------------------------------------------------------------------------- */
 #include "MocoGoal.h"
 
+#include <OpenSim/Simulation/Model/Model.h>
+
 using namespace OpenSim;
 
 MocoGoal::MocoGoal() {
@@ -42,10 +44,70 @@ void MocoGoal::printDescription() const {
     if (mode == "cost") {
         str += fmt::format(", weight: {}", get_weight());
     }
+    if (getIsZeroWeightCost()) {
+        str += " (not evaluated)";
+    } else if (m_stageDependencyBeforeAudit != SimTK::Stage::Empty) {
+        str += fmt::format(", stage dependency: {} (lowered from {})",
+                m_stageDependency.getName(),
+                m_stageDependencyBeforeAudit.getName());
+    }
     log_cout(str);
     printDescriptionImpl();
 }
 
+void MocoGoal::auditStageDependency(
+        const SimTK::State& state, const SimTK::Vector& controls) const {
+    if (!get_enabled() || !m_stageDependencyIsDefault) return;
+    if (m_stageDependency <= SimTK::Stage::Time) return;
+    const SimTK::System& system = getModel().getSystem();
+    // Evaluate the goal with the state realized to increasingly high stages.
+    // Evaluating the goal fails (with a stage exception, which we catch) if
+    // it requires quantities from a stage that it does not realize itself
+    // (e.g., body positions for a goal that does not call
+    // realizePosition()); other errors propagate. The lowest stage at which
+    // evaluating the goal succeeds, or the stage to which the goal realizes
+    // the state if that is higher, suffices. State variables (and controls
+    // and parameters) may be used without realizing, so we never go below
+    // SimTK::Stage::Time.
+    for (SimTK::Stage stage = SimTK::Stage::Instance;
+            stage < m_stageDependency; stage = stage.next()) {
+        SimTK::State initialState(state);
+        initialState.invalidateAllCacheAtOrAbove(stage.next());
+        system.realize(initialState, stage);
+        SimTK::State finalState(initialState);
+        SimTK::Stage required = std::max(stage, SimTK::Stage::Time);
+        try {
+            if (m_numIntegrals) {
+                SimTK::Real integrand = 0;
+                calcIntegrandImpl(
+                        {initialState.getTime(), initialState, controls},
+                        integrand);
+                required = std::max(required, initialState.getSystemStage());
+            }
+            SimTK::State goalInitialState(initialState);
+            goalInitialState.invalidateAllCacheAtOrAbove(stage.next());
+            SimTK::Vector goal(getNumOutputs(), 0.0);
+            const double integral = 0;
+            calcGoalImpl({goalInitialState.getTime(), goalInitialState,
+                                 controls, finalState.getTime(), finalState,
+                                 controls, integral},
+                    goal);
+            required = std::max(required,
+                    std::max(goalInitialState.getSystemStage(),
+                            finalState.getSystemStage()));
+        } catch (const SimTK::Exception::StageTooLow&) {
+            continue;
+        } catch (const SimTK::Exception::CacheEntryOutOfDate&) {
+            continue;
+        }
+        if (required < m_stageDependency) {
+            m_stageDependencyBeforeAudit = m_stageDependency;
+            m_stageDependency = required;
+        }
+        return;
+    }
+}
+
 double MocoGoal::calcSystemDisplacement(const SimTK::State& initialState,
         const SimTK::State& finalState) const {
     const SimTK::Vec3 comInitial =
@@ -67,6 +67,19 @@ class Model;
 ///     used to compute acceleration-dependent quantities, such as body
 ///     accelerations and joint reactions.
 ///
+/// If a goal does not specify a stage dependency (see setRequirements()),
+/// solvers audit the goal before solving: the goal is evaluated with states
+/// realized to increasingly high stages, and the goal uses the lowest stage
+/// at which it can be evaluated (at least SimTK::Stage::Time), considering
+/// any stages to which the goal itself realizes the state. The audit
+/// evaluates the goal at a single state, so if the quantities that the goal
+/// uses depend on the state (e.g., the goal computes accelerations only in
+/// some configurations), specify the stage dependency explicitly; otherwise,
+/// evaluating the goal during the solve throws an exception. The results of
+/// the audit are printed in the problem description. A cost with a weight of
+/// 0 does not affect the objective, so it has a stage dependency of
+/// SimTK::Stage::Topology and is not evaluated.
+///
 /// @par For developers
 /// Every time the problem is solved, a copy of this goal is used. An individual
 /// instance of a goal is only ever used in a single problem. Therefore, there
@@ -178,20 +191,21 @@ public:
     /// calcCost(). If getNumIntegrals() is not zero, this must be implemented.
     SimTK::Real calcIntegrand(const IntegrandInput& input) const {
         double integrand = 0;
-        if (!get_enabled()) { return integrand; }
+        if (!get_enabled() || getIsZeroWeightCost()) { return integrand; }
         const SimTK::Stage stageBefore = input.state.getSystemStage();
 
         calcIntegrandImpl(input, integrand);
 
         if (input.state.getSystemStage() > stageBefore) {
-            SimTK_ERRCHK2_ALWAYS(
+            SimTK_ERRCHK3_ALWAYS(
                     input.state.getSystemStage() <= m_stageDependency,
                     (getConcreteClassName() + "::calcIntegrand()").c_str(),
                     "This goal has a stage dependency of %s, but "
                     "calcIntegrandImpl() exceeded this stage by realizing "
-                    "to %s.",
+                    "to %s.%s",
                     m_stageDependency.getName().c_str(),
-                    input.state.getSystemStage().getName().c_str());
+                    input.state.getSystemStage().getName().c_str(),
+                    getAuditAdvice().c_str());
         }
         return integrand;
     }
@@ -215,7 +229,7 @@ public:
     void calcGoal(const GoalInput& input, SimTK::Vector& goal) const {
         goal.resize(getNumOutputs());
         goal = 0;
-        if (!get_enabled()) { return; }
+        if (!get_enabled() || getIsZeroWeightCost()) { return; }
         const SimTK::Stage initialStageBefore =
                 input.initial_state.getSystemStage();
         const SimTK::Stage finalStageBefore =
@@ -224,24 +238,26 @@ public:
         calcGoalImpl(input, goal);
 
         if (input.initial_state.getSystemStage() > initialStageBefore) {
-            SimTK_ERRCHK2_ALWAYS(
+            SimTK_ERRCHK3_ALWAYS(
                     input.initial_state.getSystemStage() <= m_stageDependency,
                     (getConcreteClassName() + "::calcGoal()").c_str(),
                     "This goal has a stage dependency of %s, but "
                     "calcGoalImpl() exceeded this stage by realizing "
-                    "initial_state to %s.",
+                    "initial_state to %s.%s",
                     m_stageDependency.getName().c_str(),
-                    input.initial_state.getSystemStage().getName().c_str());
+                    input.initial_state.getSystemStage().getName().c_str(),
+                    getAuditAdvice().c_str());
         }
         if (input.final_state.getSystemStage() > finalStageBefore) {
-            SimTK_ERRCHK2_ALWAYS(
+            SimTK_ERRCHK3_ALWAYS(
                     input.final_state.getSystemStage() <= m_stageDependency,
                     (getConcreteClassName() + "::calcGoal()").c_str(),
                     "This goal has a stage dependency of %s, but "
                     "calcGoalImpl() exceeded this stage by realizing "
-                    "final_state to %s.",
+                    "final_state to %s.%s",
                     m_stageDependency.getName().c_str(),
-                    input.final_state.getSystemStage().getName().c_str());
+                    input.final_state.getSystemStage().getName().c_str(),
+                    getAuditAdvice().c_str());
         }
         goal *= m_weightToUse;
     }
@@ -270,12 +286,28 @@ public:
             m_weightToUse = get_weight();
         }
 
+        m_stageDependencyBeforeAudit = SimTK::Stage::Empty;
         initializeOnModelImpl(model);
 
         OPENSIM_THROW_IF_FRMOBJ(m_numIntegrals == -1, Exception,
                 "Expected setRequirements() to be invoked, "
                 "but it was not.");
+        if (getIsZeroWeightCost()) {
+            m_stageDependency = SimTK::Stage::Topology;
+        }
     }
+    /// For use by solvers, after initializeOnModel(). If the goal did not
+    /// specify a stage dependency, lower its stage dependency to the lowest
+    /// stage at which the goal can be evaluated (see the class description).
+    /// The goal is evaluated with copies of the provided state (which must
+    /// be compatible with the model passed to initializeOnModel()) and
+    /// controls. The audit only exercises the branches of the goal that the
+    /// provided state reaches; if the goal later realizes a state beyond the
+    /// lowered stage dependency, calcIntegrand() and calcGoal() throw an
+    /// exception. Exceptions other than those caused by a state that is not
+    /// realized to a sufficient stage are not caught by the audit.
+    void auditStageDependency(
+            const SimTK::State& state, const SimTK::Vector& controls) const;
 
     /// Print the name type and mode of this goal. In cost mode, this prints the
     /// weight.
@@ -301,15 +333,17 @@ protected:
     /// IntegrandInput and GoalInput for force calculations.
     /// See the MocoGoal class description for help with choosing the stage
     /// dependency.
-    /// If you are not sure what your stageDependency is, leave it as
-    /// SimTK::Stage::Acceleration to be safe.
+    /// If you are not sure what your stageDependency is, omit it; the
+    /// stage dependency is then SimTK::Stage::Acceleration, but solvers may
+    /// lower it after evaluating the goal (see the class description).
+    /// Provide SimTK::Stage::Acceleration explicitly to prevent this.
     ///
     /// You must still realize to the appropriate stage within the
     /// integrand and goal functions. Setting the stageDependency to stage X
     /// does not mean that the SimTK::State is realized to stage X as a
     /// precondition of calcIntegrandImpl() and calcGoalImpl().
     void setRequirements(int numIntegrals, int numOutputs,
-            SimTK::Stage stageDependency = SimTK::Stage::Acceleration) const {
+            SimTK::Stage stageDependency) const {
         OPENSIM_THROW_IF(numIntegrals < 0 || numIntegrals > 1, Exception,
                 "Number of integrals must be 0 or 1.");
         OPENSIM_THROW_IF(numOutputs < 0, Exception,
@@ -318,6 +352,12 @@ protected:
         const_cast<MocoGoal*>(this)->upd_MocoConstraintInfo().setNumEquations(
                 numOutputs);
         m_stageDependency = stageDependency;
+        m_stageDependencyIsDefault = false;
+    }
+    /// Set the requirements without specifying the stage dependency.
+    void setRequirements(int numIntegrals, int numOutputs) const {
+        setRequirements(numIntegrals, numOutputs, SimTK::Stage::Acceleration);
+        m_stageDependencyIsDefault = true;
     }
 
     virtual Mode getDefaultModeImpl() const { return Mode::Cost; }
@@ -363,6 +403,21 @@ private:
 
     void constructProperties();
 
+    bool getIsZeroWeightCost() const {
+        return m_modeToUse == Mode::Cost && m_weightToUse == 0;
+    }
+
+    /// Advice for the exception thrown when the goal exceeds its stage
+    /// dependency, if the audit lowered the stage dependency.
+    std::string getAuditAdvice() const {
+        if (m_stageDependencyBeforeAudit == SimTK::Stage::Empty) return "";
+        return " This stage dependency was lowered from " +
+               m_stageDependencyBeforeAudit.getName() +
+               " by auditing the goal at a single state, which may not "
+               "exercise all branches of the goal. Specify the stage "
+               "dependency explicitly in setRequirements().";
+    }
+
     void checkMode(const std::string& mode) const {
         OPENSIM_THROW_IF_FRMOBJ(mode != "cost" && mode != "endpoint_constraint",
                 Exception,
@@ -376,6 +431,10 @@ private:
     mutable double m_weightToUse;
     mutable Mode m_modeToUse;
     mutable SimTK::Stage m_stageDependency = SimTK::Stage::Acceleration;
+    mutable bool m_stageDependencyIsDefault = false;
+    /// If the audit lowered the stage dependency, this is the stage
+    /// dependency before the audit; otherwise, SimTK::Stage::Empty.
+    mutable SimTK::Stage m_stageDependencyBeforeAudit = SimTK::Stage::Empty;
     mutable int m_numIntegrals = -1;
 };
 
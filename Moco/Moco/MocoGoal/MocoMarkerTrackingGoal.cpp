@@ -76,8 +76,8 @@ void MocoMarkerTrackingGoal::initializeOnModelImpl(const Model& model) const {
     // Get and flatten TimeSeriesTableVec3 to doubles and create a set of
     // reference splines, one for each component of the coordinate
     // trajectories.
-    m_refsplines =
-            GCVSplineSet(get_markers_reference().getMarkerTable().flatten());
+    m_refsplines = createGCVSplineSetReusingFits(
+            get_markers_reference().getMarkerTable().flatten());
 
     setRequirements(1, 1, SimTK::Stage::Position);
 }
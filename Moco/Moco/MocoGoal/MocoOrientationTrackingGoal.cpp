@@ -161,7 +161,7 @@ void MocoOrientationTrackingGoal::initializeOnModelImpl(const Model& model)
     flatTable.updMatrix() = mat;
     flatTable.setColumnLabels(colLabels);
 
-    m_ref_splines = GCVSplineSet(flatTable);
+    m_ref_splines = createGCVSplineSetReusingFits(flatTable);
 
     setRequirements(1, 1, SimTK::Stage::Position);
 }
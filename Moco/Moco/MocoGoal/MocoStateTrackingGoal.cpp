@@ -29,7 +29,7 @@ void MocoStateTrackingGoal::initializeOnModelImpl(const Model& model) const {
     // TODO: set relativeToDirectory properly.
     TimeSeriesTable tableToUse = get_reference().process("", &model);
 
-    auto allSplines = GCVSplineSet(tableToUse);
+    auto allSplines = createGCVSplineSetReusingFits(tableToUse);
 
     // Check that there are no redundant columns in the reference data.
     checkRedundantLabels(tableToUse.getColumnLabels());
@@ -128,7 +128,7 @@ void MocoTranslationTrackingGoal::initializeOnModelImpl(const Model& model)
         m_translation_weights.push_back(weight);
     }
 
-    m_ref_splines = GCVSplineSet(translationTable.flatten(
+    m_ref_splines = createGCVSplineSetReusingFits(translationTable.flatten(
         {"/position_x", "/position_y", "/position_z"}));
 
     setRequirements(1, 1, SimTK::Stage::Position);
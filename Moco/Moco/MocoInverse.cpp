@@ -24,11 +24,227 @@
 #include "MocoGoal/MocoInitialActivationGoal.h"
 #include "MocoGoal/MocoSumSquaredStateGoal.h"
 #include "MocoProblem.h"
+#include "MocoProblemRep.h"
 #include "MocoStudy.h"
 #include "MocoUtilities.h"
+#include <limits>
+#include <regex>
+#include <thread>
+
+#include <OpenSim/Common/Logger.h>
 
 using namespace OpenSim;
 
+namespace {
+
+/// The number of threads with which to perform numTasks independent tasks,
+/// from the OPENSIM_MOCO_PARALLEL environment variable (all cores by
+/// default).
+int getNumThreads(int numTasks) {
+    int parallel = getMocoParallelEnvironmentVariable();
+    if (parallel == -1) parallel = 1;
+    const int numThreads = parallel == 1
+                                   ? (int)std::thread::hardware_concurrency()
+                                   : parallel;
+    return std::max(1, std::min(numThreads, numTasks));
+}
+
+/// Concatenate points from multiple time windows: point i of the result is
+/// point windowAndIndex[i].second of window windowAndIndex[i].first. The
+/// result must initially have the same variables as the windows.
+void stitchWindows(const std::vector<MocoSolution>& windows,
+        const std::vector<std::pair<int, int>>& windowAndIndex,
+        MocoTrajectory& result) {
+    const int numTimes = (int)windowAndIndex.size();
+    auto gather = [&](const SimTK::Matrix& (MocoTrajectory::*getTrajectory)()
+                                  const,
+                          int icol) {
+        SimTK::Vector values(numTimes);
+        for (int itime = 0; itime < numTimes; ++itime) {
+            const auto& window = windows[windowAndIndex[itime].first];
+            values[itime] = (window.*getTrajectory)()(
+                    windowAndIndex[itime].second, icol);
+        }
+        return values;
+    };
+    result.setNumTimes(numTimes);
+    SimTK::Vector time(numTimes);
+    for (int itime = 0; itime < numTimes; ++itime) {
+        time[itime] = windows[windowAndIndex[itime].first]
+                              .getTime()[windowAndIndex[itime].second];
+    }
+    result.setTime(time);
+    const auto& stateNames = result.getStateNames();
+    for (int i = 0; i < (int)stateNames.size(); ++i) {
+        result.setState(stateNames[i],
+                gather(&MocoTrajectory::getStatesTrajectory, i));
+    }
+    const auto& controlNames = result.getControlNames();
+    for (int i = 0; i < (int)controlNames.size(); ++i) {
+        result.setControl(controlNames[i],
+                gather(&MocoTrajectory::getControlsTrajectory, i));
+    }
+    const auto& multiplierNames = result.getMultiplierNames();
+    for (int i = 0; i < (int)multiplierNames.size(); ++i) {
+        result.setMultiplier(multiplierNames[i],
+                gather(&MocoTrajectory::getMultipliersTrajectory, i));
+    }
+    const auto& derivativeNames = result.getDerivativeNames();
+    for (int i = 0; i < (int)derivativeNames.size(); ++i) {
+        result.setDerivative(derivativeNames[i],
+                gather(&MocoTrajectory::getDerivativesTrajectory, i));
+    }
+    const auto& slackNames = result.getSlackNames();
+    for (int i = 0; i < (int)slackNames.size(); ++i) {
+        result.setSlack(slackNames[i],
+                gather(&MocoTrajectory::getSlacksTrajectory, i));
+    }
+}
+
+/// Create a matrix whose columns are an orthonormal basis for the orthogonal
+/// complement of the range of B (that is, the null space of B^T).
+SimTK::Matrix createComplementOfRange(const SimTK::Matrix& B) {
+    const int n = B.nrow();
+    std::vector<SimTK::Vector> basis;
+    // Gram-Schmidt, with reorthogonalization for numerical stability.
+    auto orthogonalize = [&](SimTK::Vector v) {
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const auto& q : basis) {
+                double projection = 0;
+                for (int i = 0; i < n; ++i) projection += q[i] * v[i];
+                v -= projection * q;
+            }
+        }
+        return v;
+    };
+    for (int j = 0; j < B.ncol(); ++j) {
+        const SimTK::Vector column = B.col(j);
+        const SimTK::Vector v = orthogonalize(column);
+        const double norm = v.norm();
+        // Skip linearly dependent columns.
+        if (norm > 1e-10 * std::max(1.0, column.norm())) {
+            basis.push_back(v / norm);
+        }
+    }
+    const int rank = (int)basis.size();
+    for (int i = 0; i < n && (int)basis.size() < n; ++i) {
+        SimTK::Vector unit(n, 0.0);
+        unit[i] = 1;
+        const SimTK::Vector v = orthogonalize(unit);
+        const double norm = v.norm();
+        if (norm > 1e-6) basis.push_back(v / norm);
+    }
+    SimTK::Matrix complement(n, (int)basis.size() - rank);
+    for (int j = rank; j < (int)basis.size(); ++j) {
+        complement.updCol(j - rank) = basis[j];
+    }
+    return complement;
+}
+
+/// Solve the convex quadratic program
+///     minimize    sum_i weights[i] * x[i]^2
+///     subject to  A x = b,  lower <= x <= upper
+/// (with positive weights) using a semismooth Newton method on its dual. For
+/// multipliers y of A x = b, the minimizing x is
+/// x(y) = clamp(A^T y / (2 weights), lower, upper), and the (concave) dual
+/// function is maximized where A x(y) = b. On input, y is the initial guess
+/// for the multipliers (e.g., those from the previous time point); on
+/// output, it holds the final multipliers. Returns the largest violation of
+/// A x = b, which exceeds the tolerance if the problem is infeasible.
+double solveBoundedLeastNorm(const SimTK::Matrix& A, const SimTK::Vector& b,
+        const SimTK::Vector& weights, const SimTK::Vector& lower,
+        const SimTK::Vector& upper, double tolerance, int maxIterations,
+        SimTK::Vector& y, SimTK::Vector& x) {
+    const int m = A.nrow();
+    const int n = A.ncol();
+    if (y.size() != m) {
+        y.resize(m);
+        y.setToZero();
+    }
+    // The unclamped minimizer A^T y / (2 weights).
+    SimTK::Vector unclamped(n);
+    auto calcPrimal = [&]() {
+        unclamped = ~A * y;
+        x.resize(n);
+        for (int i = 0; i < n; ++i) {
+            unclamped[i] /= 2 * weights[i];
+            x[i] = SimTK::clamp(lower[i], unclamped[i], upper[i]);
+        }
+    };
+
+    calcPrimal();
+    // The residual is the gradient of the dual function.
+    SimTK::Vector residual = b - A * x;
+    double violation = m ? residual.normInf() : 0;
+    SimTK::Matrix hessian(m, m);
+    SimTK::Vector step;
+    for (int iter = 0; iter < maxIterations && violation > tolerance;
+            ++iter) {
+        // The generalized Hessian of the negated dual function, A D A^T,
+        // where D is 1 / (2 weights) for the elements of x that are not
+        // clamped and 0 otherwise. The regularization keeps the Hessian
+        // nonsingular if many elements are clamped.
+        hessian.setToZero();
+        for (int i = 0; i < n; ++i) {
+            if (unclamped[i] < lower[i] || unclamped[i] > upper[i]) continue;
+            const double d = 1 / (2 * weights[i]);
+            for (int r = 0; r < m; ++r) {
+                const double dA = d * A(r, i);
+                for (int c = 0; c < m; ++c) hessian(r, c) += dA * A(c, i);
+            }
+        }
+        double maxDiagonal = 1;
+        for (int j = 0; j < m; ++j) {
+            maxDiagonal = std::max(maxDiagonal, hessian(j, j));
+        }
+        for (int j = 0; j < m; ++j) hessian(j, j) += 1e-10 * maxDiagonal;
+        SimTK::FactorLU lu(hessian);
+        lu.solve(residual, step);
+
+        // Exact line search. Along the step, the dual function is concave
+        // and piecewise quadratic, so we find the root of its derivative
+        // (decreasing and piecewise linear) by bisection. This is much more
+        // robust than backtracking when many bounds are active.
+        const SimTK::Vector stepInPrimal = ~A * step;
+        double bDotStep = 0;
+        for (int j = 0; j < m; ++j) bDotStep += b[j] * step[j];
+        auto calcSlope = [&](double alpha) {
+            double slope = bDotStep;
+            for (int i = 0; i < n; ++i) {
+                slope -= stepInPrimal[i] *
+                         SimTK::clamp(lower[i],
+                                 unclamped[i] + alpha * stepInPrimal[i] /
+                                                        (2 * weights[i]),
+                                 upper[i]);
+            }
+            return slope;
+        };
+        double alphaLower = 0;
+        double alphaUpper = 1;
+        for (int k = 0; k < 60 && calcSlope(alphaUpper) > 0; ++k) {
+            alphaUpper *= 2;
+        }
+        // If the dual function is still increasing, the problem is
+        // infeasible; we take the largest step.
+        if (calcSlope(alphaUpper) > 0) alphaLower = alphaUpper;
+        while (alphaUpper - alphaLower > 1e-14 * alphaUpper) {
+            const double alpha = 0.5 * (alphaLower + alphaUpper);
+            if (calcSlope(alpha) > 0) {
+                alphaLower = alpha;
+            } else {
+                alphaUpper = alpha;
+            }
+        }
+        y += 0.5 * (alphaLower + alphaUpper) * step;
+        calcPrimal();
+        residual = b - A * x;
+        violation = residual.normInf();
+    }
+    return violation;
+}
+
+} // anonymous namespace
+
 void MocoInverse::constructProperties() {
 
     constructProperty_kinematics(TableProcessor());
@@ -39,11 +255,15 @@ void MocoInverse::constructProperties() {
     constructProperty_constraint_tolerance(1e-3);
     constructProperty_output_paths();
     constructProperty_reserves_weight(1.0);
+    constructProperty_num_time_windows(1);
+    constructProperty_time_window_margin(0.2);
+    constructProperty_static_optimization(false);
 }
 
 MocoStudy MocoInverse::initialize() const { return initializeInternal().first; }
 
-std::pair<MocoStudy, TimeSeriesTable> MocoInverse::initializeInternal() const {
+std::pair<MocoStudy, std::unique_ptr<PositionMotion>>
+MocoInverse::initializeInternal() const {
 
     // Process inputs.
     // ----------------
@@ -116,17 +336,30 @@ std::pair<MocoStudy, TimeSeriesTable> MocoInverse::initializeInternal() const {
         solver.set_optim_max_iterations(get_max_iterations());
     }
     return std::make_pair(
-            study, posmotPtr->exportToTable(kinematics.getIndependentColumn()));
+            study, std::unique_ptr<PositionMotion>(posmotPtr->clone()));
 }
 
 MocoInverseSolution MocoInverse::solve() const {
-    std::pair<MocoStudy, TimeSeriesTable> init = initializeInternal();
+    std::pair<MocoStudy, std::unique_ptr<PositionMotion>> init =
+            initializeInternal();
     const auto& study = init.first;
 
-    MocoSolution mocoSolution = study.solve().unseal();
+    checkPropertyInRangeOrSet(*this, getProperty_num_time_windows(), 1,
+            std::numeric_limits<int>::max(), {});
+    MocoSolution mocoSolution;
+    if (get_static_optimization()) {
+        mocoSolution = solveStaticOptimization(study);
+    } else if (get_num_time_windows() > 1) {
+        mocoSolution = solveTimeWindows(study);
+    } else {
+        mocoSolution = study.solve().unseal();
+    }
 
-    const auto& statesTrajTable = init.second;
-    mocoSolution.insertStatesTrajectory(statesTrajTable);
+    // Evaluate the prescribed kinematics at the solution's times, so that
+    // inserting them copies columns rather than fitting splines.
+    const SimTK::Vector& time = mocoSolution.getTime();
+    mocoSolution.insertStatesTrajectory(init.second->exportToTable(
+            std::vector<double>(&time[0], &time[0] + time.size())));
     MocoInverseSolution solution;
     solution.setMocoSolution(mocoSolution);
 
@@ -143,3 +376,336 @@ MocoInverseSolution MocoInverse::solve() const {
     }
     return solution;
 }
+
+MocoSolution MocoInverse::solveTimeWindows(const MocoStudy& study) const {
+    const Stopwatch stopwatch;
+    checkPropertyInRangeOrSet(*this, getProperty_time_window_margin(), 0.0,
+            SimTK::NTraits<double>::getInfinity(), {});
+
+    const auto& problem = study.getProblem();
+    const double initialTime = problem.getTimeInitialBounds().getLower();
+    const double finalTime = problem.getTimeFinalBounds().getLower();
+    const int numWindows = get_num_time_windows();
+    const double windowDuration = (finalTime - initialTime) / numWindows;
+    const double margin = get_time_window_margin();
+    const int numMeshIntervals =
+            dynamic_cast<const MocoCasADiSolver&>(study.getSolver())
+                    .get_num_mesh_intervals();
+
+    // Window iw keeps its points in [keepTimes[iw], keepTimes[iw + 1]).
+    std::vector<double> keepTimes(numWindows + 1);
+    for (int iw = 0; iw < numWindows; ++iw) {
+        keepTimes[iw] = initialTime + iw * windowDuration;
+    }
+    keepTimes[numWindows] = finalTime;
+    std::vector<double> startTimes(numWindows);
+    std::vector<double> endTimes(numWindows);
+    std::vector<int> windowNumMeshIntervals(numWindows);
+    std::vector<MocoStudy> studies(numWindows, study);
+    for (int iw = 0; iw < numWindows; ++iw) {
+        startTimes[iw] = std::max(initialTime, keepTimes[iw] - margin);
+        endTimes[iw] = std::min(finalTime, keepTimes[iw + 1] + margin);
+        auto& windowStudy = studies[iw];
+        windowStudy.set_write_solution("false");
+        windowStudy.updProblem().setTimeBounds(startTimes[iw], endTimes[iw]);
+        auto& solver = windowStudy.updSolver<MocoCasADiSolver>();
+        windowNumMeshIntervals[iw] = std::max(1,
+                (int)std::ceil(numMeshIntervals *
+                               (endTimes[iw] - startTimes[iw]) /
+                               (finalTime - initialTime)));
+        solver.set_num_mesh_intervals(windowNumMeshIntervals[iw]);
+        solver.set_parallel(0);
+        solver.set_verbosity(0);
+    }
+
+    const int numThreads = getNumThreads(numWindows);
+    log_info("MocoInverse: solving {} time windows using {} thread(s).",
+            numWindows, numThreads);
+
+    // The logger level is global, so the windows must not change it.
+    Logger::Level origLoggerLevel = Logger::getLevel();
+    Logger::setLevel(Logger::Level::Warn);
+
+    // The windows are solved in two waves: first, the even-numbered windows
+    // and the last window, from the solver's default guess; then, the
+    // remaining windows, each warm-started from the solutions of its two
+    // neighbors (which are in the first wave). Within each wave, the windows
+    // do not depend on each other, so the solution does not depend on the
+    // order in which the threads solve the windows.
+    std::vector<int> firstWave;
+    std::vector<int> secondWave;
+    for (int iw = 0; iw < numWindows; ++iw) {
+        if (iw % 2 == 0 || iw == numWindows - 1) {
+            firstWave.push_back(iw);
+        } else {
+            secondWave.push_back(iw);
+        }
+    }
+    std::vector<MocoSolution> windows(numWindows);
+    auto solveWindow = [&](int iw) {
+        auto& windowStudy = studies[iw];
+        auto& solver = windowStudy.updSolver<MocoCasADiSolver>();
+        solver.resetProblem(windowStudy.getProblem());
+        const bool isSecondWave = iw % 2 == 1 && iw < numWindows - 1;
+        if (isSecondWave && windows[iw - 1].success() &&
+                windows[iw + 1].success()) {
+            const auto& previous = windows[iw - 1];
+            const auto& next = windows[iw + 1];
+            // Use the previous window up to its end, and the next window
+            // afterwards; the guess is interpolated between the windows if
+            // they do not overlap.
+            std::vector<std::pair<int, int>> windowAndIndex;
+            const auto& previousTime = previous.getTime();
+            for (int itime = 0; itime < previousTime.size(); ++itime) {
+                windowAndIndex.emplace_back(iw - 1, itime);
+            }
+            const double previousEnd = previousTime[previousTime.size() - 1];
+            const auto& nextTime = next.getTime();
+            for (int itime = 0; itime < nextTime.size(); ++itime) {
+                if (nextTime[itime] > previousEnd) {
+                    windowAndIndex.emplace_back(iw + 1, itime);
+                }
+            }
+            MocoTrajectory guess = previous;
+            stitchWindows(windows, windowAndIndex, guess);
+            guess.resample(createVectorLinspace(windowNumMeshIntervals[iw] + 1,
+                    startTimes[iw], endTimes[iw]));
+            solver.setGuess(std::move(guess));
+        }
+        windows[iw] = windowStudy.solve().unseal();
+    };
+    try {
+        for (const auto* wave : {&firstWave, &secondWave}) {
+            runTasksInParallel((int)wave->size(),
+                    std::min(numThreads, (int)wave->size()),
+                    [&](int itask) { solveWindow((*wave)[itask]); });
+        }
+    } catch (...) {
+        Logger::setLevel(origLoggerLevel);
+        throw;
+    }
+    Logger::setLevel(origLoggerLevel);
+
+    // Stitch the windows, discarding the margins.
+    std::vector<std::pair<int, int>> windowAndIndex;
+    for (int iw = 0; iw < numWindows; ++iw) {
+        const auto& time = windows[iw].getTime();
+        for (int itime = 0; itime < time.size(); ++itime) {
+            if ((iw == 0 || time[itime] >= keepTimes[iw]) &&
+                    (iw == numWindows - 1 || time[itime] < keepTimes[iw + 1])) {
+                windowAndIndex.emplace_back(iw, itime);
+            }
+        }
+    }
+    MocoSolution solution = windows[0];
+    stitchWindows(windows, windowAndIndex, solution);
+
+    bool success = true;
+    std::string status = windows.back().getStatus();
+    int numIterations = 0;
+    double objective = 0;
+    std::vector<std::pair<std::string, double>> objectiveBreakdown;
+    for (const auto& name : windows[0].getObjectiveTermNames()) {
+        objectiveBreakdown.emplace_back(name, 0);
+    }
+    for (int iw = 0; iw < numWindows; ++iw) {
+        const auto& window = windows[iw];
+        if (success && !window.success()) {
+            success = false;
+            status = fmt::format("Time window {}: {}", iw, window.getStatus());
+        }
+        numIterations += window.getNumIterations();
+        objective += window.getObjective();
+        for (auto& term : objectiveBreakdown) {
+            term.second += window.getObjectiveTerm(term.first);
+        }
+    }
+    solution.setSuccess(success);
+    solution.setStatus(status);
+    solution.setNumIterations(numIterations);
+    solution.setObjective(objective);
+    solution.setObjectiveBreakdown(std::move(objectiveBreakdown));
+    solution.setSolverDuration(stopwatch.getElapsedTime());
+    if (!success) {
+        log_warn("MocoInverse: time windows did NOT succeed: {}", status);
+    }
+    // setSuccess(false) seals the solution; solve() seals it when necessary.
+    solution.unseal();
+    return solution;
+}
+
+MocoSolution MocoInverse::solveStaticOptimization(
+        const MocoStudy& study) const {
+    const Stopwatch stopwatch;
+    const auto& problem = study.getProblem();
+    const auto& solver =
+            dynamic_cast<const MocoCasADiSolver&>(study.getSolver());
+    const MocoProblemRep problemRep = problem.createRep();
+    const int numAuxiliaryStates = problemRep.updStateBase().getNZ();
+    OPENSIM_THROW_IF(numAuxiliaryStates, Exception,
+            "Static optimization requires a model without auxiliary state "
+            "variables (e.g., activations and tendon forces), but the model "
+            "has {}. Consider using ModOpIgnoreActivationDynamics and "
+            "ModOpIgnoreTendonCompliance.",
+            numAuxiliaryStates);
+
+    // The controls are the variables of each static optimization problem.
+    std::vector<int> modelControlIndices;
+    const std::vector<std::string> controlNames = createControlNamesFromModel(
+            problemRep.getModelDisabledConstraints(), modelControlIndices);
+    const int numControls = (int)controlNames.size();
+    SimTK::Vector weights(numControls);
+    SimTK::Vector lower(numControls);
+    SimTK::Vector upper(numControls);
+    const std::regex reservePattern(".*/reserve_.*");
+    for (int ic = 0; ic < numControls; ++ic) {
+        const auto& bounds =
+                problemRep.getControlInfo(controlNames[ic]).getBounds();
+        lower[ic] = bounds.getLower();
+        upper[ic] = bounds.getUpper();
+        weights[ic] = std::regex_match(controlNames[ic], reservePattern)
+                              ? get_reserves_weight()
+                              : 1.0;
+    }
+    // The Lagrange multipliers are in the same order as in the solver.
+    std::vector<std::string> multiplierNames;
+    for (const auto& kcName : problemRep.createKinematicConstraintNames()) {
+        for (const auto& info : problemRep.getMultiplierInfos(kcName)) {
+            multiplierNames.push_back(info.getName());
+        }
+    }
+    const int numMultipliers = (int)multiplierNames.size();
+
+    const int numTimes = solver.get_num_mesh_intervals() + 1;
+    const SimTK::Vector time = createVectorLinspace(numTimes,
+            problem.getTimeInitialBounds().getLower(),
+            problem.getTimeFinalBounds().getLower());
+    const double tolerance = get_constraint_tolerance();
+    const int maxIterations = getProperty_max_iterations().empty()
+                                      ? 100
+                                      : get_max_iterations();
+
+    // Each thread solves a contiguous range of time points, so that each
+    // problem can be warm-started from the previous time point.
+    const int numThreads = getNumThreads(numTimes);
+    log_info("MocoInverse: solving static optimization at {} time points "
+             "using {} thread(s).",
+            numTimes, numThreads);
+    SimTK::Matrix controls(numTimes, numControls);
+    SimTK::Matrix multipliers(numTimes, numMultipliers);
+    SimTK::Vector violations(numTimes);
+    runTasksInParallel(numThreads, numThreads, [&](int ithread) {
+        const MocoProblemRep rep = problem.createRep();
+        const auto& modelBase = rep.getModelBase();
+        auto& stateBase = rep.updStateBase();
+        const auto& model = rep.getModelDisabledConstraints();
+        auto& state = rep.updStateDisabledConstraints();
+        const auto& controller = rep.getDiscreteControllerDisabledConstraints();
+        const auto& matter = model.getMatterSubsystem();
+
+        SimTK::Vector modelControls(model.getNumControls(), 0.0);
+        auto calcResidualForces = [&](SimTK::Vector& residualForces) {
+            controller.setDiscreteControls(state, modelControls);
+            // Make sure the model does not reuse controls it has cached. The
+            // Position-stage calculations (e.g., muscle paths and moment
+            // arms) remain valid.
+            state.invalidateAllCacheAtOrAbove(SimTK::Stage::Velocity);
+            model.realizeAcceleration(state);
+            matter.findMotionForces(state, residualForces);
+        };
+
+        SimTK::Vector passive;
+        SimTK::Vector perControl;
+        SimTK::Matrix controlForces;
+        SimTK::Matrix G;
+        SimTK::Vector dual;
+        SimTK::Vector x;
+        const int begin = ithread * numTimes / numThreads;
+        const int end = (ithread + 1) * numTimes / numThreads;
+        for (int itime = begin; itime < end; ++itime) {
+            state.setTime(time[itime]);
+            model.getSystem().prescribe(state);
+
+            // The generalized forces required to achieve the motion are
+            // affine in the controls: passive + controlForces * controls.
+            modelControls.setToZero();
+            calcResidualForces(passive);
+            controlForces.resize(passive.size(), numControls);
+            for (int ic = 0; ic < numControls; ++ic) {
+                modelControls[modelControlIndices[ic]] = 1;
+                calcResidualForces(perControl);
+                controlForces.updCol(ic) = passive - perControl;
+                modelControls[modelControlIndices[ic]] = 0;
+            }
+
+            // The constraint forces G^T lambda are free, so we enforce the
+            // dynamics only in the complement of the range of G^T.
+            SimTK::Matrix A = controlForces;
+            SimTK::Vector b = passive;
+            SimTK::Matrix nullspace;
+            if (numMultipliers) {
+                stateBase.setTime(time[itime]);
+                modelBase.getSystem().prescribe(stateBase);
+                modelBase.realizeVelocity(stateBase);
+                modelBase.getMatterSubsystem().calcG(stateBase, G);
+                nullspace = createComplementOfRange(~G);
+                A = ~nullspace * controlForces;
+                b = ~nullspace * passive;
+            }
+            violations[itime] = solveBoundedLeastNorm(A, b, weights, lower,
+                    upper, tolerance, maxIterations, dual, x);
+            controls[itime] = ~x;
+
+            if (numMultipliers) {
+                // Residual forces with the solved controls; the constraint
+                // forces must cancel them.
+                const SimTK::Vector remaining = passive - controlForces * x;
+                SimTK::FactorQTZ qtz(~G);
+                SimTK::Vector lambda;
+                qtz.solve(-remaining, lambda);
+                multipliers[itime] = ~lambda;
+            }
+        }
+    });
+
+    MocoSolution solution(time, {}, controlNames, multiplierNames, {}, {},
+            SimTK::Matrix(numTimes, 0), controls, multipliers,
+            SimTK::Matrix(numTimes, 0), SimTK::RowVector());
+
+    // The objective is the integral of the weighted sum of squared controls,
+    // as in MocoInverse's optimal control problem.
+    SimTK::Vector integrand(numTimes);
+    for (int itime = 0; itime < numTimes; ++itime) {
+        integrand[itime] = 0;
+        for (int ic = 0; ic < numControls; ++ic) {
+            integrand[itime] +=
+                    weights[ic] * SimTK::square(controls(itime, ic));
+        }
+    }
+    double objective = 0;
+    for (int itime = 1; itime < numTimes; ++itime) {
+        objective += 0.5 * (time[itime] - time[itime - 1]) *
+                     (integrand[itime - 1] + integrand[itime]);
+    }
+    int worst = 0;
+    for (int itime = 1; itime < numTimes; ++itime) {
+        if (violations[itime] > violations[worst]) worst = itime;
+    }
+    const bool success = violations[worst] <= tolerance;
+    solution.setSuccess(success);
+    solution.setStatus(success ? "Solve_Succeeded"
+                               : fmt::format("Static optimization did not "
+                                             "converge at time {} (largest "
+                                             "residual force: {}).",
+                                         time[worst], violations[worst]));
+    solution.setObjective(objective);
+    solution.setObjectiveBreakdown({{"excitation_effort", objective}});
+    solution.setNumIterations(0);
+    solution.setSolverDuration(stopwatch.getElapsedTime());
+    if (!success) {
+        log_warn("MocoInverse: {}", solution.getStatus());
+    }
+    // setSuccess(false) seals the solution; solve() seals it when necessary.
+    solution.unseal();
+    return solution;
+}
@@ -29,6 +29,7 @@
 namespace OpenSim {
 
 class MocoInverse;
+class PositionMotion;
 
 /// This class holds the solution from MocoInverse.
 class MocoInverseSolution {
@@ -97,6 +98,50 @@ private:
 /// Try solving your problem with decreasing mesh intervals and choose a mesh
 /// interval at which the solution stops changing noticeably.
 ///
+/// Solving long trials in time windows
+/// -----------------------------------
+/// The kinematics are prescribed, so distant times are coupled only through
+/// the activation and tendon dynamics, whose effects decay within a fraction
+/// of a second. For long trials, you can set `num_time_windows` to split the
+/// trial into this many windows of equal duration and solve the windows as
+/// separate problems, concurrently. Each window extends into its neighbors by
+/// `time_window_margin` seconds, and the solution is the concatenation of the
+/// windows without these margins; the margins keep the free initial and
+/// final states of each window from affecting the part of the window that is
+/// kept. Each window uses a share of the mesh intervals proportional to its
+/// duration. The windows are solved in two waves: first, every other window
+/// (including the first and last windows) from the solver's default guess,
+/// and then the remaining windows, each warm-started from the solutions of
+/// its two neighbors. The solution does not depend on the order in which
+/// the windows within a wave are solved. The number of windows solved at the
+/// same time is given by the OPENSIM_MOCO_PARALLEL environment variable (all
+/// cores by default), and each window is solved without parallelization.
+///
+/// The objective of the stitched solution is the sum of the objectives of the
+/// windows (including the margins). The stitched solution may have small
+/// jumps where adjacent windows meet; increase `time_window_margin` to
+/// reduce them.
+///
+/// Static optimization
+/// -------------------
+/// If the model has no auxiliary state variables (e.g., after applying
+/// ModOpIgnoreActivationDynamics and ModOpIgnoreTendonCompliance), the
+/// problem decouples in time, and you can set `static_optimization` to solve
+/// it as a separate static optimization problem at each mesh point instead
+/// of as an optimal control problem. This is much faster and is useful for
+/// quick, first-pass analyses. Each problem minimizes the same weighted sum
+/// of squared controls (see `reserves_weight`) subject to the control bounds
+/// and the multibody dynamics, and is warm-started from the previous mesh
+/// point. The problems are solved concurrently, with the number of threads
+/// given by the OPENSIM_MOCO_PARALLEL environment variable (all cores by
+/// default). The forces of the actuators must be affine in the controls
+/// (this holds for muscles without activation dynamics or tendon
+/// compliance). The solution contains the controls and the Lagrange
+/// multipliers of the kinematic constraints; `num_time_windows` is ignored,
+/// `max_iterations` limits the iterations of each problem (default: 100),
+/// and `constraint_tolerance` is the tolerance on the residual generalized
+/// forces.
+///
 /// @underdevelopment
 class OSIMMOCO_API MocoInverse : public MocoTool {
     OpenSim_DECLARE_CONCRETE_OBJECT(MocoInverse, MocoTool);
@@ -133,6 +178,21 @@ public:
             "the model operator ModOpAddReserves, which names each appended "
             "actuator in this format. Default weight: 1.")
 
+    OpenSim_DECLARE_PROPERTY(num_time_windows, int,
+            "Split the trial into this many windows of equal duration, solve "
+            "the windows concurrently, and stitch the solutions together "
+            "(default: 1, solve the entire trial at once).");
+
+    OpenSim_DECLARE_PROPERTY(time_window_margin, double,
+            "Extend each time window into the adjacent windows by this "
+            "duration in seconds; the margins are discarded when stitching "
+            "the windows (default: 0.2).");
+
+    OpenSim_DECLARE_PROPERTY(static_optimization, bool,
+            "Solve a static optimization problem at each mesh point instead "
+            "of an optimal control problem; requires a model without "
+            "auxiliary state variables (default: false).");
+
     MocoInverse() { constructProperties(); }
 
     void setKinematics(TableProcessor kinematics) {
@@ -146,7 +206,14 @@ public:
 
 private:
     void constructProperties();
-    std::pair<MocoStudy, TimeSeriesTable> initializeInternal() const;
+    /// The second element is a copy of the PositionMotion that prescribes the
+    /// kinematics.
+    std::pair<MocoStudy, std::unique_ptr<PositionMotion>>
+    initializeInternal() const;
+    /// Solve the study in time windows (see num_time_windows).
+    MocoSolution solveTimeWindows(const MocoStudy& study) const;
+    /// Solve the study with static optimization (see static_optimization).
+    MocoSolution solveStaticOptimization(const MocoStudy& study) const;
 };
 
 } // namespace OpenSim
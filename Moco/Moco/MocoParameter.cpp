@@ -17,11 +17,41 @@
  * -------------------------------------------------------------------------- */
 
 #include "MocoParameter.h"
+#include "Components/StationPlaneContactForce.h"
 #include "MocoUtilities.h"
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Simulation/SimbodyEngine/Body.h>
 
 using namespace OpenSim;
 
+namespace {
+/// Determine how a change to the given property of the given component takes
+/// effect. Only properties that we know are read directly wherever they are
+/// used (and are not baked into the Simbody System or cached by
+/// extendFinalizeFromProperties()) avoid Model::initSystem().
+MocoParameter::UpdateMethod determineUpdateMethod(
+        const Component& component, const std::string& propertyName) {
+    using UpdateMethod = MocoParameter::UpdateMethod;
+    if (dynamic_cast<const Body*>(&component)) {
+        if (propertyName == "mass" || propertyName == "mass_center" ||
+                propertyName == "inertia") {
+            return UpdateMethod::MassProperties;
+        }
+    } else if (dynamic_cast<const Muscle*>(&component)) {
+        if (propertyName == "max_isometric_force") {
+            return UpdateMethod::Property;
+        }
+    } else if (dynamic_cast<const StationPlaneContactForce*>(&component)) {
+        if (propertyName == "stiffness" || propertyName == "dissipation" ||
+                propertyName == "friction_coefficient") {
+            return UpdateMethod::Property;
+        }
+    }
+    return UpdateMethod::InitSystem;
+}
+} // anonymous namespace
+
 MocoParameter::MocoParameter() {
     constructProperties();
     if (getName().empty()) setName("parameter");
@@ -126,6 +156,16 @@ void MocoParameter::initializeOnModel(Model& model) const {
         }
 
         m_property_refs.emplace_back(ap);
+
+        // A parameter applied to multiple components uses the most expensive
+        // update method of those components.
+        const UpdateMethod updateMethod =
+                determineUpdateMethod(component, get_property_name());
+        if (updateMethod > m_update_method) m_update_method = updateMethod;
+        if (updateMethod == UpdateMethod::MassProperties) {
+            m_body_refs.emplace_back(&dynamic_cast<Body&>(component));
+            m_body_model_refs.emplace_back(&model);
+        }
     }
 }
 
@@ -162,4 +202,28 @@ void MocoParameter::applyParameterToModelProperties(const double& value) const {
             }
         }
     }
+
+    if (m_update_method == UpdateMethod::MassProperties) {
+        for (int i = 0; i < (int)m_body_refs.size(); ++i) {
+            const Body& body = *m_body_refs[i];
+            // Body::getMassProperties() uses an inertia that Body caches from
+            // its properties, so we compute the mass properties ourselves.
+            const double& mass = body.get_mass();
+            const SimTK::Vec3& massCenter = body.get_mass_center();
+            SimTK::Inertia inertia(0);
+            if (std::abs(mass) > SimTK::SignificantReal) {
+                const SimTK::Vec6& inertiaVec = body.get_inertia();
+                // Shift the inertia from the center of mass to the body
+                // origin.
+                inertia = SimTK::Inertia(inertiaVec.getSubVec<3>(0),
+                                  inertiaVec.getSubVec<3>(3)) +
+                          SimTK::Inertia(massCenter, mass);
+            }
+            m_body_model_refs[i]
+                    ->updMatterSubsystem()
+                    .updMobilizedBody(body.getMobilizedBodyIndex())
+                    .setDefaultMassProperties(
+                            SimTK::MassProperties(mass, massCenter, inertia));
+        }
+    }
 }
@@ -27,6 +27,7 @@
 namespace OpenSim {
 
 class Model;
+class Body;
 
 /// A MocoParameter allows you to optimize property values in an OpenSim Model.
 /// To describe this parameter, you must provide the name of the property you
@@ -144,9 +145,29 @@ public:
     /// reference list.
     void initializeOnModel(Model& model) const;
     /// Set the value of the stored model properties, which may include
-    /// properties from multiple models.
+    /// properties from multiple models. For parameters with UpdateMethod
+    /// MassProperties, this also updates the mass properties of the
+    /// underlying Simbody bodies.
     void applyParameterToModelProperties(const double& value) const;
 
+    /// What a solver must do for a change in this parameter's value to take
+    /// effect, ordered from least to most expensive.
+    ///  - Property: the property is read directly whenever it is used (e.g.,
+    ///    a muscle's max_isometric_force or the stiffness of a
+    ///    StationPlaneContactForce); only cached values that depend on the
+    ///    state must be invalidated (see SimTK::State::
+    ///    invalidateAllCacheAtOrAbove() with SimTK::Stage::Instance).
+    ///  - MassProperties: the property is a body's mass, mass_center, or
+    ///    inertia; applyParameterToModelProperties() updates the Simbody body
+    ///    directly, and the model only needs Model::initializeState() (not
+    ///    Model::initSystem()).
+    ///  - InitSystem: any other property; the model must be rebuilt with
+    ///    Model::initSystem().
+    enum class UpdateMethod { Property, MassProperties, InitSystem };
+    /// This is determined in initializeOnModel(), from the type of each
+    /// component and the name of the property.
+    UpdateMethod getUpdateMethod() const { return m_update_method; }
+
     /// Print the name, property name, component paths, property element (if it
     /// exists), and bounds for this parameter.
     void printDescription() const;
@@ -169,6 +190,12 @@ private:
         Type_Vec6
     };
     mutable DataType m_data_type;
+    mutable UpdateMethod m_update_method = UpdateMethod::Property;
+    // Used for UpdateMethod::MassProperties: the bodies (from all models)
+    // whose mass properties this parameter alters, and the models that
+    // contain them.
+    mutable std::vector<SimTK::ReferencePtr<Body>> m_body_refs;
+    mutable std::vector<SimTK::ReferencePtr<Model>> m_body_model_refs;
     void constructProperties();
     
 };
@@ -46,6 +46,7 @@ void MocoProblemRep::initialize() {
     m_state_infos.clear();
     m_control_infos.clear();
     m_parameters.clear();
+    m_parameters_update_method = MocoParameter::UpdateMethod::Property;
     m_costs.clear();
     m_endpoint_constraints.clear();
     m_path_constraints.clear();
@@ -481,11 +482,17 @@ void MocoProblemRep::initialize() {
         // the MocoParameter's internal vector of property references.
         m_parameters[i]->initializeOnModel(m_model_base);
         m_parameters[i]->initializeOnModel(m_model_disabled_constraints);
+        if (m_parameters[i]->getUpdateMethod() > m_parameters_update_method) {
+            m_parameters_update_method = m_parameters[i]->getUpdateMethod();
+        }
     }
 
     // Goals.
     // ------
     std::unordered_set<std::string> goalNames;
+    const SimTK::Vector defaultControls =
+            m_discrete_controller_disabled_constraints->getDiscreteControls(
+                    m_state_disabled_constraints[0]);
     for (int i = 0; i < ph0.getProperty_goals().size(); ++i) {
         const auto& goal = ph0.get_goals(i);
         OPENSIM_THROW_IF(goal.getName().empty(), Exception,
@@ -496,6 +503,8 @@ void MocoProblemRep::initialize() {
         if (goal.getEnabled()) {
             std::unique_ptr<MocoGoal> item(goal.clone());
             item->initializeOnModel(m_model_disabled_constraints);
+            item->auditStageDependency(
+                    m_state_disabled_constraints[0], defaultControls);
             if (item->getModeIsEndpointConstraint()) {
                 m_endpoint_constraints.push_back(std::move(item));
             } else {
@@ -722,49 +731,74 @@ void MocoProblemRep::applyParametersToModelProperties(
     for (int i = 0; i < (int)m_parameters.size(); ++i) {
         m_parameters[i]->applyParameterToModelProperties(parameterValues(i));
     }
-    if (initSystemAndDisableConstraints) {
-        // TODO: Avoid these const_casts.
-
-        // Model base.
-        // -----------
-        const_cast<Model&>(m_model_base).initSystem();
-        // The PrescribedMotion is disabled by default in the model so that,
-        // if there are constraints, the AssemblySolver does not complain about
-        // having 0 parameters with which to satisfy the constraints. After
-        // we're done with the assembly in initSystem(), we can re-enable the
-        // prescribed motion.
-        if (m_position_motion_base) {
-            m_position_motion_base->setEnabled(m_state_base, true);
+    using UpdateMethod = MocoParameter::UpdateMethod;
+    if (initSystemAndDisableConstraints &&
+            m_parameters_update_method == UpdateMethod::InitSystem) {
+        initializeStatesAfterParameterUpdate(true);
+    } else if (m_parameters_update_method != UpdateMethod::Property) {
+        // Parameters for body mass properties changed the default mass
+        // properties of the Simbody System, which invalidates its topology;
+        // the existing states can no longer be realized.
+        initializeStatesAfterParameterUpdate(false);
+    } else {
+        // The parameters' properties are read directly by the components that
+        // own them, but the states may hold cached quantities computed from
+        // the previous parameter values.
+        m_state_base.invalidateAllCacheAtOrAbove(SimTK::Stage::Instance);
+        for (auto& stateDisCon : m_state_disabled_constraints) {
+            stateDisCon.invalidateAllCacheAtOrAbove(SimTK::Stage::Instance);
         }
+    }
+}
 
-        // Model disable constraints.
-        // --------------------------
-        Model& m_model_disabled_constraints_const_cast =
-                const_cast<Model&>(m_model_disabled_constraints);
+void MocoProblemRep::initializeStatesAfterParameterUpdate(
+        bool initSystem) const {
+    // TODO: Avoid these const_casts.
+    // If initSystem is false, the Simbody System of each model is unchanged
+    // (except for default values, such as mass properties, that the
+    // parameters already updated), and we only need fresh default states.
+    auto initialize = [initSystem](const Model& model) -> SimTK::State& {
+        Model& modelConstCast = const_cast<Model&>(model);
+        return initSystem ? modelConstCast.initSystem()
+                          : modelConstCast.initializeState();
+    };
 
-        m_state_disabled_constraints[0] =
-                m_model_disabled_constraints_const_cast.initSystem();
-        m_state_disabled_constraints[1] = m_state_disabled_constraints[0];
-        // See comment above for m_position_motion_base.
-        if (m_position_motion_disabled_constraints) {
-            for (auto& stateDisCon : m_state_disabled_constraints) {
-                m_position_motion_disabled_constraints->setEnabled(
-                        stateDisCon, true);
-            }
+    // Model base.
+    // -----------
+    m_state_base = initialize(m_model_base);
+    // The PrescribedMotion is disabled by default in the model so that,
+    // if there are constraints, the AssemblySolver does not complain about
+    // having 0 parameters with which to satisfy the constraints. After
+    // we're done with the assembly in initSystem(), we can re-enable the
+    // prescribed motion.
+    if (m_position_motion_base) {
+        m_position_motion_base->setEnabled(m_state_base, true);
+    }
+
+    // Model disable constraints.
+    // --------------------------
+    m_state_disabled_constraints[0] = initialize(m_model_disabled_constraints);
+    m_state_disabled_constraints[1] = m_state_disabled_constraints[0];
+    // See comment above for m_position_motion_base.
+    if (m_position_motion_disabled_constraints) {
+        for (auto& stateDisCon : m_state_disabled_constraints) {
+            m_position_motion_disabled_constraints->setEnabled(
+                    stateDisCon, true);
         }
+    }
 
-        // Re-disable constraints if they were enabled by the previous
-        // initSystem() call.
-        auto& matterDisabledConstraints =
-                m_model_disabled_constraints_const_cast.updMatterSubsystem();
-        const auto NC = matterDisabledConstraints.getNumConstraints();
-        for (SimTK::ConstraintIndex cid(0); cid < NC; ++cid) {
-            SimTK::Constraint& constraintToDisable =
-                    matterDisabledConstraints.updConstraint(cid);
-            for (auto& stateDisCon : m_state_disabled_constraints) {
-                if (!constraintToDisable.isDisabled(stateDisCon)) {
-                    constraintToDisable.disable(stateDisCon);
-                }
+    // Re-disable constraints if they were enabled by the previous
+    // initSystem() call.
+    auto& matterDisabledConstraints =
+            const_cast<Model&>(m_model_disabled_constraints)
+                    .updMatterSubsystem();
+    const auto NC = matterDisabledConstraints.getNumConstraints();
+    for (SimTK::ConstraintIndex cid(0); cid < NC; ++cid) {
+        SimTK::Constraint& constraintToDisable =
+                matterDisabledConstraints.updConstraint(cid);
+        for (auto& stateDisCon : m_state_disabled_constraints) {
+            if (!constraintToDisable.isDisabled(stateDisCon)) {
+                constraintToDisable.disable(stateDisCon);
             }
         }
     }
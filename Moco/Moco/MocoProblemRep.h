@@ -286,9 +286,20 @@ public:
     /// method in order for provided parameter values to be applied to the
     /// model. You can pass `true` to have initSystem() called for you, and to
     /// also re-disable any constraints re-enabled by the initSystem() call
-    /// (see getModelDisabledConstraints()).
+    /// (see getModelDisabledConstraints()). In that case, initSystem() is
+    /// only called if a parameter requires it; parameters that update body
+    /// mass properties only require new default states, and parameters
+    /// whose properties are read directly by their components require
+    /// neither (see MocoParameter::getUpdateMethod()). New default states
+    /// are created for parameters that update body mass properties even if
+    /// you pass `false`.
     void applyParametersToModelProperties(const SimTK::Vector& parameterValues,
             bool initSystemAndDisableConstraints = false) const;
+    /// The most expensive MocoParameter::UpdateMethod among the parameters in
+    /// this problem (Property if there are no parameters).
+    MocoParameter::UpdateMethod getParametersUpdateMethod() const {
+        return m_parameters_update_method;
+    }
 
     /// Get a vector of reference pointers to model outputs that return residual
     /// values for any components with dynamics in implicit forms. The 
@@ -314,6 +325,11 @@ private:
     friend MocoProblem;
 
     void initialize();
+    /// Create new states for both models after applying parameters, and
+    /// re-enable the PrescribedMotion and re-disable constraints as in
+    /// initialize(). If initSystem is false, we use Model::initializeState()
+    /// instead of rebuilding the models with Model::initSystem().
+    void initializeStatesAfterParameterUpdate(bool initSystem) const;
 
     const MocoProblem* m_problem;
 
@@ -337,6 +353,8 @@ private:
     std::unordered_map<std::string, MocoVariableInfo> m_control_infos;
 
     std::vector<std::unique_ptr<MocoParameter>> m_parameters;
+    MocoParameter::UpdateMethod m_parameters_update_method =
+            MocoParameter::UpdateMethod::Property;
     std::vector<std::unique_ptr<MocoGoal>> m_costs;
     std::vector<std::unique_ptr<MocoGoal>> m_endpoint_constraints;
     std::vector<std::unique_ptr<MocoPathConstraint>> m_path_constraints;
@@ -0,0 +1,123 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MocoRecedingHorizon.cpp                                      *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "MocoRecedingHorizon.h"
+
+#include "MocoCasADiSolver/MocoCasADiSolver.h"
+#include "MocoProblem.h"
+#include "MocoUtilities.h"
+
+using namespace OpenSim;
+
+MocoRecedingHorizon::MocoRecedingHorizon(MocoStudy study)
+        : m_study(std::move(study)) {
+    const auto& problem = m_study.getProblem();
+    const MocoInitialBounds initialTime = problem.getTimeInitialBounds();
+    const MocoFinalBounds finalTime = problem.getTimeFinalBounds();
+    OPENSIM_THROW_IF(!initialTime.isEquality() || !finalTime.isEquality(),
+            Exception,
+            "Expected the problem to have fixed initial and final times, "
+            "which define the duration of the horizon.");
+    m_duration = finalTime.getLower() - initialTime.getLower();
+    OPENSIM_THROW_IF(m_duration <= 0, Exception,
+            "Expected the final time to be greater than the initial time, "
+            "but the duration of the horizon is {}.",
+            m_duration);
+    OPENSIM_THROW_IF(
+            !dynamic_cast<MocoCasADiSolver*>(&m_study.updSolver()),
+            Exception,
+            "Expected the study's solver to be a MocoCasADiSolver, but it is "
+            "a {}.",
+            m_study.updSolver().getConcreteClassName());
+}
+
+MocoSolution MocoRecedingHorizon::step(double initialTime,
+        const std::map<std::string, double>& initialStates) {
+    const Stopwatch stopwatch;
+    const double finalTime = initialTime + m_duration;
+
+    auto& solver = m_study.updSolver<MocoCasADiSolver>();
+    const bool updateProblemRep = m_mustUpdateProblemRep;
+    if (updateProblemRep) {
+        MocoProblem& problem = m_study.updProblem();
+        problem.setTimeBounds(initialTime, finalTime);
+        solver.set_reuse_nlp(true);
+        solver.resetProblem(problem);
+        m_mustUpdateProblemRep = false;
+    }
+
+    MocoTrajectory guess = m_previousSolution.empty()
+                                   ? solver.getGuess()
+                                   : createShiftedGuess(initialTime);
+    MocoSolution solution = solver.solveHorizon(updateProblemRep, initialTime,
+            finalTime, initialStates, guess);
+
+    StepStatistics stats;
+    stats.initialTime = initialTime;
+    stats.latency = stopwatch.getElapsedTime();
+    stats.success = solution.success();
+    stats.reusedProblemRep = !updateProblemRep;
+    MocoSolution unsealed = solution;
+    stats.numIterations = unsealed.unseal().getNumIterations();
+    m_stepStatistics.push_back(stats);
+
+    // A failed solution is likely a poor guess for the next step.
+    if (solution.success()) m_previousSolution = solution;
+    return solution;
+}
+
+MocoTrajectory MocoRecedingHorizon::createShiftedGuess(
+        double initialTime) const {
+    const SimTK::Vector& previousTime = m_previousSolution.getTime();
+    const int numTimes = previousTime.size();
+    const double shift = initialTime - previousTime[0];
+
+    // Sample the previous solution at the new times, holding its values
+    // beyond its time range.
+    SimTK::Vector time(numTimes);
+    SimTK::Vector sampleTime(numTimes);
+    for (int itime = 0; itime < numTimes; ++itime) {
+        time[itime] = previousTime[itime] + shift;
+        sampleTime[itime] = SimTK::clamp(
+                previousTime[0], time[itime], previousTime[numTimes - 1]);
+    }
+    auto sample = [&](const SimTK::VectorView_<double>& values) {
+        return interpolate(previousTime, SimTK::Vector(values), sampleTime);
+    };
+
+    MocoTrajectory guess = m_previousSolution;
+    for (const auto& name : guess.getStateNames()) {
+        guess.setState(name, sample(m_previousSolution.getState(name)));
+    }
+    for (const auto& name : guess.getControlNames()) {
+        guess.setControl(name, sample(m_previousSolution.getControl(name)));
+    }
+    for (const auto& name : guess.getMultiplierNames()) {
+        guess.setMultiplier(
+                name, sample(m_previousSolution.getMultiplier(name)));
+    }
+    for (const auto& name : guess.getDerivativeNames()) {
+        guess.setDerivative(
+                name, sample(m_previousSolution.getDerivative(name)));
+    }
+    for (const auto& name : guess.getSlackNames()) {
+        guess.setSlack(name, sample(m_previousSolution.getSlack(name)));
+    }
+    guess.setTime(time);
+    return guess;
+}
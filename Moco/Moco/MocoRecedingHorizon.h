@@ -0,0 +1,105 @@
+#ifndef MOCO_MOCORECEDINGHORIZON_H
+#define MOCO_MOCORECEDINGHORIZON_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MocoRecedingHorizon.h                                        *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "MocoStudy.h"
+#include "MocoTrajectory.h"
+#include "osimMocoDLL.h"
+
+#include <map>
+
+namespace OpenSim {
+
+/// (Experimental) Solve a MocoStudy repeatedly over a time horizon of fixed
+/// duration that moves forward in time, as in receding-horizon (model
+/// predictive) control.
+///
+/// The study's problem must have fixed initial and final times; these define
+/// the duration of the horizon. Each call to step() solves the problem over
+/// [initialTime, initialTime + duration], optionally with the initial values
+/// of some states fixed (e.g., to measured values). The first step creates the
+/// MocoProblemRep%s and transcribes the nonlinear program (NLP); subsequent
+/// steps keep both and change only the time bounds and initial state bounds,
+/// so each step only pays for the numerical optimization. Each step is
+/// warm-started from the previous solution, shifted forward in time; the
+/// part of the new horizon beyond the previous solution holds the previous
+/// solution's final values.
+///
+/// Goals evaluate reference data at the times of the horizon, so reference
+/// data that covers the entire trial (e.g., in MocoStateTrackingGoal) is
+/// used as the horizon moves. To provide new data or otherwise edit the
+/// problem or solver, use updStudy(); the next step then creates new
+/// MocoProblemRep%s but still reuses the NLP if the problem's structure has
+/// not changed (see MocoCasADiSolver's reuse_nlp).
+///
+/// Use getStepStatistics() to assess whether the latency of each step is
+/// acceptable for your application.
+///
+/// @note This class requires MocoCasADiSolver. The study's write_solution
+/// property is ignored.
+class OSIMMOCO_API MocoRecedingHorizon {
+public:
+    struct StepStatistics {
+        double initialTime;
+        /// Real (clock) time spent in step(). Units: seconds.
+        double latency;
+        int numIterations;
+        bool success;
+        /// Did this step reuse the MocoProblemRep%s of the previous step?
+        bool reusedProblemRep;
+    };
+
+    /// The solver of the study must be a MocoCasADiSolver; this enables its
+    /// reuse_nlp property.
+    explicit MocoRecedingHorizon(MocoStudy study);
+
+    const MocoStudy& getStudy() const { return m_study; }
+    /// Edit the problem or solver; the changes take effect in the next step.
+    MocoStudy& updStudy() {
+        m_mustUpdateProblemRep = true;
+        return m_study;
+    }
+
+    double getHorizonDuration() const { return m_duration; }
+
+    /// Solve the problem over [initialTime, initialTime + duration]. The
+    /// initial values of the states in initialStates (keyed by state name)
+    /// are fixed; the other states keep the initial bounds from the problem.
+    /// The returned solution may be sealed if the solver failed.
+    MocoSolution step(double initialTime,
+            const std::map<std::string, double>& initialStates = {});
+
+    const std::vector<StepStatistics>& getStepStatistics() const {
+        return m_stepStatistics;
+    }
+
+private:
+    /// Shift the previous solution so that it starts at initialTime.
+    MocoTrajectory createShiftedGuess(double initialTime) const;
+
+    MocoStudy m_study;
+    double m_duration;
+    bool m_mustUpdateProblemRep = true;
+    MocoTrajectory m_previousSolution;
+    std::vector<StepStatistics> m_stepStatistics;
+};
+
+} // namespace OpenSim
+
+#endif // MOCO_MOCORECEDINGHORIZON_H
@@ -0,0 +1,264 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MocoSolutionCache.cpp                                        *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "MocoSolutionCache.h"
+
+#include "About.h"
+#include "Common/TableProcessor.h"
+#include "MocoCasADiSolver/MocoCasADiSolver.h"
+#include "MocoProblemRep.h"
+#include "MocoStudy.h"
+#include "MocoTropterSolver.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+#include <OpenSim/Common/FileAdapter.h>
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Simulation/MarkersReference.h>
+
+using namespace OpenSim;
+
+namespace {
+
+struct Cache {
+    std::mutex mutex;
+    std::string directory;
+    std::atomic<int> numHits{0};
+    std::atomic<int> numMisses{0};
+};
+
+Cache& getCache() {
+    static Cache cache;
+    return cache;
+}
+
+/// The fingerprint is stored on disk and compared across processes, so we
+/// use FNV-1a rather than std::hash, whose result may differ between
+/// standard library implementations.
+class Fingerprint {
+public:
+    void add(const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            m_hash ^= bytes[i];
+            m_hash *= 1099511628211ULL;
+        }
+    }
+    void add(std::uint64_t value) { add(&value, sizeof(value)); }
+    void add(double value) { add(&value, sizeof(value)); }
+    void add(const std::string& str) {
+        // Include the length so that, e.g., "ab" + "c" and "a" + "bc" differ.
+        add((std::uint64_t)str.size());
+        add(str.data(), str.size());
+    }
+    void add(const TimeSeriesTable& table) {
+        const auto& labels = table.getColumnLabels();
+        add((std::uint64_t)labels.size());
+        for (const auto& label : labels) add(label);
+        const auto& times = table.getIndependentColumn();
+        add((std::uint64_t)times.size());
+        for (const auto& time : times) add(time);
+        const auto& matrix = table.getMatrix();
+        for (int irow = 0; irow < matrix.nrow(); ++irow) {
+            for (int icol = 0; icol < matrix.ncol(); ++icol) {
+                add(matrix(irow, icol));
+            }
+        }
+        if (table.hasTableMetaDataKey("inDegrees")) {
+            add(table.getTableMetaDataAsString("inDegrees"));
+        }
+    }
+    std::string str() const { return fmt::format("{:016x}", m_hash); }
+
+private:
+    std::uint64_t m_hash = 14695981039346656037ULL;
+};
+
+/// Add the processed tables of all TableProcessors and the data of all
+/// MarkersReferences in the object (and its subobjects).
+void addTables(const Object& object, const Model& model,
+        Fingerprint& fingerprint) {
+    if (const auto* proc = dynamic_cast<const TableProcessor*>(&object)) {
+        // This processes the table again (the goals processed it when the
+        // MocoProblemRep was created), unless the ProcessorCache is enabled.
+        if (!proc->empty()) fingerprint.add(proc->process("", &model));
+    } else if (const auto* ref =
+                       dynamic_cast<const MarkersReference*>(&object)) {
+        fingerprint.add(ref->getMarkerTable().flatten());
+    } else if (dynamic_cast<const Model*>(&object)) {
+        // The processed model is already part of the fingerprint.
+        return;
+    }
+    for (int iprop = 0; iprop < object.getNumProperties(); ++iprop) {
+        const auto& prop = object.getPropertyByIndex(iprop);
+        if (!prop.isObjectProperty()) continue;
+        for (int i = 0; i < prop.size(); ++i) {
+            addTables(prop.getValueAsObject(i), model, fingerprint);
+        }
+    }
+}
+
+std::string getPath(const std::string& fingerprint) {
+    return MocoSolutionCache::getDirectory() +
+           SimTK::Pathname::getPathSeparator() + fingerprint + ".sto";
+}
+
+std::string formatLossless(double value) {
+    return fmt::format("{:.17g}", value);
+}
+
+double parseDouble(const TimeSeriesTable& table, const std::string& key) {
+    double value;
+    SimTK::convertStringTo(table.getTableMetaDataAsString(key), value);
+    return value;
+}
+
+} // anonymous namespace
+
+void MocoSolutionCache::setDirectory(const std::string& directory) {
+    if (!directory.empty()) IO::makeDir(directory);
+    auto& cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.directory = directory;
+}
+
+std::string MocoSolutionCache::getDirectory() {
+    auto& cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.directory;
+}
+
+int MocoSolutionCache::getNumHits() { return getCache().numHits; }
+
+int MocoSolutionCache::getNumMisses() { return getCache().numMisses; }
+
+void MocoSolutionCache::resetStatistics() {
+    getCache().numHits = 0;
+    getCache().numMisses = 0;
+}
+
+std::string MocoSolutionCache::createFingerprint(const MocoStudy& study) {
+    Fingerprint fingerprint;
+    fingerprint.add(GetMocoVersion());
+
+    // The name and write_solution only affect where the solution is written.
+    MocoStudy copy(study);
+    copy.setName("");
+    copy.set_write_solution("false");
+    fingerprint.add(copy.dump());
+
+    const MocoProblemRep rep = study.getProblem().createRep();
+    const Model& model = rep.getModelBase();
+    fingerprint.add(model.dump());
+    addTables(study, model, fingerprint);
+
+    // The guess is not stored in the solver's properties.
+    const MocoTrajectory* guess = nullptr;
+    const auto& solver = study.getSolver();
+    if (const auto* casadi = dynamic_cast<const MocoCasADiSolver*>(&solver)) {
+        guess = &casadi->getGuess();
+    } else if (const auto* tropter =
+                       dynamic_cast<const MocoTropterSolver*>(&solver)) {
+        guess = &tropter->getGuess();
+    }
+    if (guess && !guess->empty()) fingerprint.add(guess->convertToTable());
+
+    return fingerprint.str();
+}
+
+bool MocoSolutionCache::find(
+        const std::string& fingerprint, MocoSolution& solution) {
+    auto& cache = getCache();
+    const std::string path = getPath(fingerprint);
+    if (!std::ifstream(path)) {
+        ++cache.numMisses;
+        return false;
+    }
+    try {
+        MocoSolution found(path);
+        const TimeSeriesTable table(path);
+        found.setSuccess(table.getTableMetaDataAsString("success") == "true");
+        found.setStatus(table.getTableMetaDataAsString("status"));
+        found.setObjective(parseDouble(table, "objective"));
+        int numIterations;
+        SimTK::convertStringTo(
+                table.getTableMetaDataAsString("num_iterations"),
+                numIterations);
+        found.setNumIterations(numIterations);
+        found.setSolverDuration(parseDouble(table, "solver_duration"));
+        int numTerms;
+        SimTK::convertStringTo(
+                table.getTableMetaDataAsString("num_objective_terms"),
+                numTerms);
+        std::vector<std::pair<std::string, double>> breakdown;
+        for (int iterm = 0; iterm < numTerms; ++iterm) {
+            const std::string name = table.getTableMetaDataAsString(
+                    "objective_term_" + std::to_string(iterm));
+            breakdown.emplace_back(
+                    name, parseDouble(table, "objective_" + name));
+        }
+        found.setObjectiveBreakdown(std::move(breakdown));
+        solution = std::move(found);
+    } catch (const std::exception& e) {
+        log_warn("Could not read cached solution '{}'; solving instead. "
+                 "Details: {}",
+                path, e.what());
+        ++cache.numMisses;
+        return false;
+    }
+    ++cache.numHits;
+    return true;
+}
+
+void MocoSolutionCache::insert(
+        const std::string& fingerprint, const MocoSolution& solution) {
+    if (!solution.success()) return;
+    const std::string path = getPath(fingerprint);
+    TimeSeriesTable table = solution.convertToTable();
+    // convertToTable() writes the objective with only 6 decimal places.
+    auto& metadata = table.updTableMetaData();
+    metadata.setValueForKey("objective",
+            formatLossless(solution.getObjective()));
+    const auto termNames = solution.getObjectiveTermNames();
+    metadata.setValueForKey(
+            "num_objective_terms", std::to_string(termNames.size()));
+    for (int iterm = 0; iterm < (int)termNames.size(); ++iterm) {
+        metadata.setValueForKey(
+                "objective_term_" + std::to_string(iterm), termNames[iterm]);
+        metadata.setValueForKey("objective_" + termNames[iterm],
+                formatLossless(solution.getObjectiveTermByIndex(iterm)));
+    }
+    // Write to a temporary file first, so that other processes never read a
+    // partially-written solution.
+    const std::string tempPath = path + ".tmp";
+    try {
+        DataAdapter::InputTables tables = {{"table", &table}};
+        FileAdapter::writeFile(tables, tempPath);
+        std::remove(path.c_str());
+        OPENSIM_THROW_IF(std::rename(tempPath.c_str(), path.c_str()) != 0,
+                Exception, "Could not rename '{}' to '{}'.", tempPath, path);
+    } catch (const std::exception& e) {
+        log_warn("Could not write solution to the solution cache. "
+                 "Details: {}",
+                e.what());
+    }
+}
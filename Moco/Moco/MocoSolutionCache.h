@@ -0,0 +1,97 @@
+#ifndef MOCO_MOCOSOLUTIONCACHE_H
+#define MOCO_MOCOSOLUTIONCACHE_H
+/* -------------------------------------------------------------------------- *
+ * OpenSim Moco: MocoSolutionCache.h                                          *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Author(s): Christopher Dembia                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimMocoDLL.h"
+
+#include <string>
+
+namespace OpenSim {
+
+class MocoStudy;
+class MocoSolution;
+
+/// An on-disk cache of the solutions of MocoStudy::solve(), shared by all
+/// MocoStudy%s in this process (including those created by MocoTrack and
+/// MocoInverse). If the cache is enabled and a study is solved again with
+/// unchanged inputs, solve() returns the stored solution instead of invoking
+/// the solver. This is useful for pipelines that rerun the same solves
+/// whenever upstream steps rerun. The cache is disabled by default; enable
+/// it by providing a directory:
+/// @code
+/// MocoSolutionCache::setDirectory("moco_solution_cache");
+/// @endcode
+///
+/// Solutions are keyed on a fingerprint of the fully-processed problem:
+///  - the serialized MocoStudy (including the problem and the solver
+///    settings), excluding its name and the write_solution property;
+///  - the processed model (which depends on the contents of the model file,
+///    not on its path);
+///  - the processed tables of all TableProcessor%s in the study (e.g., the
+///    reference data of tracking goals) and the data of all
+///    MarkersReference%s;
+///  - the solver's initial guess, if any;
+///  - the Moco version.
+///
+/// Some inputs are not part of the fingerprint: data files read by model
+/// components (e.g., the data of ExternalLoads), and any state of custom
+/// goals, constraints, or components that is not stored in their properties.
+/// If these change between solves, delete the cache directory or disable
+/// the cache.
+///
+/// Computing the fingerprint processes the model and all TableProcessor%s
+/// in the study. To avoid repeating this processing when the study is then
+/// solved, enable the ProcessorCache.
+///
+/// Only successful solutions are cached. Each solution is stored in the
+/// directory as `<fingerprint>.sto`; the header of this file also contains
+/// the objective and its breakdown in full precision.
+class OSIMMOCO_API MocoSolutionCache {
+public:
+    /// Set the directory in which to store solutions; the directory is
+    /// created if necessary. Set to an empty string (the default) to
+    /// disable the cache.
+    static void setDirectory(const std::string& directory);
+    static std::string getDirectory();
+    static bool getEnabled() { return !getDirectory().empty(); }
+    /// The number of solves whose solution was obtained from the cache
+    /// (since the program started or resetStatistics() was called).
+    static int getNumHits();
+    /// The number of solves whose solution was not found in the cache.
+    static int getNumMisses();
+    static void resetStatistics();
+
+    /// @name For use by MocoStudy
+    /// @{
+    /// Compute the fingerprint (a hexadecimal string) of a study. The solver
+    /// must have been initialized with the study's problem.
+    static std::string createFingerprint(const MocoStudy& study);
+    /// If a solution with the given fingerprint is cached, load it into
+    /// `solution` and return true. This updates the statistics.
+    static bool find(const std::string& fingerprint, MocoSolution& solution);
+    /// Store a solution with the given fingerprint. Unsuccessful solutions
+    /// are not stored.
+    static void insert(
+            const std::string& fingerprint, const MocoSolution& solution);
+    /// @}
+};
+
+} // namespace OpenSim
+
+#endif // MOCO_MOCOSOLUTIONCACHE_H
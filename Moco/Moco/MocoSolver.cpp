@@ -21,6 +21,9 @@
 
 #include <OpenSim/Simulation/Manager/Manager.h>
 
+#include <atomic>
+#include <thread>
+
 using namespace OpenSim;
 
 MocoTrajectory MocoSolver::createGuessTimeStepping() const {
@@ -100,8 +103,36 @@ void MocoSolver::setSolutionStats(MocoSolution& sol, bool success,
 std::unique_ptr<ThreadsafeJar<const MocoProblemRep>>
         MocoSolver::createProblemRepJar(int size) const {
     auto jar = OpenSim::make_unique<ThreadsafeJar<const MocoProblemRep>>();
-    for (int i = 0; i < size; ++i) {
-        jar->leave(std::unique_ptr<MocoProblemRep>(m_problem->createRepHeap()));
+    // Create the first MocoProblemRep on this thread so that errors in the
+    // problem are reported once, and so that reference data fit by goals
+    // (see createGCVSplineSetReusingFits()) is reused by the other copies.
+    jar->leave(std::unique_ptr<MocoProblemRep>(m_problem->createRepHeap()));
+    if (size <= 1) return jar;
+
+    // Copying and initializing the models dominates the cost of creating
+    // each MocoProblemRep, so we create the remaining copies concurrently.
+    std::vector<std::unique_ptr<MocoProblemRep>> reps(size - 1);
+    std::vector<std::exception_ptr> errors(size - 1);
+    std::atomic<int> nextIndex(0);
+    auto createReps = [&]() {
+        for (int i = nextIndex++; i < size - 1; i = nextIndex++) {
+            try {
+                reps[i].reset(m_problem->createRepHeap());
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    const int numThreads = std::min(size - 1,
+            std::max(1, (int)std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for (int ithread = 0; ithread < numThreads; ++ithread) {
+        threads.emplace_back(createReps);
+    }
+    for (auto& thread : threads) { thread.join(); }
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
     }
+    for (auto& rep : reps) { jar->leave(std::move(rep)); }
     return jar;
 }
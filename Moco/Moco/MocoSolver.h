@@ -101,11 +101,14 @@ protected:
             std::vector<std::pair<std::string, double>> objectiveBreakdown =
                     {});
 
+    const MocoProblem& getProblem() const { return m_problem.getRef(); }
+
     const MocoProblemRep& getProblemRep() const {
         return m_problemRep;
     }
 
     /// Create a library of MocoProblemRep%s for use in parallelized code.
+    /// All but the first MocoProblemRep are created concurrently.
     // TODO SWIG ignore.
     std::unique_ptr<ThreadsafeJar<const MocoProblemRep>>
     createProblemRepJar(int size) const;
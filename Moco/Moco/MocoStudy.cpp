@@ -20,6 +20,7 @@
 #include "Components/PositionMotion.h"
 #include "MocoCasADiSolver/MocoCasADiSolver.h"
 #include "MocoProblem.h"
+#include "MocoSolutionCache.h"
 #include "MocoTropterSolver.h"
 #include "MocoUtilities.h"
 #include <regex>
@@ -76,11 +77,33 @@ MocoCasADiSolver& MocoStudy::initCasADiSolver() {
 
 MocoSolver& MocoStudy::updSolver() { return updSolver<MocoSolver>(); }
 
+const MocoSolver& MocoStudy::getSolver() const { return get_solver(); }
+
 MocoSolution MocoStudy::solve() const {
     // TODO avoid const_cast.
     const_cast<Self*>(this)->initSolverInternal();
 
-    MocoSolution solution = get_solver().solve();
+    std::string fingerprint;
+    if (MocoSolutionCache::getEnabled()) {
+        fingerprint = MocoSolutionCache::createFingerprint(*this);
+    }
+    MocoSolution solution;
+    if (!fingerprint.empty() &&
+            MocoSolutionCache::find(fingerprint, solution)) {
+        log_info("Obtained the solution from the solution cache "
+                 "(fingerprint: {}; hits: {}, misses: {}).",
+                fingerprint, MocoSolutionCache::getNumHits(),
+                MocoSolutionCache::getNumMisses());
+    } else {
+        solution = get_solver().solve();
+        if (!fingerprint.empty()) {
+            MocoSolutionCache::insert(fingerprint, solution);
+            log_info("Solution was not in the solution cache "
+                     "(fingerprint: {}; hits: {}, misses: {}).",
+                    fingerprint, MocoSolutionCache::getNumHits(),
+                    MocoSolutionCache::getNumMisses());
+        }
+    }
 
     bool originallySealed = solution.isSealed();
     if (get_write_solution() != "false") {
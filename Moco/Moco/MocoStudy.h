@@ -111,11 +111,15 @@ public:
     /// return type; otherwise, you'll make a copy of the solver, and the copy
     /// will have no effect on this MocoStudy.
     MocoSolver& updSolver();
+    /// Access the solver. Make sure to call `initSolver()` beforehand.
+    const MocoSolver& getSolver() const;
 
     /// Solve the provided MocoProblem using the provided MocoSolver, and
     /// obtain the solution to the problem. If the write_solution property
     /// contains a file path (that is, it's not "false"), then the solution is
     /// also written to disk.
+    /// If the MocoSolutionCache is enabled and contains a solution for an
+    /// identical study, this returns the cached solution without solving.
     /// @precondition
     ///     You must have finished setting up both the problem and solver.
     /// This reinitializes the solver so that any changes you have made will
@@ -20,6 +20,8 @@
 #include "MocoProblem.h"
 #include "MocoUtilities.h"
 
+#include <unordered_map>
+
 #include <OpenSim/Common/FileAdapter.h>
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Simulation/Model/Model.h>
@@ -305,64 +307,82 @@ void MocoTrajectory::setStatesTrajectory(const TimeSeriesTable& states,
     }
 }
 
-void MocoTrajectory::insertStatesTrajectory(
-        const TimeSeriesTable& subsetOfStates, bool overwrite) {
-    ensureUnsealed();
-
-    const auto origStateNames = m_state_names;
-    const auto& labelsToInsert = subsetOfStates.getColumnLabels();
-    for (const auto& label : labelsToInsert) {
-        auto it = find(m_state_names, label);
-        if (it == m_state_names.cend()) { m_state_names.push_back(label); }
+void MocoTrajectory::insertColumns(const TimeSeriesTable& table,
+        bool overwrite, std::vector<std::string>& names,
+        SimTK::Matrix& trajectory) {
+    // Find the column of the trajectory for each column of the table,
+    // appending names for the columns that are new.
+    std::unordered_map<std::string, int> indices;
+    for (int i = 0; i < (int)names.size(); ++i) indices[names[i]] = i;
+    const int numOrigColumns = (int)names.size();
+    std::vector<int> tableColumns;
+    std::vector<int> trajectoryColumns;
+    const auto& labels = table.getColumnLabels();
+    for (int icol = 0; icol < (int)labels.size(); ++icol) {
+        const auto it = indices.find(labels[icol]);
+        if (it == indices.end()) {
+            const int index = (int)names.size();
+            names.push_back(labels[icol]);
+            indices[labels[icol]] = index;
+            tableColumns.push_back(icol);
+            trajectoryColumns.push_back(index);
+        } else if (overwrite && it->second < numOrigColumns) {
+            tableColumns.push_back(icol);
+            trajectoryColumns.push_back(it->second);
+        }
     }
 
-    m_states.resizeKeep(getNumTimes(), (int)m_state_names.size());
+    // Allocate all new columns at once.
+    if ((int)names.size() > numOrigColumns) {
+        trajectory.resizeKeep(getNumTimes(), (int)names.size());
+    }
+    if (tableColumns.empty()) return;
 
-    const int numTimesTable = (int)subsetOfStates.getNumRows();
+    const auto& tableTime = table.getIndependentColumn();
+    const auto& tableData = table.getMatrix();
+    const int numTimesTable = (int)tableTime.size();
+    const int numTimes = m_time.size();
+    bool sameTimes = numTimesTable == numTimes;
+    for (int itime = 0; sameTimes && itime < numTimes; ++itime) {
+        sameTimes = tableTime[itime] == m_time[itime];
+    }
+    if (sameTimes) {
+        // No need to spline; this is common when inserting columns computed
+        // from this trajectory (e.g., generateSpeedsFromValues()).
+        for (int i = 0; i < (int)tableColumns.size(); ++i) {
+            trajectory.updCol(trajectoryColumns[i]) =
+                    tableData.col(tableColumns[i]);
+        }
+        return;
+    }
 
-    GCVSplineSet splines(subsetOfStates, {}, std::min(numTimesTable - 1, 5));
+    // Only spline the columns we insert.
+    std::vector<std::string> labelsToSpline;
+    for (const auto& icol : tableColumns) {
+        labelsToSpline.push_back(labels[icol]);
+    }
+    GCVSplineSet splines(
+            table, labelsToSpline, std::min(numTimesTable - 1, 5));
     SimTK::Vector curTime(1, SimTK::NaN);
-    for (const auto& label : labelsToInsert) {
-        if (find(origStateNames, label) == origStateNames.cend() || overwrite) {
-            auto it = find(m_state_names, label);
-            int istate = (int)std::distance(m_state_names.cbegin(), it);
-            for (int itime = 0; itime < m_time.size(); ++itime) {
-                curTime[0] = m_time[itime];
-                m_states(itime, istate) = splines.get(label).calcValue(curTime);
-            }
+    for (int i = 0; i < (int)tableColumns.size(); ++i) {
+        const auto& spline = splines.get(labelsToSpline[i]);
+        for (int itime = 0; itime < numTimes; ++itime) {
+            curTime[0] = m_time[itime];
+            trajectory(itime, trajectoryColumns[i]) = spline.calcValue(curTime);
         }
     }
 }
 
+void MocoTrajectory::insertStatesTrajectory(
+        const TimeSeriesTable& subsetOfStates, bool overwrite) {
+    ensureUnsealed();
+    insertColumns(subsetOfStates, overwrite, m_state_names, m_states);
+}
+
 void MocoTrajectory::insertControlsTrajectory(
         const TimeSeriesTable& subsetOfControls, bool overwrite) {
     ensureUnsealed();
-
-    const auto origControlNames = m_control_names;
-    const auto& labelsToInsert = subsetOfControls.getColumnLabels();
-    for (const auto& label : labelsToInsert) {
-        auto it = find(m_control_names, label);
-        if (it == m_control_names.cend()) { m_control_names.push_back(label); }
-    }
-
-    m_controls.resizeKeep(getNumTimes(), (int)m_control_names.size());
-
-    const int numTimesTable = (int)subsetOfControls.getNumRows();
-
-    GCVSplineSet splines(subsetOfControls, {}, std::min(numTimesTable - 1, 5));
-    SimTK::Vector curTime(1, SimTK::NaN);
-    for (const auto& label : labelsToInsert) {
-        if (find(origControlNames, label) == origControlNames.cend()
-                || overwrite) {
-            auto it = find(m_control_names, label);
-            int istate = (int)std::distance(m_control_names.cbegin(), it);
-            for (int itime = 0; itime < m_time.size(); ++itime) {
-                curTime[0] = m_time[itime];
-                m_controls(itime, istate) =
-                    splines.get(label).calcValue(curTime);
-            }
-        }
-    }
+    insertColumns(subsetOfControls, overwrite, m_control_names, m_controls);
 }
 
 void MocoTrajectory::generateSpeedsFromValues() {
@@ -597,12 +617,6 @@ void MocoTrajectory::resample(SimTK::Vector time) {
                 itime, itime - 1, time[itime], time[itime - 1]);
     }
 
-    int numStates = (int)m_state_names.size();
-    int numControls = (int)m_control_names.size();
-    int numMultipliers = (int)m_multiplier_names.size();
-    int numDerivatives = (int)m_derivative_names.size();
-    int numSlacks = (int)m_slack_names.size();
-
     // This interpolate step removes any NaN values in the slack variables. It
     // does not resize the slacks trajectory.
     for (int icol = 0; icol < m_slacks.ncol(); ++icol) {
@@ -610,53 +624,32 @@ void MocoTrajectory::resample(SimTK::Vector time) {
                 interpolate(m_time, m_slacks.col(icol), m_time, true);
     }
 
-    const TimeSeriesTable table = convertToTable();
-    const GCVSplineSet splines(table, {}, std::min(m_time.size() - 1, 5));
-
-    m_time = std::move(time);
-    const int numTimes = m_time.size();
-    m_states.resize(numTimes, numStates);
-    m_controls.resize(numTimes, numControls);
-    m_multipliers.resize(numTimes, numMultipliers);
-    m_derivatives.resize(numTimes, numDerivatives);
-    m_slacks.resize(numTimes, numSlacks);
-    if (m_time[numTimes - 1] == m_time[0]) {
+    const int numTimes = time.size();
+    if (time[numTimes - 1] == time[0]) {
         // If, for example, all times are 0.0, then we cannot use the spline,
         // which requires strictly increasing time.
-        int icol;
-        for (icol = 0; icol < numStates; ++icol)
-            m_states.updCol(icol).setTo(
-                    table.getDependentColumnAtIndex(icol).getElt(0, 0));
-        for (int icontr = 0; icontr < numControls; ++icontr, ++icol)
-            m_controls.updCol(icontr).setTo(
-                    table.getDependentColumnAtIndex(icol).getElt(0, 0));
-        for (int imult = 0; imult < numMultipliers; ++imult, ++icol)
-            m_multipliers.updCol(imult).setTo(
-                    table.getDependentColumnAtIndex(icol).getElt(0, 0));
-        for (int ideriv = 0; ideriv < numDerivatives; ++ideriv, ++icol)
-            m_derivatives.updCol(ideriv).setTo(
-                    table.getDependentColumnAtIndex(icol).getElt(0, 0));
-        for (int islack = 0; islack < numSlacks; ++islack, ++icol)
-            m_slacks.updCol(islack).setTo(
-                    table.getDependentColumnAtIndex(icol).getElt(0, 0));
-
+        auto setToInitialValues = [numTimes](SimTK::Matrix& matrix) {
+            const SimTK::RowVector initial = matrix.row(0);
+            matrix.resize(numTimes, matrix.ncol());
+            for (int itime = 0; itime < numTimes; ++itime) {
+                matrix.updRow(itime) = initial;
+            }
+        };
+        setToInitialValues(m_states);
+        setToInitialValues(m_controls);
+        setToInitialValues(m_multipliers);
+        setToInitialValues(m_derivatives);
+        setToInitialValues(m_slacks);
     } else {
-        SimTK::Vector curTime(1);
-        for (int itime = 0; itime < m_time.size(); ++itime) {
-            curTime[0] = m_time[itime];
-            int icol;
-            for (icol = 0; icol < numStates; ++icol)
-                m_states(itime, icol) = splines[icol].calcValue(curTime);
-            for (int icontr = 0; icontr < numControls; ++icontr, ++icol)
-                m_controls(itime, icontr) = splines[icol].calcValue(curTime);
-            for (int imult = 0; imult < numMultipliers; ++imult, ++icol)
-                m_multipliers(itime, imult) = splines[icol].calcValue(curTime);
-            for (int ideriv = 0; ideriv < numDerivatives; ++ideriv, ++icol)
-                m_derivatives(itime, ideriv) = splines[icol].calcValue(curTime);
-            for (int islack = 0; islack < numSlacks; ++islack, ++icol)
-                m_slacks(itime, islack) = splines[icol].calcValue(curTime);
-        }
+        // Each call locates the new times in the existing time vector once
+        // and interpolates all columns of the matrix with a cubic spline.
+        m_states = interpolateColumns(m_time, m_states, time, true);
+        m_controls = interpolateColumns(m_time, m_controls, time, true);
+        m_multipliers = interpolateColumns(m_time, m_multipliers, time, true);
+        m_derivatives = interpolateColumns(m_time, m_derivatives, time, true);
+        m_slacks = interpolateColumns(m_time, m_slacks, time, true);
     }
+    m_time = std::move(time);
 }
 
 MocoTrajectory::MocoTrajectory(const std::string& filepath) {
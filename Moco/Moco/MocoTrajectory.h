@@ -201,10 +201,9 @@ public:
     /// Uniformly resample (interpolate) the trajectory so that it retains the
     /// same initial and final times but now has the provided number of time
     /// points.
-    /// Resampling is done by creating a 5-th degree GCV spline of the states
-    /// and controls and evaluating the spline at the `numTimes` time points.
-    /// The degree is reduced as necessary if getNumTimes() < 6, and
-    /// resampling is not possible if getNumTimes() < 2.
+    /// Resampling is done by creating a natural cubic spline of each
+    /// variable and evaluating the spline at the `numTimes` time points.
+    /// Resampling is not possible if getNumTimes() < 2.
     /// @returns the resulting time interval between time points.
     double resampleWithNumTimes(int numTimes);
     /// Uniformly resample (interpolate) the trajectory to try to achieve the
@@ -212,24 +211,24 @@ public:
     /// initial and final times. The resulting time interval may be shorter
     /// than what you request (in order to preserve initial and
     /// final times), and is returned by this function.
-    /// Resampling is done by creating a 5-th degree GCV spline of the states
-    /// and controls and evaluating the spline at the new time points.
-    /// The degree is reduced as necessary if getNumTimes() < 6, and
-    /// resampling is not possible if getNumTimes() < 2.
+    /// Resampling is done by creating a natural cubic spline of each
+    /// variable and evaluating the spline at the new time points.
+    /// Resampling is not possible if getNumTimes() < 2.
     double resampleWithInterval(double desiredTimeInterval);
     /// Uniformly resample (interpolate) the trajectory to try to achieve the
     /// provided frequency of time points per second of the trajectory, while
     /// preserving the initial and final times. The resulting frequency may be
     /// higher than what you request (in order to preserve initial and final
     /// times), and is returned by this function.
-    /// Resampling is done by creating a 5-th degree GCV spline of the states
-    /// and controls and evaluating the spline at the new time points.
-    /// The degree is reduced as necessary if getNumTimes() < 6, and
-    /// resampling is not possible if getNumTimes() < 2.
+    /// Resampling is done by creating a natural cubic spline of each
+    /// variable and evaluating the spline at the new time points.
+    /// Resampling is not possible if getNumTimes() < 2.
     double resampleWithFrequency(double desiredNumTimePointsPerSecond);
     /// Resample (interpolate) the data in this trajectory at the provided
-    /// times. If all times have the same value (e.g., 0.0), then the value of
-    /// each variable for all time is its previous value at the initial time.
+    /// times, using a natural cubic spline of each variable (see
+    /// interpolateColumns()). If all times have the same value (e.g., 0.0),
+    /// then the value of each variable for all time is its previous value at
+    /// the initial time.
     /// @throws Exception if new times are not within existing initial and final
     /// times, if the new times are decreasing, or if getNumTimes() < 2.
     void resample(SimTK::Vector newTime);
@@ -379,16 +378,18 @@ public:
     void setStatesTrajectory(const TimeSeriesTable& states,
             bool allowMissingColumns = false, bool allowExtraColumns = false);
 
-    /// Add additional state columns. The provided data are interpolated using
-    /// GCV splines to match the times in this trajectory. By default, we do not
-    /// overwrite data for states that already exist in the trajectory; you can
-    /// change this behavior with `overwrite`.
+    /// Add additional state columns. If the times in the table differ from
+    /// the times in this trajectory, the provided data are interpolated
+    /// using GCV splines to match the times in this trajectory; otherwise,
+    /// the data are copied. By default, we do not overwrite data for states
+    /// that already exist in the trajectory; you can change this behavior
+    /// with `overwrite`.
     void insertStatesTrajectory(
             const TimeSeriesTable& subsetOfStates, bool overwrite = false);
-    /// Add additional control columns. The provided data are interpolated using
-    /// GCV splines to match the times in this trajectory. By default, we do not
-    /// overwrite data for controls that already exist in the trajectory; you
-    /// can change this behavior with `overwrite`.
+    /// Add additional control columns. The provided data are interpolated
+    /// as in insertStatesTrajectory(). By default, we do not overwrite data
+    /// for controls that already exist in the trajectory; you can change this
+    /// behavior with `overwrite`.
     void insertControlsTrajectory(
             const TimeSeriesTable& subsetOfControls, bool overwrite = false);
 
@@ -694,6 +695,12 @@ private:
         return std::find(v.cbegin(), v.cend(), elem);
     }
     void randomize(bool add, const SimTK::Random& randGen);
+    /// Insert the columns of the table into the trajectory, whose columns
+    /// have the provided names (see insertStatesTrajectory()). The names and
+    /// trajectory must be members of this trajectory (e.g., m_state_names and
+    /// m_states).
+    void insertColumns(const TimeSeriesTable& table, bool overwrite,
+            std::vector<std::string>& names, SimTK::Matrix& trajectory);
     SimTK::Vector m_time;
     std::vector<std::string> m_state_names;
     std::vector<std::string> m_control_names;
@@ -851,6 +858,10 @@ private:
     double m_solverDuration = -1;
     // Allow solvers to set success, status, and construct a solution.
     friend class MocoSolver;
+    // Allow loading solutions from the solution cache.
+    friend class MocoSolutionCache;
+    // Allow stitching the solutions of time windows.
+    friend class MocoInverse;
 };
 
 } // namespace OpenSim
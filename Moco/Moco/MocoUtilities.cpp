@@ -18,18 +18,28 @@
 
 #include "MocoUtilities.h"
 
+#include "Common/ProcessorCache.h"
 #include "MocoProblem.h"
 #include "MocoTrajectory.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdarg>
 #include <cstdio>
+#include <future>
 #include <iomanip>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <thread>
 
 #include <simbody/internal/Visualizer_InputListener.h>
 
 #include <OpenSim/Actuators/CoordinateActuator.h>
 #include <OpenSim/Common/GCVSpline.h>
 #include <OpenSim/Common/PiecewiseLinearFunction.h>
+#include <OpenSim/Common/Signal.h>
 #include <OpenSim/Common/TimeSeriesTable.h>
 #include <OpenSim/Simulation/Control/PrescribedController.h>
 #include <OpenSim/Simulation/Manager/Manager.h>
@@ -129,13 +139,114 @@ SimTK::Vector OpenSim::interpolate(const SimTK::Vector& x,
     OPENSIM_THROW_IF(x_no_nans.empty(), Exception,
             "Input vectors are empty (perhaps after removing NaNs).");
 
-    PiecewiseLinearFunction function(
-            (int)x_no_nans.size(), &x_no_nans[0], &y_no_nans[0]);
-    SimTK::Vector newY(newX.size(), SimTK::NaN);
-    for (int i = 0; i < newX.size(); ++i) {
-        const auto& newXi = newX[i];
-        if (x_no_nans[0] <= newXi && newXi <= x_no_nans[x_no_nans.size() - 1])
-            newY[i] = function.calcValue(SimTK::Vector(1, newXi));
+    const int size = (int)x_no_nans.size();
+    return interpolateColumns(SimTK::Vector(size, x_no_nans.data()),
+            SimTK::Matrix(size, 1, y_no_nans.data()), newX)
+            .col(0);
+}
+
+SimTK::Matrix OpenSim::interpolateColumns(const SimTK::Vector& x,
+        const SimTK::Matrix& y, const SimTK::Vector& newX, bool cubic) {
+    const int n = x.size();
+    OPENSIM_THROW_IF(n == 0, Exception, "Expected x to be non-empty.");
+    OPENSIM_THROW_IF(y.nrow() != n, Exception,
+            "Expected number of rows of y to equal size of x, but y has {} "
+            "rows and size of x is {}.",
+            y.nrow(), n);
+    // Copy x into a contiguous buffer for fast searching.
+    std::vector<double> xs(n);
+    for (int i = 0; i < n; ++i) xs[i] = x[i];
+    for (int i = 1; i < n; ++i) {
+        OPENSIM_THROW_IF(xs[i] < xs[i - 1] || (cubic && xs[i] == xs[i - 1]),
+                Exception,
+                "Expected x to be {}increasing, but x[{}] = {} and "
+                "x[{}] = {}.",
+                cubic ? "strictly " : "non-", i - 1, xs[i - 1], i, xs[i]);
+    }
+    const int numColumns = y.ncol();
+    const int numNewX = newX.size();
+    SimTK::Matrix newY(numNewX, numColumns, SimTK::NaN);
+    if (numColumns == 0) return newY;
+
+    // For each new value of x, find the interval [x[i], x[i + 1]] that
+    // contains it, and the weights of the values and (for the cubic spline)
+    // second derivatives at the ends of the interval. These are the same for
+    // all columns.
+    std::vector<int> interval(numNewX, -1);
+    std::vector<std::array<double, 4>> weights(numNewX);
+    for (int k = 0; k < numNewX; ++k) {
+        const double t = newX[k];
+        if (!(xs[0] <= t && t <= xs[n - 1])) continue;
+        if (n == 1) {
+            interval[k] = 0;
+            weights[k] = {1, 0, 0, 0};
+            continue;
+        }
+        const int i = std::min(n - 2,
+                (int)(std::upper_bound(xs.begin(), xs.end(), t) -
+                        xs.begin()) - 1);
+        interval[k] = i;
+        const double h = xs[i + 1] - xs[i];
+        // Avoid dividing by zero for repeated values of x.
+        const double b = h > 0 ? (t - xs[i]) / h : 0;
+        const double a = 1 - b;
+        weights[k] = {a, b, (a * a * a - a) * h * h / 6,
+                (b * b * b - b) * h * h / 6};
+    }
+
+    // The second derivatives of a natural cubic spline solve a tridiagonal
+    // system whose matrix depends only on x, so we factor the matrix (with
+    // the Thomas algorithm) once for all columns.
+    std::vector<double> upper;
+    std::vector<double> diagonal;
+    if (cubic && n > 2) {
+        upper.resize(n);
+        diagonal.resize(n);
+        for (int i = 1; i < n - 1; ++i) {
+            const double hPrev = xs[i] - xs[i - 1];
+            const double h = xs[i + 1] - xs[i];
+            diagonal[i] = 2 * (hPrev + h);
+            if (i > 1) diagonal[i] -= hPrev * upper[i - 1];
+            upper[i] = h / diagonal[i];
+        }
+    }
+
+    // Process one column at a time, so that all memory accesses are to
+    // contiguous buffers.
+    std::vector<double> values(n);
+    std::vector<double> secondDerivs(n, 0.0);
+    for (int icol = 0; icol < numColumns; ++icol) {
+        const SimTK::VectorView column = y.col(icol);
+        for (int i = 0; i < n; ++i) values[i] = column[i];
+        if (cubic && n > 2) {
+            // Forward elimination and back substitution.
+            for (int i = 1; i < n - 1; ++i) {
+                const double hPrev = xs[i] - xs[i - 1];
+                const double h = xs[i + 1] - xs[i];
+                double rhs = 6 * ((values[i + 1] - values[i]) / h -
+                                         (values[i] - values[i - 1]) / hPrev);
+                if (i > 1) rhs -= hPrev * secondDerivs[i - 1];
+                secondDerivs[i] = rhs / diagonal[i];
+            }
+            for (int i = n - 3; i >= 1; --i) {
+                secondDerivs[i] -= upper[i] * secondDerivs[i + 1];
+            }
+        }
+        SimTK::VectorView newColumn = newY.updCol(icol);
+        for (int k = 0; k < numNewX; ++k) {
+            const int i = interval[k];
+            if (i < 0) continue;
+            const auto& w = weights[k];
+            if (n == 1) {
+                newColumn[k] = values[0];
+            } else if (cubic) {
+                newColumn[k] = w[0] * values[i] + w[1] * values[i + 1] +
+                               w[2] * secondDerivs[i] +
+                               w[3] * secondDerivs[i + 1];
+            } else {
+                newColumn[k] = w[0] * values[i] + w[1] * values[i + 1];
+            }
+        }
     }
     return newY;
 }
@@ -196,6 +307,129 @@ void OpenSim::updateStateLabels40(const Model& model,
     }
 }
 
+namespace {
+struct GCVSplineSetFit {
+    std::size_t hash;
+    TimeSeriesTable table;
+    /// Ready once the fit (by the thread that inserted this entry) finishes.
+    std::shared_future<std::shared_ptr<const GCVSplineSet>> splines;
+    int id;
+};
+/// The number of values (times and data) in the table of a fit; the size of
+/// the fit itself is proportional to this.
+std::size_t getNumValues(const TimeSeriesTable& table) {
+    return table.getNumRows() * (table.getNumColumns() + 1);
+}
+struct GCVSplineSetFits {
+    static const std::size_t maxNumFits = 16;
+    /// Fits are retained only while their tables have at most this many
+    /// values in total (about 8 MB of tables).
+    static const std::size_t maxNumValues = 1 << 20;
+    std::mutex mutex;
+    /// Most recently used fits are at the front.
+    std::list<GCVSplineSetFit> fits;
+    std::size_t numValues = 0;
+    int nextId = 0;
+    /// Remove the least recently used fits until the limits are satisfied.
+    void shrink() {
+        while (!fits.empty() &&
+                (fits.size() > maxNumFits || numValues > maxNumValues)) {
+            numValues -= getNumValues(fits.back().table);
+            fits.pop_back();
+        }
+    }
+};
+GCVSplineSetFits& getGCVSplineSetFits() {
+    static GCVSplineSetFits fits;
+    return fits;
+}
+bool tablesAreIdentical(const TimeSeriesTable& a, const TimeSeriesTable& b) {
+    if (a.getColumnLabels() != b.getColumnLabels()) return false;
+    if (a.getIndependentColumn() != b.getIndependentColumn()) return false;
+    const auto& matrixA = a.getMatrix();
+    const auto& matrixB = b.getMatrix();
+    for (int irow = 0; irow < matrixA.nrow(); ++irow) {
+        for (int icol = 0; icol < matrixA.ncol(); ++icol) {
+            const double& valueA = matrixA(irow, icol);
+            const double& valueB = matrixB(irow, icol);
+            if (valueA != valueB &&
+                    !(SimTK::isNaN(valueA) && SimTK::isNaN(valueB))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // anonymous namespace
+
+GCVSplineSet OpenSim::createGCVSplineSetReusingFits(
+        const TimeSeriesTable& table) {
+    auto& cache = getGCVSplineSetFits();
+    const std::size_t numValues = getNumValues(table);
+    // Tables too large to retain are fit without consulting the cache.
+    if (numValues > GCVSplineSetFits::maxNumValues) {
+        return GCVSplineSet(table);
+    }
+
+    const std::size_t hash = ProcessorCache::hashTable(table);
+    std::shared_future<std::shared_ptr<const GCVSplineSet>> existing;
+    std::promise<std::shared_ptr<const GCVSplineSet>> promise;
+    int id = -1;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto& fits = cache.fits;
+        for (auto it = fits.begin(); it != fits.end(); ++it) {
+            if (it->hash == hash && tablesAreIdentical(it->table, table)) {
+                fits.splice(fits.begin(), fits, it);
+                existing = fits.front().splines;
+                break;
+            }
+        }
+        if (!existing.valid()) {
+            id = cache.nextId++;
+            fits.push_front({hash, table, promise.get_future().share(), id});
+            cache.numValues += numValues;
+            cache.shrink();
+        }
+    }
+    // If another thread is still fitting this table, wait for it (without
+    // holding the lock) rather than fitting the table again.
+    if (existing.valid()) return *existing.get();
+
+    // Fit without holding the lock, so that fits of other tables can proceed
+    // concurrently.
+    try {
+        std::shared_ptr<const GCVSplineSet> splines(new GCVSplineSet(table));
+        promise.set_value(splines);
+        return *splines;
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+        // Let later calls try again.
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        for (auto it = cache.fits.begin(); it != cache.fits.end(); ++it) {
+            if (it->id == id) {
+                cache.numValues -= numValues;
+                cache.fits.erase(it);
+                break;
+            }
+        }
+        throw;
+    }
+}
+
+void OpenSim::clearGCVSplineSetFits() {
+    auto& cache = getGCVSplineSetFits();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.fits.clear();
+    cache.numValues = 0;
+}
+
+int OpenSim::getNumGCVSplineSetFits() {
+    auto& cache = getGCVSplineSetFits();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return (int)cache.fits.size();
+}
+
 TimeSeriesTable OpenSim::filterLowpass(
         const TimeSeriesTable& table, double cutoffFreq, bool padData) {
     OPENSIM_THROW_IF(cutoffFreq < 0, Exception,
@@ -207,6 +441,59 @@ TimeSeriesTable OpenSim::filterLowpass(
     return storage.exportToTable();
 }
 
+TimeSeriesTable OpenSim::filterLowpassWithoutStorage(
+        const TimeSeriesTable& table, double cutoffFreq, bool padData) {
+    OPENSIM_THROW_IF(cutoffFreq < 0, Exception,
+            "Cutoff frequency must be non-negative; got {}.", cutoffFreq);
+    const int numRows = (int)table.getNumRows();
+    OPENSIM_THROW_IF(numRows < 2, Exception,
+            "Expected the table to have at least 2 rows, but it has {}.",
+            numRows);
+    const int numPad = padData ? numRows / 2 : 0;
+
+    // Pad the times just as Storage::pad() does.
+    const auto& time = table.getIndependentColumn();
+    Array<double> paddedTime(0.0, numRows);
+    std::copy(time.begin(), time.end(), &paddedTime[0]);
+    Signal::Pad(numPad, paddedTime);
+    const int numPaddedRows = paddedTime.getSize();
+
+    // Storage::lowpassIIR() requires uniformly-spaced times.
+    double minTimeStep = SimTK::Infinity;
+    for (int i = 1; i < numPaddedRows; ++i) {
+        minTimeStep = std::min(minTimeStep, paddedTime[i] - paddedTime[i - 1]);
+    }
+    const double avgTimeStep =
+            (paddedTime[numPaddedRows - 1] - paddedTime[0]) /
+            (numPaddedRows - 1);
+    OPENSIM_THROW_IF(avgTimeStep - minTimeStep > SimTK::Eps, Exception,
+            "Expected the table to have uniformly-spaced times, but the "
+            "average time step is {} and the minimum time step is {}.",
+            avgTimeStep, minTimeStep);
+
+    const int numColumns = (int)table.getNumColumns();
+    SimTK::Matrix filtered(numPaddedRows, numColumns);
+    Array<double> column(0.0, numRows);
+    std::vector<double> filteredColumn(numPaddedRows);
+    const auto& matrix = table.getMatrix();
+    for (int icol = 0; icol < numColumns; ++icol) {
+        column.setSize(numRows);
+        for (int irow = 0; irow < numRows; ++irow) {
+            column[irow] = matrix(irow, icol);
+        }
+        Signal::Pad(numPad, column);
+        Signal::LowpassIIR(minTimeStep, cutoffFreq, numPaddedRows, &column[0],
+                filteredColumn.data());
+        for (int irow = 0; irow < numPaddedRows; ++irow) {
+            filtered(irow, icol) = filteredColumn[irow];
+        }
+    }
+
+    std::vector<double> newTime(
+            &paddedTime[0], &paddedTime[0] + numPaddedRows);
+    return TimeSeriesTable(newTime, filtered, table.getColumnLabels());
+}
+
 void OpenSim::writeTableToFile(
         const TimeSeriesTable& table, const std::string& filepath) {
     DataAdapter::InputTables tables = {{"table", &table}};
@@ -428,6 +715,40 @@ void OpenSim::prescribeControlsToModel(
     model.addController(controller);
 }
 
+namespace {
+/// Obtain the index in SimTK::State::getY() of each state variable in the
+/// trajectory. The trajectory must contain all of the model's state
+/// variables.
+std::vector<int> createTrajectoryStateYIndices(
+        const Model& model, const MocoTrajectory& trajectory) {
+    const auto yIndexMap = createSystemYIndexMap(model);
+    const auto& stateNames = trajectory.getStateNames();
+    OPENSIM_THROW_IF(stateNames.size() != yIndexMap.size(), Exception,
+            "Expected the trajectory to contain {} states, but it contains "
+            "{}.",
+            yIndexMap.size(), stateNames.size());
+    std::vector<int> yIndices;
+    for (const auto& name : stateNames) {
+        const auto it = yIndexMap.find(name);
+        OPENSIM_THROW_IF(it == yIndexMap.end(), Exception,
+                "State '{}' in the trajectory is not in the model.", name);
+        yIndices.push_back(it->second);
+    }
+    return yIndices;
+}
+/// Set the time and state variables of `state` using the values in the
+/// trajectory at time index `itime`. This avoids creating a Storage or
+/// StatesTrajectory.
+void setStateFromTrajectory(const MocoTrajectory& trajectory, int itime,
+        const std::vector<int>& yIndices, SimTK::State& state) {
+    state.setTime(trajectory.getTime()[itime]);
+    const auto& states = trajectory.getStatesTrajectory();
+    for (int isv = 0; isv < (int)yIndices.size(); ++isv) {
+        state.updY()[yIndices[isv]] = states(itime, isv);
+    }
+}
+} // anonymous namespace
+
 MocoTrajectory OpenSim::simulateTrajectoryWithTimeStepping(
         const MocoTrajectory& trajectory, Model model,
         double integratorAccuracy) {
@@ -443,20 +764,11 @@ MocoTrajectory OpenSim::simulateTrajectoryWithTimeStepping(
     // Simulate!
     const SimTK::Vector& time = trajectory.getTime();
     SimTK::State state = model.initSystem();
-    state.setTime(time[0]);
     Manager manager(model);
 
     // Set the initial state.
-    {
-        const auto& matrix = trajectory.getStatesTrajectory();
-        TimeSeriesTable initialStateTable(
-                std::vector<double>{trajectory.getInitialTime()},
-                SimTK::Matrix(matrix.block(0, 0, 1, matrix.ncol())),
-                trajectory.getStateNames());
-        auto statesTraj = StatesTrajectory::createFromStatesStorage(
-                model, convertTableToStorage(initialStateTable));
-        state.setY(statesTraj.front().getY());
-    }
+    setStateFromTrajectory(trajectory, 0,
+            createTrajectoryStateYIndices(model, trajectory), state);
 
     if (integratorAccuracy != -1) {
         manager.getIntegrator().setAccuracy(integratorAccuracy);
@@ -487,6 +799,111 @@ MocoTrajectory OpenSim::simulateTrajectoryWithTimeStepping(
     return forwardSolution;
 }
 
+TimeSeriesTable OpenSim::simulateTrajectorySegmentsWithTimeStepping(
+        const MocoTrajectory& trajectory, Model model,
+        int numIntervalsPerSegment, double integratorAccuracy, int parallel) {
+    OPENSIM_THROW_IF(numIntervalsPerSegment < 1, Exception,
+            "Expected numIntervalsPerSegment to be at least 1, but got {}.",
+            numIntervalsPerSegment);
+    OPENSIM_THROW_IF(parallel < -1, Exception,
+            "Expected parallel to be -1 or greater, but got {}.", parallel);
+    const int numTimes = trajectory.getNumTimes();
+    OPENSIM_THROW_IF(numTimes < 2, Exception,
+            "Expected the trajectory to have at least 2 times, but it has {}.",
+            numTimes);
+
+    prescribeControlsToModel(trajectory, model, "PiecewiseLinearFunction");
+    model.initSystem();
+    const std::vector<int> yIndices =
+            createTrajectoryStateYIndices(model, trajectory);
+
+    // Segment iseg spans time indices [segmentStart[iseg],
+    // segmentStart[iseg + 1]].
+    std::vector<int> segmentStart;
+    for (int itime = 0; itime < numTimes - 1;
+            itime += numIntervalsPerSegment) {
+        segmentStart.push_back(itime);
+    }
+    segmentStart.push_back(numTimes - 1);
+    const int numSegments = (int)segmentStart.size() - 1;
+
+    if (parallel == -1) {
+        const int parallelEV = getMocoParallelEnvironmentVariable();
+        parallel = parallelEV == -1 ? 1 : parallelEV;
+    }
+    int numThreads;
+    if (parallel == 0) {
+        numThreads = 1;
+    } else if (parallel == 1) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    } else {
+        numThreads = parallel;
+    }
+    numThreads = std::min(numThreads, numSegments);
+
+    const auto& trajStates = trajectory.getStatesTrajectory();
+    const int numStates = (int)yIndices.size();
+    SimTK::Matrix drift(numSegments, numStates);
+
+    // Each thread simulates segments using its own copy of the model, and
+    // takes the next available segment when it finishes one.
+    std::atomic<int> nextSegment(0);
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+    auto simulateSegments = [&](Model& threadModel) {
+        try {
+            SimTK::State state = threadModel.initSystem();
+            int iseg;
+            while ((iseg = nextSegment++) < numSegments) {
+                const int istart = segmentStart[iseg];
+                const int iend = segmentStart[iseg + 1];
+                setStateFromTrajectory(trajectory, istart, yIndices, state);
+                Manager manager(threadModel);
+                if (integratorAccuracy != -1) {
+                    manager.getIntegrator().setAccuracy(integratorAccuracy);
+                }
+                manager.initialize(state);
+                const SimTK::State& finalState =
+                        manager.integrate(trajectory.getTime()[iend]);
+                for (int isv = 0; isv < numStates; ++isv) {
+                    drift(iseg, isv) = finalState.getY()[yIndices[isv]] -
+                                       trajStates(iend, isv);
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+            if (!exception) exception = std::current_exception();
+            // Prevent other threads from starting new segments.
+            nextSegment = numSegments;
+        }
+    };
+
+    if (numThreads == 1) {
+        simulateSegments(model);
+    } else {
+        std::vector<std::unique_ptr<Model>> threadModels;
+        std::vector<std::thread> threads;
+        for (int ithread = 0; ithread < numThreads; ++ithread) {
+            threadModels.emplace_back(new Model(model));
+        }
+        for (int ithread = 0; ithread < numThreads; ++ithread) {
+            threads.emplace_back(
+                    simulateSegments, std::ref(*threadModels[ithread]));
+        }
+        for (auto& thread : threads) { thread.join(); }
+    }
+    if (exception) std::rethrow_exception(exception);
+
+    std::vector<double> segmentEndTimes(numSegments);
+    for (int iseg = 0; iseg < numSegments; ++iseg) {
+        segmentEndTimes[iseg] = trajectory.getTime()[segmentStart[iseg + 1]];
+    }
+    TimeSeriesTable table(segmentEndTimes, drift, trajectory.getStateNames());
+    table.addTableMetaData<std::string>(
+            "num_intervals_per_segment", std::to_string(numIntervalsPerSegment));
+    return table;
+}
+
 std::vector<std::string> OpenSim::createStateVariableNamesInSystemOrder(
         const Model& model) {
     std::unordered_map<int, int> yIndexMap;
@@ -762,6 +1179,34 @@ MocoTrajectory OpenSim::createPeriodicTrajectory(
 }
 
 
+void OpenSim::runTasksInParallel(int numTasks, int numThreads,
+        const std::function<void(int)>& task) {
+    std::atomic<int> nextTask(0);
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+    auto runTasks = [&]() {
+        try {
+            int itask;
+            while ((itask = nextTask++) < numTasks) task(itask);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+            if (!exception) exception = std::current_exception();
+            // Prevent other threads from starting new tasks.
+            nextTask = numTasks;
+        }
+    };
+    if (numThreads <= 1) {
+        runTasks();
+    } else {
+        std::vector<std::thread> threads;
+        for (int ithread = 0; ithread < numThreads; ++ithread) {
+            threads.emplace_back(runTasks);
+        }
+        for (auto& thread : threads) { thread.join(); }
+    }
+    if (exception) std::rethrow_exception(exception);
+}
+
 int OpenSim::getMocoParallelEnvironmentVariable() {
     const std::string varName = "OPENSIM_MOCO_PARALLEL";
     if (SimTK::Pathname::environmentVariableExists(varName)) {
@@ -885,3 +1330,60 @@ SimTK::Real OpenSim::solveBisection(
     }
     return midpoint;
 }
+
+SimTK::Real OpenSim::solveBracketedNewton(
+        std::function<SimTK::Real(const SimTK::Real&, SimTK::Real&)>
+                calcResidualAndDerivative,
+        SimTK::Real left, SimTK::Real right, const SimTK::Real& tolerance,
+        int maxIterations) {
+    OPENSIM_THROW_IF(maxIterations < 0, Exception,
+            "Expected maxIterations to be positive, but got {}.",
+            maxIterations);
+
+    SimTK::Real derivative;
+    const SimTK::Real residualLeft =
+            calcResidualAndDerivative(left, derivative);
+    if (residualLeft == 0) return left;
+    const SimTK::Real residualRight =
+            calcResidualAndDerivative(right, derivative);
+    if (residualRight == 0) return right;
+    OPENSIM_THROW_IF(residualLeft * residualRight > 0, Exception,
+            "Function has same sign at bounds of {} and {}.", left, right);
+
+    // Orient the bracket so that the residual is negative at xNeg.
+    SimTK::Real xNeg = residualLeft < 0 ? left : right;
+    SimTK::Real xPos = residualLeft < 0 ? right : left;
+
+    SimTK::Real x = 0.5 * (left + right);
+    SimTK::Real stepPrev = std::abs(right - left);
+    SimTK::Real step = stepPrev;
+    SimTK::Real residual = calcResidualAndDerivative(x, derivative);
+    for (int iter = 0; iter < maxIterations; ++iter) {
+        const bool newtonLeavesBracket =
+                ((x - xPos) * derivative - residual) *
+                        ((x - xNeg) * derivative - residual) >
+                0;
+        const bool newtonTooSlow =
+                std::abs(2.0 * residual) > std::abs(stepPrev * derivative);
+        if (!SimTK::isFinite(derivative) || derivative == 0 ||
+                newtonLeavesBracket || newtonTooSlow) {
+            stepPrev = step;
+            step = 0.5 * (xPos - xNeg);
+            x = xNeg + step;
+        } else {
+            stepPrev = step;
+            step = residual / derivative;
+            x -= step;
+        }
+        if (std::abs(step) < tolerance) return x;
+        residual = calcResidualAndDerivative(x, derivative);
+        if (residual == 0) return x;
+        if (residual < 0) {
+            xNeg = x;
+        } else {
+            xPos = x;
+        }
+    }
+    log_warn("Bracketed Newton reached max iterations at x = {}.", x);
+    return x;
+}
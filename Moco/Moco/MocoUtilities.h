@@ -32,6 +32,7 @@
 #include <Simulation/Model/Model.h>
 #include <Simulation/StatesTrajectory.h>
 #include <condition_variable>
+#include <functional>
 #include <regex>
 #include <set>
 #include <stack>
@@ -136,6 +137,21 @@ OSIMMOCO_API
 SimTK::Vector interpolate(const SimTK::Vector& x, const SimTK::Vector& y,
         const SimTK::Vector& newX, const bool ignoreNaNs = false);
 
+/// Interpolate each column of y(x) at new values of x, using piecewise
+/// linear interpolation or, if 'cubic' is true, a natural cubic spline. The
+/// interval of x containing each new value of x, and the interpolation
+/// weights, are computed once and applied to all columns, so this is much
+/// faster than interpolating each column separately for matrices with many
+/// columns. The result has NaN in the rows for any values of newX outside of
+/// the range of x. The values in newX need not be sorted.
+/// @throws Exception if x is empty, the number of rows of y is not the size
+/// of x, or x is decreasing (or, for the cubic spline, not strictly
+/// increasing).
+/// @ingroup moconumutil
+OSIMMOCO_API
+SimTK::Matrix interpolateColumns(const SimTK::Vector& x, const SimTK::Matrix& y,
+        const SimTK::Vector& newX, bool cubic = false);
+
 #ifndef SWIG
 /// @ingroup moconumutil
 template <typename FunctionType>
@@ -159,6 +175,33 @@ inline std::unique_ptr<FunctionSet> createFunctionSet<GCVSpline>(
     return std::unique_ptr<GCVSplineSet>(new GCVSplineSet(table,
             std::vector<std::string>{}, std::min((int)time.size() - 1, 5)));
 }
+
+/// Create a GCVSplineSet with a 5th-order spline for each column of the table,
+/// like GCVSplineSet(table), but reuse the fit from a recent call with an
+/// identical table, if there was one. This is useful when many copies of an
+/// object fit splines to the same reference data (e.g., the goals in the
+/// MocoProblemRep that a solver creates for each thread). Calling this
+/// concurrently with the same table fits the table only once, while
+/// different tables are fit concurrently. Each call returns a separate copy,
+/// so the returned splines may be used concurrently with those returned by
+/// other calls.
+///
+/// The fits (and a copy of each table) are retained for the life of the
+/// process, shared by all callers, until clearGCVSplineSetFits() is called.
+/// Only the 16 most recently used fits are retained, and only while their
+/// tables have at most about one million values (times and data) in total;
+/// larger tables are fit without being retained.
+/// @ingroup moconumutil
+OSIMMOCO_API
+GCVSplineSet createGCVSplineSetReusingFits(const TimeSeriesTable& table);
+
+/// Release the fits retained by createGCVSplineSetReusingFits().
+/// @ingroup moconumutil
+OSIMMOCO_API void clearGCVSplineSetFits();
+
+/// The number of fits currently retained by createGCVSplineSetReusingFits().
+/// @ingroup moconumutil
+OSIMMOCO_API int getNumGCVSplineSetFits();
 #endif // SWIG
 
 /// Resample (interpolate) the table at the provided times. In general, a
@@ -244,6 +287,14 @@ OSIMMOCO_API void updateStateLabels40(
 OSIMMOCO_API TimeSeriesTable filterLowpass(
         const TimeSeriesTable& table, double cutoffFreq, bool padData = false);
 
+/// Same as filterLowpass(), but filter the columns of the table's matrix
+/// directly, without converting the table to a Storage and back (which copies
+/// the data row by row). The padding (if padData is true) and filter are the
+/// same as those used by Storage. The table must have uniformly-spaced times.
+/// @ingroup moconumutil
+OSIMMOCO_API TimeSeriesTable filterLowpassWithoutStorage(
+        const TimeSeriesTable& table, double cutoffFreq, bool padData = false);
+
 /// Write a single TimeSeriesTable to a file, using the FileAdapter associated
 /// with the provided file extension.
 /// @ingroup moconumutil
@@ -355,6 +406,33 @@ OSIMMOCO_API MocoTrajectory simulateTrajectoryWithTimeStepping(
         const MocoTrajectory& trajectory, Model model,
         double integratorAccuracy = -1);
 
+/// Validate a trajectory by simulating it in independent segments with an ODE
+/// time stepping integrator. The trajectory's time points are divided into
+/// segments of `numIntervalsPerSegment` time intervals (the last segment may
+/// be shorter). Each segment starts from the states in the trajectory at the
+/// beginning of the segment and uses the trajectory's controls
+/// (interpolated linearly, as in simulateTrajectoryWithTimeStepping()).
+/// Because segments do not depend on each other, they are simulated in
+/// parallel.
+///
+/// The returned table has one row per segment, with the time column
+/// containing the final time of the segment, and one column per state in the
+/// trajectory. Each entry is the drift of that state over the segment: the
+/// simulated value minus the trajectory's value at the end of the segment.
+/// Unlike simulateTrajectoryWithTimeStepping(), errors do not accumulate
+/// across the whole trajectory, so large entries localize where the
+/// trajectory does not obey the model's dynamics.
+///
+/// The `parallel` argument has the same meaning as the `parallel` property of
+/// MocoCasADiSolver (0: serial; 1: use all cores; greater than 1: use this
+/// number of threads); if it is -1, we use the OPENSIM_MOCO_PARALLEL
+/// environment variable if it is set, and otherwise use all cores.
+/// @ingroup mocomodelutil
+OSIMMOCO_API TimeSeriesTable simulateTrajectorySegmentsWithTimeStepping(
+        const MocoTrajectory& trajectory, Model model,
+        int numIntervalsPerSegment = 1, double integratorAccuracy = -1,
+        int parallel = -1);
+
 /// The map provides the index of each state variable in
 /// SimTK::State::getY() from its each state variable path string.
 /// Empty slots in Y (e.g., for quaternions) are ignored.
@@ -673,6 +751,14 @@ private:
 /// @ingroup mocogenutil
 OSIMMOCO_API int getMocoParallelEnvironmentVariable();
 
+/// Invoke task(i) for i = 0, ..., numTasks - 1 using numThreads threads (the
+/// calling thread, if numThreads is 1). Each thread takes the next task when
+/// it finishes one. If a task throws an exception, the remaining tasks are
+/// skipped and the exception is rethrown.
+/// @ingroup mocogenutil
+OSIMMOCO_API void runTasksInParallel(int numTasks, int numThreads,
+        const std::function<void(int)>& task);
+
 /// This class lets you store objects of a single type for reuse by multiple
 /// threads, ensuring threadsafe access to each of those objects.
 /// @ingroup mocogenutil
@@ -805,6 +891,29 @@ SimTK::Real solveBisection(
         double left, double right, const double& tolerance = 1e-6,
         int maxIterations = 1000);
 
+/// Solve for the root of a scalar function using Newton's method, safeguarded
+/// by bisection: the root is kept bracketed, and a bisection step is taken
+/// whenever the Newton step would leave the bracket or would not reduce the
+/// residual fast enough (Press et al., Numerical Recipes, rtsafe). This
+/// typically converges in far fewer function evaluations than
+/// solveBisection().
+/// @param calcResidualAndDerivative a function that computes the error and
+///     sets its second argument to the derivative of the error. The
+///     derivative may be approximate (convergence is then slower), and may be
+///     NaN or zero to request a bisection step.
+/// @param left lower bound on the root
+/// @param right upper bound on the root
+/// @param tolerance convergence requires that the last step is smaller than
+///     tolerance.
+/// @param maxIterations abort after this many iterations.
+/// @ingroup mocogenutil
+OSIMMOCO_API
+SimTK::Real solveBracketedNewton(
+        std::function<double(const double&, double&)>
+                calcResidualAndDerivative,
+        double left, double right, const double& tolerance = 1e-6,
+        int maxIterations = 100);
+
 } // namespace OpenSim
 
 #endif // MOCO_MOCOUTILITIES_H
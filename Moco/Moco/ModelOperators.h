@@ -311,6 +311,59 @@ public:
     }
 };
 
+/// Replace the path of each muscle with a polynomial fit to the muscle's
+/// length and moment arms, using ModelFactory::fitPolynomialMusclePaths().
+/// This greatly reduces the cost of evaluating muscle paths with wrapping,
+/// especially when derivatives are computed with finite differences. Check
+/// the fit errors in the log.
+class OSIMMOCO_API ModOpFitPolynomialMusclePaths : public ModelOperator {
+    OpenSim_DECLARE_CONCRETE_OBJECT(
+            ModOpFitPolynomialMusclePaths, ModelOperator);
+    OpenSim_DECLARE_PROPERTY(order, int,
+            "Order of the polynomials (default: 5).");
+    OpenSim_DECLARE_PROPERTY(num_samples, int,
+            "Number of random poses at which to sample the paths "
+            "(default: 1000).");
+    OpenSim_DECLARE_PROPERTY(moment_arm_threshold, double,
+            "A muscle spans a coordinate if the magnitude of its moment arm "
+            "about the coordinate exceeds this value (default: 1e-4).");
+
+public:
+    ModOpFitPolynomialMusclePaths() {
+        constructProperty_order(5);
+        constructProperty_num_samples(1000);
+        constructProperty_moment_arm_threshold(1e-4);
+    }
+    ModOpFitPolynomialMusclePaths(int order, int numSamples)
+            : ModOpFitPolynomialMusclePaths() {
+        set_order(order);
+        set_num_samples(numSamples);
+    }
+    void operate(Model& model, const std::string&) const override {
+        model.finalizeFromProperties();
+        model.finalizeConnections();
+        ModelFactory::fitPolynomialMusclePaths(model, get_order(),
+                get_num_samples(), get_moment_arm_threshold());
+    }
+};
+
+/// Replace the StationPlaneContactForces in the model with
+/// MultiStationPlaneContactForce%s, which compute the same forces for all
+/// stations at once, using
+/// ModelFactory::aggregateStationPlaneContactForces().
+class OSIMMOCO_API ModOpAggregateStationPlaneContactForces
+        : public ModelOperator {
+    OpenSim_DECLARE_CONCRETE_OBJECT(
+            ModOpAggregateStationPlaneContactForces, ModelOperator);
+
+public:
+    void operate(Model& model, const std::string&) const override {
+        model.finalizeFromProperties();
+        model.finalizeConnections();
+        ModelFactory::aggregateStationPlaneContactForces(model);
+    }
+};
+
 class OSIMMOCO_API ModOpReplaceJointsWithWelds : public ModelOperator {
     OpenSim_DECLARE_CONCRETE_OBJECT(ModOpReplaceJointsWithWelds, ModelOperator);
     OpenSim_DECLARE_LIST_PROPERTY(joint_paths, std::string,
@@ -18,6 +18,7 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include "Common/ProcessorCache.h"
 #include "Components/ModelFactory.h"
 #include "osimMocoDLL.h"
 
@@ -106,25 +107,36 @@ public:
     /// Process and obtain the model. If the base model is specified via the
     /// filepath property, the filepath will be evaluated relative to
     /// `relativeToDirectory`, if provided.
+    /// If the ProcessorCache is enabled, the result is cached, and if the same
+    /// source model is processed with the same operators again, the result is
+    /// a copy of the cached model.
     Model process(const std::string& relativeToDirectory = {}) const {
-        Model model;
+        std::string path;
         if (get_filepath().empty()) {
-            if (!getProperty_model().empty()) {
-                model = get_model();
-            } else {
-                OPENSIM_THROW_FRMOBJ(Exception, "No source model.");
-            }
+            OPENSIM_THROW_IF_FRMOBJ(getProperty_model().empty(), Exception,
+                    "No source model.");
         } else {
             OPENSIM_THROW_IF_FRMOBJ(!getProperty_model().empty(), Exception,
                     "Expected either a Model object or a filepath, but "
                     "both were provided.");
-            std::string path = get_filepath();
+            path = get_filepath();
             if (!relativeToDirectory.empty()) {
                 using SimTK::Pathname;
                 path = Pathname::
                         getAbsolutePathnameUsingSpecifiedWorkingDirectory(
                                 relativeToDirectory, path);
             }
+        }
+
+        Model model;
+        const std::string cacheKey = createCacheKey(path, relativeToDirectory);
+        if (!cacheKey.empty() && ProcessorCache::findModel(cacheKey, model)) {
+            return model;
+        }
+
+        if (path.empty()) {
+            model = get_model();
+        } else {
             Model modelFromFile(path);
             model = std::move(modelFromFile);
             model.finalizeFromProperties();
@@ -134,6 +146,12 @@ public:
         for (int i = 0; i < getProperty_operators().size(); ++i) {
             get_operators(i).operate(model, relativeToDirectory);
         }
+        if (!cacheKey.empty()) {
+            // Copies of the model must be able to find their connectees from
+            // the connectee paths.
+            model.finalizeConnections();
+            ProcessorCache::insertModel(cacheKey, model);
+        }
         return model;
     }
 
@@ -152,6 +170,24 @@ public:
 
 private:
     OpenSim_DECLARE_OPTIONAL_PROPERTY(model, Model, "Base model to process.");
+
+    /// Returns an empty string if the result should not be cached.
+    std::string createCacheKey(const std::string& path,
+            const std::string& relativeToDirectory) const {
+        if (!ProcessorCache::getEnabled()) return {};
+        std::string key;
+        if (path.empty()) {
+            key = ProcessorCache::createObjectKeyPart(get_model());
+        } else {
+            key = ProcessorCache::createFileKeyPart(path);
+            if (key.empty()) return {};
+        }
+        key += ProcessorCache::createKeyPart(relativeToDirectory);
+        for (int i = 0; i < getProperty_operators().size(); ++i) {
+            key += ProcessorCache::createObjectKeyPart(get_operators(i));
+        }
+        return key;
+    }
 };
 
 } // namespace OpenSim
@@ -22,6 +22,7 @@
 #include "Components/AccelerationMotion.h"
 #include "Components/DeGrooteFregly2016Muscle.h"
 #include "Components/DiscreteForces.h"
+#include "Components/MultiStationPlaneContactForce.h"
 #include "Components/MultivariatePolynomialFunction.h"
 #include "Components/PositionMotion.h"
 #include "Components/Bhargava2004Metabolics.h"
@@ -123,10 +124,14 @@ OSIMMOCO_API void RegisterTypes_osimMoco() {
         Object::registerType(ModOpScaleActiveFiberForceCurveWidthDGF());
         Object::registerType(ModOpReplaceJointsWithWelds());
         Object::registerType(ModOpScaleMaxIsometricForce());
+        Object::registerType(ModOpFitPolynomialMusclePaths());
+        Object::registerType(ModOpAggregateStationPlaneContactForces());
 
         Object::registerType(AckermannVanDenBogert2010Force());
         Object::registerType(MeyerFregly2016Force());
         Object::registerType(EspositoMiller2018Force());
+        Object::registerType(MultiStationPlaneContactForce_Station());
+        Object::registerType(MultiStationPlaneContactForce());
         Object::registerType(PositionMotion());
         Object::registerType(DeGrooteFregly2016Muscle());
         Object::registerType(MultivariatePolynomialFunction());
@@ -19,6 +19,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "About.h"
+#include "Common/ProcessorCache.h"
 #include "Common/TableProcessor.h"
 #include "Components/DeGrooteFregly2016Muscle.h"
 #include "Components/DiscreteForces.h"
@@ -27,6 +28,7 @@
 #include "Components/PositionMotion.h"
 #include "Components/Bhargava2004Metabolics.h"
 #include "Components/StationPlaneContactForce.h"
+#include "Components/MultiStationPlaneContactForce.h"
 #include "MocoBounds.h"
 #include "MocoCasADiSolver/MocoCasADiSolver.h"
 #include "MocoConstraint.h"
@@ -52,6 +54,8 @@
 #include "MocoInverse.h"
 #include "MocoParameter.h"
 #include "MocoProblem.h"
+#include "MocoRecedingHorizon.h"
+#include "MocoSolutionCache.h"
 #include "MocoSolver.h"
 #include "MocoStudy.h"
 #include "MocoStudyFactory.h"
@@ -536,6 +536,79 @@ TEST_CASE("testStationPlaneContactForce EspositoMiller2018Force") {
 //     testStationPlaneContactForce(createMeyerFregly);
 // }
 
+Model createMultiStationContactModel(CreateContactFunction createContact) {
+    Model model;
+    model.setName("multi_station");
+    auto* body = new Body("body", 10.0, Vec3(0), SimTK::Inertia(1));
+    model.addBody(body);
+    auto* joint = new FreeJoint("joint", model.getGround(), *body);
+    model.addJoint(joint);
+    auto* frame = new PhysicalOffsetFrame("offset", *body,
+            SimTK::Transform(
+                    SimTK::Rotation(0.3, SimTK::ZAxis), Vec3(0.1, -0.05, 0)));
+    body->addComponent(frame);
+    for (int i = 0; i < 6; ++i) {
+        const PhysicalFrame& parent =
+                i < 3 ? static_cast<const PhysicalFrame&>(*body) : *frame;
+        auto* station = new Station(
+                parent, Vec3(0.05 * i - 0.1, -0.02 * (i % 2), 0.03 * i));
+        station->setName("station" + std::to_string(i));
+        model.addComponent(station);
+        auto* force = createContact();
+        force->setName("contact" + std::to_string(i));
+        force->connectSocket_station(*station);
+        model.addForce(force);
+    }
+    return model;
+}
+
+TEST_CASE("MultiStationPlaneContactForce") {
+    auto createContact = GENERATE(as<CreateContactFunction>{}, createAVDB,
+            createEspositoMiller, createMeyerFregly);
+    Model model = createMultiStationContactModel(createContact);
+    ModelProcessor processor =
+            ModelProcessor(model) | ModOpAggregateStationPlaneContactForces();
+    Model aggregated = processor.process();
+    SimTK::State state = model.initSystem();
+    SimTK::State aggState = aggregated.initSystem();
+
+    CHECK(aggregated.countNumComponents<StationPlaneContactForce>() == 0);
+    REQUIRE(aggregated.countNumComponents<MultiStationPlaneContactForce>() ==
+            1);
+    const auto& multi =
+            *aggregated.getComponentList<MultiStationPlaneContactForce>()
+                     .begin();
+    REQUIRE(multi.getNumStations() == 6);
+
+    // Some stations are in contact and some are not.
+    state.updQ() = SimTK::Vector(
+            SimTK::Vec6(0.1, -0.2, 0.15, 0.3, 0.02, -0.1));
+    state.updU() = SimTK::Vector(
+            SimTK::Vec6(0.5, -0.3, 0.2, 0.4, -0.2, 0.1));
+    aggState.updQ() = state.getQ();
+    aggState.updU() = state.getU();
+    model.realizeAcceleration(state);
+    aggregated.realizeAcceleration(aggState);
+
+    SimTK::Vector_<Vec3> forces;
+    multi.calcContactForces(aggState, forces);
+    int numInContact = 0;
+    for (int i = 0; i < 6; ++i) {
+        const auto& contact = model.getComponent<StationPlaneContactForce>(
+                "/forceset/contact" + std::to_string(i));
+        const Vec3 expected = contact.calcContactForceOnStation(state);
+        if (expected[1] > 1.0) ++numInContact;
+        for (int j = 0; j < 3; ++j) {
+            CHECK(forces[i][j] == Approx(expected[j]).margin(1e-10));
+        }
+    }
+    CHECK(numInContact > 0);
+    CHECK(numInContact < 6);
+    for (int i = 0; i < state.getNU(); ++i) {
+        CHECK(aggState.getUDot()[i] == Approx(state.getUDot()[i]));
+    }
+}
+
 TEST_CASE("testSmoothSphereHalfSpaceForce") {
     const SimTK::Real equilibriumHeight =
         testSmoothSphereHalfSpaceForce_NormalForce();
@@ -861,6 +861,31 @@ TEST_CASE("DeGrooteFregly2016Muscle basics") {
             CHECK(muscle.getEquilibriumResidual(state) == Approx(0.0));
         }
 
+        SECTION("equilibrateMuscles") {
+            auto& mutMuscle =
+                    model.updComponent<DeGrooteFregly2016Muscle>("muscle");
+            mutMuscle.set_ignore_tendon_compliance(false);
+            mutMuscle.set_tendon_compliance_dynamics_mode("implicit");
+            mutMuscle.set_pennation_angle_at_optimal(0.12);
+            state = model.initSystem();
+            muscle.setActivation(state, 0.7);
+            coord.setValue(state, muscle.get_optimal_fiber_length() +
+                                          muscle.get_tendon_slack_length());
+            coord.setSpeedValue(state, -0.3);
+
+            SimTK::State stateSingle = state;
+            model.realizeDynamics(stateSingle);
+            muscle.computeInitialFiberEquilibrium(stateSingle);
+
+            DeGrooteFregly2016Muscle::equilibrateMuscles(model, state);
+            CHECK(muscle.getNormalizedTendonForce(state) ==
+                    Approx(muscle.getNormalizedTendonForce(stateSingle))
+                            .margin(1e-10));
+            model.realizeDynamics(state);
+            CHECK(muscle.getEquilibriumResidual(state) ==
+                    Approx(0.0).margin(1e-6));
+        }
+
         SECTION("tendon compliance") {
             auto& mutMuscle =
                     model.updComponent<DeGrooteFregly2016Muscle>("muscle");
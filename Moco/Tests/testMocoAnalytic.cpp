@@ -94,6 +94,52 @@ TEMPLATE_TEST_CASE("Second order linear min effort", "", MocoTropterSolver,
     OpenSim_CHECK_MATRIX_ABSTOL(solution.getStatesTrajectory(), expected, 1e-5);
 }
 
+TEST_CASE("Second order linear min effort, pseudospectral transcription") {
+    // Kirk 1998, Example 5.1-1, page 198.
+    auto transcriptionScheme = GENERATE(as<std::string>{},
+            "legendre-gauss-radau-3", "legendre-gauss-lobatto-3");
+
+    Model model;
+    auto* body = new Body("b", 1, SimTK::Vec3(0), SimTK::Inertia(0));
+    model.addBody(body);
+
+    auto* joint = new SliderJoint("j", model.getGround(), *body);
+    joint->updCoordinate().setName("coord");
+    model.addJoint(joint);
+
+    auto* damper = new SpringGeneralizedForce("coord");
+    damper->setViscosity(-1.0);
+    model.addForce(damper);
+
+    auto* actu = new CoordinateActuator("coord");
+    model.addForce(actu);
+    model.finalizeConnections();
+
+    MocoStudy moco;
+    auto& problem = moco.updProblem();
+
+    problem.setModelCopy(model);
+    problem.setTimeBounds(0, 2);
+    problem.setStateInfo("/jointset/j/coord/value", {-10, 10}, 0, 5);
+    problem.setStateInfo("/jointset/j/coord/speed", {-10, 10}, 0, 2);
+    problem.setControlInfo("/forceset/coordinateactuator", {-50, 50});
+
+    problem.addGoal<MocoControlGoal>("effort", 0.5);
+
+    // Far fewer mesh intervals than in the test above.
+    auto& solver = moco.initSolver<MocoCasADiSolver>();
+    solver.set_transcription_scheme(transcriptionScheme);
+    solver.set_num_mesh_intervals(8);
+    MocoSolution solution = moco.solve();
+
+    // Each mesh interval contains 3 grid points after its start point.
+    CHECK(solution.getNumTimes() == 8 * 3 + 1);
+
+    const auto expected = expectedSolution(solution.getTime());
+
+    OpenSim_CHECK_MATRIX_ABSTOL(solution.getStatesTrajectory(), expected, 1e-5);
+}
+
 /// In the "linear tangent steering" problem, we control the direction to apply
 /// a constant thrust to a point mass to move the mass a given vertical distance
 /// and maximize its final horizontal speed. This problem is described in
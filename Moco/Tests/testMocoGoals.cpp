@@ -766,3 +766,127 @@ TEST_CASE("MocoGoal stage dependency") {
     CHECK_THROWS_WITH(goal.calcGoal(input, goalValue),
             Catch::Contains("calcGoal()") && Catch::Contains("final_state"));
 }
+
+/// The stage dependency of this goal is not specified, so it is audited.
+class MocoStageAuditGoal : public MocoGoal {
+OpenSim_DECLARE_CONCRETE_OBJECT(MocoStageAuditGoal, MocoGoal);
+public:
+    MocoStageAuditGoal() = default;
+    MocoStageAuditGoal(std::string name, double weight)
+            : MocoGoal(std::move(name), weight) {}
+    SimTK::Stage m_realizeIntegrand = SimTK::Stage::Empty;
+    bool m_useMassCenter = false;
+    bool m_specifyAcceleration = false;
+    /// The integrand only realizes the state if the first generalized
+    /// coordinate exceeds this value.
+    SimTK::Real m_realizeAboveQ = -SimTK::Infinity;
+    bool m_throwInGoal = false;
+protected:
+    void initializeOnModelImpl(const Model&) const override {
+        if (m_specifyAcceleration) {
+            setRequirements(1, 1, SimTK::Stage::Acceleration);
+        } else {
+            setRequirements(1, 1);
+        }
+    }
+    void calcIntegrandImpl(const IntegrandInput& input,
+            SimTK::Real& integrand) const override {
+        if (m_realizeIntegrand != SimTK::Stage::Empty &&
+                input.state.getQ()[0] > m_realizeAboveQ) {
+            getModel().getSystem().realize(input.state, m_realizeIntegrand);
+        }
+        integrand = input.state.getY().normSqr();
+    }
+    void calcGoalImpl(
+            const GoalInput& input, SimTK::Vector& values) const override {
+        OPENSIM_THROW_IF_FRMOBJ(m_throwInGoal, Exception, "Invalid input.");
+        values[0] = input.integral;
+        if (m_useMassCenter) {
+            // This requires the state to be realized to Position.
+            values[0] += getModel()
+                                 .calcMassCenterPosition(input.final_state)
+                                 .norm();
+        }
+    }
+};
+
+TEST_CASE("MocoGoal stage dependency audit") {
+    auto model = createSlidingMassModel();
+    SimTK::State state = model->initSystem();
+    const SimTK::Vector controls(model->getNumControls(), 0.0);
+    auto audit = [&](const MocoStageAuditGoal& goal) {
+        goal.initializeOnModel(*model);
+        goal.auditStageDependency(state, controls);
+        return goal.getStageDependency();
+    };
+
+    // Only state variables are used.
+    {
+        MocoStageAuditGoal goal;
+        CHECK(audit(goal) == SimTK::Stage::Time);
+    }
+    // The goal realizes to the stage it requires.
+    {
+        MocoStageAuditGoal goal;
+        goal.m_realizeIntegrand = SimTK::Stage::Velocity;
+        CHECK(audit(goal) == SimTK::Stage::Velocity);
+    }
+    // The goal requires Position without realizing.
+    {
+        MocoStageAuditGoal goal;
+        goal.m_useMassCenter = true;
+        CHECK(audit(goal) == SimTK::Stage::Position);
+    }
+    // The goal realizes to Acceleration.
+    {
+        MocoStageAuditGoal goal;
+        goal.m_realizeIntegrand = SimTK::Stage::Acceleration;
+        CHECK(audit(goal) == SimTK::Stage::Acceleration);
+    }
+    // A stage dependency that is provided explicitly is not changed.
+    {
+        MocoStageAuditGoal goal;
+        goal.m_specifyAcceleration = true;
+        CHECK(audit(goal) == SimTK::Stage::Acceleration);
+    }
+    // The goal realizes to Acceleration only in a branch that the audit
+    // does not exercise; evaluating the goal in this branch is an error that
+    // advises specifying the stage dependency.
+    {
+        MocoStageAuditGoal goal;
+        goal.m_realizeIntegrand = SimTK::Stage::Acceleration;
+        goal.m_realizeAboveQ = 0.5;
+        state.updQ()[0] = 0;
+        CHECK(audit(goal) == SimTK::Stage::Time);
+        SimTK::State branchState(state);
+        branchState.updQ()[0] = 1.0;
+        model->realizeTime(branchState);
+        CHECK_THROWS_WITH(goal.calcIntegrand({0, branchState, controls}),
+                Catch::Contains("lowered from Acceleration") &&
+                        Catch::Contains("setRequirements()"));
+        CHECK(goal.getStageDependency() == SimTK::Stage::Time);
+
+        // With an explicit stage dependency, there is no audit.
+        goal.m_specifyAcceleration = true;
+        CHECK(audit(goal) == SimTK::Stage::Acceleration);
+        branchState.updQ()[0] = 1.0;
+        model->realizeTime(branchState);
+        CHECK_NOTHROW(goal.calcIntegrand({0, branchState, controls}));
+    }
+    // Errors other than a state that is not realized far enough are not
+    // caught by the audit.
+    {
+        MocoStageAuditGoal goal;
+        goal.m_throwInGoal = true;
+        CHECK_THROWS_WITH(audit(goal), Catch::Contains("Invalid input."));
+    }
+    // Costs with zero weight are not evaluated.
+    {
+        MocoStageAuditGoal goal("zero", 0);
+        goal.m_realizeIntegrand = SimTK::Stage::Acceleration;
+        CHECK(audit(goal) == SimTK::Stage::Topology);
+        state.invalidateAll(SimTK::Stage::Instance);
+        CHECK(goal.calcIntegrand({0, state, controls}) == 0);
+        CHECK(state.getSystemStage() < SimTK::Stage::Time);
+    }
+}
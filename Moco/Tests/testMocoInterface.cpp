@@ -334,6 +334,78 @@ void testCopy() {
 }
  */
 
+TEMPLATE_TEST_CASE("MocoSolutionCache", "", MocoTropterSolver,
+        MocoCasADiSolver) {
+    const std::string directory = "testMocoInterface_MocoSolutionCache";
+    MocoSolutionCache::setDirectory(directory);
+    MocoSolutionCache::resetStatistics();
+
+    MocoStudy study = createSlidingMassMocoStudy<TestType>();
+    auto& solver = study.updSolver<TestType>();
+    const auto createFingerprint = [&]() {
+        return MocoSolutionCache::createFingerprint(study);
+    };
+
+    // Changing the solver settings or the guess changes the fingerprint.
+    const std::string original = createFingerprint();
+    const double tolerance = solver.get_optim_convergence_tolerance();
+    solver.set_optim_convergence_tolerance(1e-5);
+    const std::string newTolerance = createFingerprint();
+    solver.setGuess("bounds");
+    const std::string newGuess = createFingerprint();
+    solver.set_optim_convergence_tolerance(tolerance);
+    solver.clearGuess();
+    CHECK(createFingerprint() == original);
+    CHECK(newTolerance != original);
+    CHECK(newGuess != original);
+    CHECK(newGuess != newTolerance);
+
+    // Remove solutions from previous runs of this test.
+    for (const auto& fingerprint : {original, newTolerance, newGuess}) {
+        std::remove((directory + "/" + fingerprint + ".sto").c_str());
+    }
+    MocoSolution solution = study.solve();
+    CHECK(MocoSolutionCache::getNumHits() == 0);
+    CHECK(MocoSolutionCache::getNumMisses() == 1);
+
+    // Same study, different name.
+    study.setName("sliding_mass_renamed");
+    CHECK(createFingerprint() == original);
+    MocoSolution cached = study.solve();
+    CHECK(MocoSolutionCache::getNumHits() == 1);
+    CHECK(MocoSolutionCache::getNumMisses() == 1);
+    CHECK(cached.isNumericallyEqual(solution, 1e-10));
+    CHECK(cached.getObjective() == solution.getObjective());
+    CHECK(cached.getNumIterations() == solution.getNumIterations());
+    CHECK(cached.getObjectiveTermNames() == solution.getObjectiveTermNames());
+
+    solver.set_optim_convergence_tolerance(1e-5);
+    CHECK(createFingerprint() == newTolerance);
+    study.solve();
+    CHECK(MocoSolutionCache::getNumHits() == 1);
+    CHECK(MocoSolutionCache::getNumMisses() == 2);
+
+    solver.setGuess("bounds");
+    CHECK(createFingerprint() == newGuess);
+    study.solve();
+    CHECK(MocoSolutionCache::getNumHits() == 1);
+    CHECK(MocoSolutionCache::getNumMisses() == 3);
+    study.solve();
+    CHECK(MocoSolutionCache::getNumHits() == 2);
+
+    // The solution for the original settings is still cached.
+    solver.set_optim_convergence_tolerance(tolerance);
+    solver.clearGuess();
+    study.solve();
+    CHECK(MocoSolutionCache::getNumHits() == 3);
+    CHECK(MocoSolutionCache::getNumMisses() == 3);
+
+    MocoSolutionCache::setDirectory("");
+    study.solve();
+    CHECK(MocoSolutionCache::getNumHits() == 3);
+    CHECK(MocoSolutionCache::getNumMisses() == 3);
+}
+
 TEST_CASE("Bounds", "") {
     {
         SimTK_TEST(!MocoBounds().isSet());
@@ -1609,6 +1681,54 @@ TEST_CASE("MocoTrajectory randomize") {
     }
 }
 
+TEST_CASE("MocoTrajectory insertStatesTrajectory") {
+    const SimTK::Vector time = createVectorLinspace(11, 0, 1);
+    const SimTK::Matrix states = SimTK::Test::randMatrix(11, 2);
+    MocoTrajectory traj(time, {"a", "b"}, {"u"}, {}, {}, states,
+            SimTK::Test::randMatrix(11, 1), SimTK::Matrix(),
+            SimTK::RowVector());
+    std::vector<double> tableTime(time.getContiguousScalarData(),
+            time.getContiguousScalarData() + time.size());
+    const SimTK::Matrix data = SimTK::Test::randMatrix(11, 2);
+    const TimeSeriesTable table(tableTime, data, {"b", "c"});
+
+    SECTION("Same times") {
+        traj.insertStatesTrajectory(table);
+        CHECK(traj.getStateNames() ==
+                std::vector<std::string>{"a", "b", "c"});
+        OpenSim_CHECK_MATRIX(traj.getStatesTrajectory().block(0, 0, 11, 2),
+                states);
+        OpenSim_CHECK_MATRIX(
+                traj.getStatesTrajectory().col(2), data.col(1));
+
+        traj.insertStatesTrajectory(table, true);
+        CHECK(traj.getNumStates() == 3);
+        OpenSim_CHECK_MATRIX(traj.getStatesTrajectory().col(1), data.col(0));
+
+        traj.insertControlsTrajectory(table);
+        CHECK(traj.getControlNames() ==
+                std::vector<std::string>{"u", "b", "c"});
+        OpenSim_CHECK_MATRIX(
+                traj.getControlsTrajectory().block(0, 1, 11, 2), data);
+    }
+
+    SECTION("Different times") {
+        const SimTK::Vector denseTime = createVectorLinspace(41, -0.1, 1.1);
+        std::vector<double> denseTableTime(
+                denseTime.getContiguousScalarData(),
+                denseTime.getContiguousScalarData() + denseTime.size());
+        SimTK::Matrix denseData(41, 1);
+        for (int i = 0; i < 41; ++i) denseData(i, 0) = 2 * denseTime[i] + 1;
+        traj.insertStatesTrajectory(
+                TimeSeriesTable(denseTableTime, denseData, {"d"}));
+        CHECK(traj.getNumStates() == 3);
+        for (int i = 0; i < 11; ++i) {
+            CHECK(traj.getStatesTrajectory()(i, 2) ==
+                    Approx(2 * time[i] + 1).margin(1e-6));
+        }
+    }
+}
+
 TEST_CASE("createPeriodicTrajectory") {
     const std::string hip_r = "hip_r/hip_flexion_r/value";
     const std::string hip_l = "hip_l/hip_flexion_l/value";
@@ -1698,6 +1818,134 @@ TEST_CASE("Interpolate", "") {
     SimTK_TEST(SimTK::isNaN(newY[3]));
 }
 
+TEST_CASE("interpolateColumns()") {
+    const int numRows = 21;
+    const SimTK::Vector x = createVectorLinspace(numRows, 0, 2);
+    SimTK::Matrix y(numRows, 3);
+    for (int i = 0; i < numRows; ++i) {
+        y(i, 0) = std::sin(x[i]);
+        y(i, 1) = 3 * x[i] - 1;
+        y(i, 2) = x[i] * x[i];
+    }
+    // The new values need not be sorted, and may be outside the range of x.
+    const SimTK::Vector newX = createVector({1.33, -0.1, 0, 0.05, 2, 2.1, 0.8});
+
+    SECTION("Linear") {
+        const SimTK::Matrix newY = interpolateColumns(x, y, newX);
+        CHECK(newY.nrow() == newX.size());
+        CHECK(newY.ncol() == 3);
+        for (int k = 0; k < newX.size(); ++k) {
+            if (newX[k] < 0 || newX[k] > 2) {
+                for (int icol = 0; icol < 3; ++icol) {
+                    CHECK(SimTK::isNaN(newY(k, icol)));
+                }
+                continue;
+            }
+            // Linear functions are interpolated exactly.
+            CHECK(newY(k, 1) == Approx(3 * newX[k] - 1));
+        }
+        // At the data, the interpolant is the data (x = 0.8, 2).
+        CHECK(newY(6, 0) == Approx(std::sin(0.8)));
+        CHECK(newY(6, 2) == Approx(0.64));
+        CHECK(newY(4, 0) == Approx(std::sin(2.0)));
+        CHECK(newY(4, 2) == Approx(4.0));
+        // Between the data (x = 1.3, 1.4), the interpolant is the weighted
+        // average of the adjacent data.
+        CHECK(newY(0, 0) ==
+                Approx(0.7 * std::sin(1.3) + 0.3 * std::sin(1.4)));
+        CHECK(newY(0, 2) == Approx(0.7 * 1.69 + 0.3 * 1.96));
+        // The midpoint of x = 0 and 0.1.
+        CHECK(newY(3, 0) == Approx(0.5 * std::sin(0.1)));
+        CHECK(newY(3, 2) == Approx(0.005));
+    }
+
+    SECTION("Cubic") {
+        const SimTK::Matrix newY = interpolateColumns(x, y, newX, true);
+        for (int k = 0; k < newX.size(); ++k) {
+            if (newX[k] < 0 || newX[k] > 2) {
+                CHECK(SimTK::isNaN(newY(k, 0)));
+                continue;
+            }
+            CHECK(newY(k, 0) == Approx(std::sin(newX[k])).margin(1e-4));
+            // Linear functions are interpolated exactly.
+            CHECK(newY(k, 1) == Approx(3 * newX[k] - 1));
+            CHECK(newY(k, 2) == Approx(newX[k] * newX[k]).margin(2e-3));
+        }
+        // The spline passes through the data.
+        const SimTK::Matrix atKnots = interpolateColumns(x, y, x, true);
+        OpenSim_CHECK_MATRIX_ABSTOL(atKnots, y, 1e-12);
+    }
+
+    SECTION("Invalid x") {
+        CHECK_THROWS_AS(interpolateColumns(createVector({0, 1, 0.5}),
+                                SimTK::Matrix(3, 1, 0.0), newX),
+                Exception);
+        // Repeated values are only allowed for linear interpolation.
+        const SimTK::Vector repeated = createVector({0, 1, 1, 2});
+        CHECK_NOTHROW(interpolateColumns(
+                repeated, SimTK::Matrix(4, 1, 0.0), newX));
+        CHECK_THROWS_AS(interpolateColumns(
+                                repeated, SimTK::Matrix(4, 1, 0.0), newX, true),
+                Exception);
+    }
+}
+
+TEST_CASE("createGCVSplineSetReusingFits()") {
+    const int numRows = 20;
+    std::vector<double> time(numRows);
+    SimTK::Matrix data(numRows, 2);
+    for (int i = 0; i < numRows; ++i) {
+        time[i] = 0.1 * i;
+        data(i, 0) = std::sin(time[i]);
+        data(i, 1) = std::cos(time[i]);
+    }
+    TimeSeriesTable table(time, data, {"sin", "cos"});
+
+    const GCVSplineSet expected(table);
+    const GCVSplineSet first = createGCVSplineSetReusingFits(table);
+    const GCVSplineSet second = createGCVSplineSetReusingFits(table);
+    CHECK(first.getSize() == 2);
+    CHECK(second.getSize() == 2);
+    for (double t : {0.05, 0.77, 1.5}) {
+        const SimTK::Vector x(1, t);
+        for (int icol = 0; icol < 2; ++icol) {
+            CHECK(first[icol].calcValue(x) == expected[icol].calcValue(x));
+            CHECK(second[icol].calcValue(x) == expected[icol].calcValue(x));
+        }
+    }
+
+    // A different table must not reuse the previous fit.
+    table.updMatrix()(5, 1) += 1.0;
+    const GCVSplineSet modified = createGCVSplineSetReusingFits(table);
+    const SimTK::Vector x(1, time[5]);
+    CHECK(modified.get("cos").calcValue(x) ==
+            Approx(GCVSplineSet(table).get("cos").calcValue(x)));
+    CHECK(modified.get("cos").calcValue(x) !=
+            Approx(expected.get("cos").calcValue(x)));
+
+    CHECK(getNumGCVSplineSetFits() > 0);
+    clearGCVSplineSetFits();
+    CHECK(getNumGCVSplineSetFits() == 0);
+    const GCVSplineSet refit = createGCVSplineSetReusingFits(table);
+    CHECK(refit.get("cos").calcValue(x) ==
+            modified.get("cos").calcValue(x));
+    CHECK(getNumGCVSplineSetFits() == 1);
+
+    // Tables that are too large are not retained.
+    const int numRowsLarge = 1000;
+    const int numColsLarge = 1100;
+    std::vector<double> timeLarge(numRowsLarge);
+    for (int i = 0; i < numRowsLarge; ++i) timeLarge[i] = 0.01 * i;
+    std::vector<std::string> labelsLarge;
+    for (int icol = 0; icol < numColsLarge; ++icol) {
+        labelsLarge.push_back(std::to_string(icol));
+    }
+    createGCVSplineSetReusingFits(TimeSeriesTable(timeLarge,
+            SimTK::Matrix(numRowsLarge, numColsLarge, 0.0), labelsLarge));
+    CHECK(getNumGCVSplineSetFits() == 1);
+    clearGCVSplineSetFits();
+}
+
 TEMPLATE_TEST_CASE("Sliding mass", "", MocoTropterSolver, MocoCasADiSolver) {
     MocoStudy study = createSlidingMassMocoStudy<TestType>();
     MocoSolution solution = study.solve();
@@ -1955,6 +2203,45 @@ TEST_CASE("solveBisection()") {
     }
 }
 
+TEST_CASE("solveBracketedNewton()") {
+    int numEvals = 0;
+    auto calcResidual = [&numEvals](const SimTK::Real& x,
+                                SimTK::Real& derivative) {
+        ++numEvals;
+        derivative = 3 * SimTK::square(x);
+        return SimTK::cube(x) - 3.78;
+    };
+    const SimTK::Real expected = std::cbrt(3.78);
+    {
+        const auto root = solveBracketedNewton(calcResidual, -5, 5, 1e-10);
+        CHECK(root == Approx(expected).margin(1e-10));
+        // Newton's method converges much faster than bisection, which would
+        // require about 37 evaluations.
+        CHECK(numEvals < 20);
+    }
+
+    // A derivative that is not finite forces bisection steps.
+    {
+        auto calcResidualNoDerivative = [](const SimTK::Real& x,
+                                                SimTK::Real& derivative) {
+            derivative = SimTK::NaN;
+            return SimTK::cube(x) - 3.78;
+        };
+        const auto root =
+                solveBracketedNewton(calcResidualNoDerivative, -5, 5, 1e-10);
+        CHECK(root == Approx(expected).margin(1e-10));
+    }
+
+    // Multiple roots.
+    {
+        auto parabola = [](const SimTK::Real& x, SimTK::Real& derivative) {
+            derivative = 2 * (x - 2.5);
+            return SimTK::square(x - 2.5);
+        };
+        REQUIRE_THROWS_AS(solveBracketedNewton(parabola, -5, 5), Exception);
+    }
+}
+
 TEST_CASE("Objective breakdown") {
     class MocoConstantGoal : public MocoGoal {
         OpenSim_DECLARE_CONCRETE_OBJECT(MocoConstantGoal, MocoGoal);
@@ -1988,6 +2275,172 @@ TEST_CASE("Objective breakdown") {
     CHECK(solution.getObjectiveTerm("goal_b") == Approx(0.01 * 7.3));
 }
 
+TEST_CASE("MocoCasADiSolver reuse_nlp") {
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    auto& solver = study.updSolver<MocoCasADiSolver>();
+    solver.set_reuse_nlp(true);
+    MocoSolution solutionFirst = study.solve();
+
+    // Change bounds; the structure of the problem is the same, so the NLP is
+    // reused.
+    MocoProblem& problem = study.updProblem();
+    problem.setStateInfo("/slider/position/value", MocoBounds(0, 1),
+            MocoInitialBounds(0), MocoFinalBounds(0.5));
+    MocoSolution solutionReused = study.solve();
+    CHECK(solutionReused.getFinalTime() < solutionFirst.getFinalTime());
+
+    solver.set_reuse_nlp(false);
+    MocoSolution solutionExpected = study.solve();
+    CHECK(solutionReused.isNumericallyEqual(solutionExpected, 1e-6));
+
+    // Changing the structure of the problem creates a new NLP.
+    solver.set_reuse_nlp(true);
+    problem.addGoal<MocoControlGoal>("effort", 1e-3);
+    MocoSolution solutionNewStructure = study.solve();
+    CHECK(solutionNewStructure.getNumObjectiveTerms() == 2);
+}
+
+TEST_CASE("simulateTrajectorySegmentsWithTimeStepping") {
+    MocoStudy study = createSlidingMassMocoStudy<MocoCasADiSolver>();
+    MocoSolution solution = study.solve();
+    const int numTimes = solution.getNumTimes();
+
+    auto model = createSlidingMassModel();
+    for (int numIntervalsPerSegment : {1, 4}) {
+        for (int parallel : {0, 2}) {
+            TimeSeriesTable drift = simulateTrajectorySegmentsWithTimeStepping(
+                    solution, *model, numIntervalsPerSegment, 1e-8, parallel);
+            const int numSegments =
+                    (numTimes - 2) / numIntervalsPerSegment + 1;
+            REQUIRE((int)drift.getNumRows() == numSegments);
+            CHECK(drift.getColumnLabels() == solution.getStateNames());
+            CHECK(drift.getIndependentColumn().back() ==
+                    Approx(solution.getFinalTime()));
+            // The trajectory obeys the dynamics, up to the transcription
+            // error.
+            CHECK(drift.getMatrix().normInf() < 1e-2);
+        }
+    }
+
+    // Each segment starts from the trajectory's states, so drift does not
+    // accumulate: a large error in one interval appears only in the segment
+    // containing that interval.
+    MocoTrajectory perturbed = solution;
+    SimTK::Vector position = perturbed.getState("/slider/position/value");
+    position[numTimes / 2] += 0.1;
+    perturbed.setState("/slider/position/value", position);
+    TimeSeriesTable drift = simulateTrajectorySegmentsWithTimeStepping(
+            perturbed, *model, 1, 1e-8, 0);
+    const auto& driftPosition = drift.getDependentColumnAtIndex(0);
+    CHECK(std::abs(driftPosition[numTimes / 2 - 1]) > 0.05);
+    CHECK(std::abs(driftPosition[numTimes / 2]) > 0.05);
+    CHECK(std::abs(driftPosition[0]) < 1e-2);
+    CHECK(std::abs(driftPosition[numTimes - 2]) < 1e-2);
+}
+
+TEST_CASE("MocoCasADiSolver num_time_windows") {
+    // The solution of a tracking problem at a given time depends mostly on
+    // the nearby reference data, so it can be solved in time windows.
+    MocoStudy study;
+    study.set_write_solution("false");
+    MocoProblem& problem = study.updProblem();
+    problem.setModel(createSlidingMassModel());
+    problem.setTimeBounds(0, 2);
+    problem.setStateInfo("/slider/position/value", {-5, 5}, 0);
+    problem.setStateInfo("/slider/position/speed", {-50, 50}, 1);
+    problem.setControlInfo("/actuator", {-50, 50});
+    TimeSeriesTable reference;
+    reference.setColumnLabels({"/slider/position/value"});
+    for (int i = 0; i <= 100; ++i) {
+        const double time = 0.02 * i;
+        reference.appendRow(time, SimTK::RowVector(1, std::sin(time)));
+    }
+    auto* tracking = problem.addGoal<MocoStateTrackingGoal>("tracking", 10);
+    tracking->setReference(TableProcessor(reference));
+    problem.addGoal<MocoControlGoal>("effort", 1e-3);
+
+    auto& solver = study.initCasADiSolver();
+    solver.set_num_mesh_intervals(40);
+    MocoSolution expected = study.solve();
+
+    solver.set_num_time_windows(2);
+    solver.set_parallel(2);
+    MocoSolution solution = study.solve();
+    REQUIRE(solution.success());
+    CHECK(solution.getInitialTime() == Approx(0));
+    CHECK(solution.getFinalTime() == Approx(2));
+    CHECK(solution.compareContinuousVariablesRMS(
+                  expected, {{"states", {}}}) < 1e-2);
+
+    // Endpoint costs cannot be split across windows.
+    problem.addGoal<MocoFinalTimeGoal>();
+    CHECK_THROWS_WITH(study.solve(), Catch::Contains("has no integral"));
+}
+
+TEST_CASE("MocoRecedingHorizon") {
+    MocoStudy study;
+    study.set_write_solution("false");
+    MocoProblem& problem = study.updProblem();
+    problem.setModel(createSlidingMassModel());
+    problem.setTimeBounds(0, 0.5);
+    problem.setStateInfo("/slider/position/value", {-5, 5});
+    problem.setStateInfo("/slider/position/speed", {-50, 50});
+    problem.setControlInfo("/actuator", {-50, 50});
+    // The reference covers the entire trial, beyond the first horizon.
+    TimeSeriesTable reference;
+    reference.setColumnLabels({"/slider/position/value"});
+    for (int i = 0; i <= 100; ++i) {
+        const double time = 0.02 * i;
+        reference.appendRow(time, SimTK::RowVector(1, std::sin(time)));
+    }
+    auto* tracking = problem.addGoal<MocoStateTrackingGoal>("tracking", 10);
+    tracking->setReference(TableProcessor(reference));
+    problem.addGoal<MocoControlGoal>("effort", 1e-3);
+    auto& solver = study.initCasADiSolver();
+    solver.set_num_mesh_intervals(10);
+
+    MocoRecedingHorizon horizon(study);
+    CHECK(horizon.getHorizonDuration() == Approx(0.5));
+    MocoSolution solution;
+    for (int istep = 0; istep < 4; ++istep) {
+        const double initialTime = 0.1 * istep;
+        solution = horizon.step(initialTime,
+                {{"/slider/position/value", std::sin(initialTime)},
+                        {"/slider/position/speed", std::cos(initialTime)}});
+        REQUIRE(solution.success());
+        CHECK(solution.getInitialTime() == Approx(initialTime));
+        CHECK(solution.getFinalTime() == Approx(initialTime + 0.5));
+        CHECK(solution.getState("/slider/position/value")[0] ==
+                Approx(std::sin(initialTime)));
+    }
+    const auto& stats = horizon.getStepStatistics();
+    REQUIRE(stats.size() == 4);
+    CHECK(!stats[0].reusedProblemRep);
+    for (int istep = 1; istep < 4; ++istep) {
+        CHECK(stats[istep].reusedProblemRep);
+        CHECK(stats[istep].latency > 0);
+    }
+
+    // The last step matches solving the same horizon from scratch.
+    {
+        MocoStudy studyExpected = study;
+        MocoProblem& problemExpected = studyExpected.updProblem();
+        problemExpected.setTimeBounds(0.3, 0.8);
+        problemExpected.setStateInfo(
+                "/slider/position/value", {-5, 5}, std::sin(0.3));
+        problemExpected.setStateInfo(
+                "/slider/position/speed", {-50, 50}, std::cos(0.3));
+        MocoSolution expected = studyExpected.solve();
+        CHECK(solution.compareContinuousVariablesRMS(expected,
+                      {{"states", {}}, {"controls", {}}}) < 1e-3);
+    }
+
+    // Editing the problem creates new MocoProblemReps.
+    horizon.updStudy().updProblem().updGoal("effort").setWeight(1e-2);
+    solution = horizon.step(0.4);
+    CHECK(solution.success());
+    CHECK(!horizon.getStepStatistics().back().reusedProblemRep);
+}
 
 /*
 TEMPLATE_TEST_CASE("Controllers in the model", "",
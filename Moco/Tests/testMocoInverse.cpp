@@ -145,3 +145,149 @@ TEST_CASE("MocoInverse Rajagopal2016, 18 muscles") {
             {{"controls", {}}}) < 1e-2);
     CHECK(std.compareContinuousVariablesRMS(solution, {{"states", {}}}) < 1e-2);
 }
+
+TEST_CASE("MocoInverse num_time_windows") {
+    MocoInverse inverse;
+    ModelProcessor modelProcessor =
+        ModelProcessor("subject_walk_armless_18musc.osim") |
+        ModOpReplaceJointsWithWelds({"subtalar_r", "subtalar_l",
+            "mtp_r", "mtp_l"}) |
+        ModOpReplaceMusclesWithDeGrooteFregly2016() |
+        ModOpIgnorePassiveFiberForcesDGF() |
+        ModOpTendonComplianceDynamicsModeDGF("implicit") |
+        ModOpAddExternalLoads("subject_walk_armless_external_loads.xml");
+
+    inverse.setModel(modelProcessor);
+    inverse.setKinematics(
+        TableProcessor("subject_walk_armless_coordinates.mot") |
+        TabOpLowPassFilter(6));
+    inverse.set_initial_time(0.450);
+    inverse.set_final_time(1.0);
+    inverse.set_kinematics_allow_extra_columns(true);
+    inverse.set_mesh_interval(0.05);
+    // The middle window is warm-started from the other two.
+    inverse.set_num_time_windows(3);
+    inverse.set_time_window_margin(0.1);
+
+    MocoSolution solution = inverse.solve().getMocoSolution();
+    REQUIRE(solution.success());
+    CHECK(solution.getInitialTime() == Approx(0.450));
+    CHECK(solution.getFinalTime() == Approx(1.0));
+    const auto& time = solution.getTime();
+    for (int itime = 1; itime < time.size(); ++itime) {
+        CHECK(time[itime] > time[itime - 1]);
+    }
+
+    // The windows are solved separately, so the solution is close to, but not
+    // the same as, the solution of the entire trial.
+    MocoTrajectory std("std_testMocoInverse_subject_18musc_solution.sto");
+    CHECK(std.compareContinuousVariablesRMS(solution,
+            {{"controls", {}}}) < 5e-2);
+}
+
+TEST_CASE("MocoInverse static_optimization") {
+    MocoInverse inverse;
+    ModelProcessor modelProcessor =
+        ModelProcessor("subject_walk_armless_18musc.osim") |
+        ModOpReplaceJointsWithWelds({"subtalar_r", "subtalar_l",
+            "mtp_r", "mtp_l"}) |
+        ModOpReplaceMusclesWithDeGrooteFregly2016() |
+        ModOpIgnorePassiveFiberForcesDGF() |
+        ModOpIgnoreTendonCompliance() |
+        ModOpAddExternalLoads("subject_walk_armless_external_loads.xml");
+
+    inverse.setKinematics(
+        TableProcessor("subject_walk_armless_coordinates.mot") |
+        TabOpLowPassFilter(6));
+    inverse.set_initial_time(0.450);
+    inverse.set_final_time(1.0);
+    inverse.set_kinematics_allow_extra_columns(true);
+    inverse.set_mesh_interval(0.05);
+    inverse.set_static_optimization(true);
+
+    // Activation dynamics add auxiliary state variables.
+    inverse.setModel(modelProcessor);
+    CHECK_THROWS_WITH(inverse.solve(),
+            Catch::Contains("ModOpIgnoreActivationDynamics"));
+
+    inverse.setModel(modelProcessor | ModOpIgnoreActivationDynamics());
+    MocoSolution solution = inverse.solve().getMocoSolution();
+    REQUIRE(solution.success());
+    CHECK(solution.getInitialTime() == Approx(0.450));
+    CHECK(solution.getFinalTime() == Approx(1.0));
+    CHECK(solution.getObjective() > 0);
+    // Muscle excitations are within their bounds.
+    for (const auto& name : solution.getControlNames()) {
+        if (name.find("reserve_") != std::string::npos ||
+                name.find("torque_") != std::string::npos) {
+            continue;
+        }
+        const SimTK::Vector control = solution.getControl(name);
+        CHECK(SimTK::min(control) >= 0);
+        CHECK(SimTK::max(control) <= 1 + 1e-10);
+    }
+    // The model has kinematic constraints (for the patellae).
+    REQUIRE(solution.getNumMultipliers() > 0);
+
+    // The controls and multipliers satisfy the multibody dynamics: the
+    // generalized forces required to achieve the motion (with the solved
+    // controls) are balanced by the constraint forces.
+    {
+        const MocoStudy study = inverse.initialize();
+        const MocoProblemRep rep = study.getProblem().createRep();
+        const auto& modelBase = rep.getModelBase();
+        auto& stateBase = rep.updStateBase();
+        const auto& model = rep.getModelDisabledConstraints();
+        auto& state = rep.updStateDisabledConstraints();
+        std::vector<int> modelControlIndices;
+        const auto controlNames =
+                createControlNamesFromModel(model, modelControlIndices);
+        REQUIRE(controlNames == solution.getControlNames());
+        const auto& time = solution.getTime();
+        const auto& controls = solution.getControlsTrajectory();
+        const auto& multipliers = solution.getMultipliersTrajectory();
+        SimTK::Vector modelControls(model.getNumControls(), 0.0);
+        SimTK::Vector residual;
+        SimTK::Matrix G;
+        for (int itime = 0; itime < time.size(); ++itime) {
+            for (int ic = 0; ic < (int)controlNames.size(); ++ic) {
+                modelControls[modelControlIndices[ic]] = controls(itime, ic);
+            }
+            state.setTime(time[itime]);
+            model.getSystem().prescribe(state);
+            rep.getDiscreteControllerDisabledConstraints().setDiscreteControls(
+                    state, modelControls);
+            model.realizeAcceleration(state);
+            model.getMatterSubsystem().findMotionForces(state, residual);
+
+            stateBase.setTime(time[itime]);
+            modelBase.getSystem().prescribe(stateBase);
+            modelBase.realizeVelocity(stateBase);
+            modelBase.getMatterSubsystem().calcG(stateBase, G);
+            residual += ~G * ~multipliers[itime];
+            // The tolerance applies to each residual in a basis of the
+            // generalized forces that excludes the constraint forces.
+            CHECK(residual.normInf() <=
+                    std::sqrt(residual.size()) *
+                            inverse.get_constraint_tolerance());
+        }
+    }
+
+    // Without activation dynamics and tendon compliance, the optimal control
+    // problem decouples in time, so its solution at the mesh points is the
+    // static optimization solution.
+    inverse.set_static_optimization(false);
+    MocoSolution optimalControl = inverse.solve().getMocoSolution();
+    REQUIRE(optimalControl.success());
+    MocoTrajectory atMeshPoints = optimalControl;
+    atMeshPoints.resample(solution.getTime());
+    CHECK(solution.compareContinuousVariablesRMS(
+                  atMeshPoints, {{"controls", {}}}) < 1e-3);
+    CHECK(solution.compareContinuousVariablesRMS(
+                  atMeshPoints, {{"multipliers", {}}}) < 1e-2);
+    // The optimal control problem integrates the objective with
+    // Hermite-Simpson quadrature, and static optimization with the
+    // trapezoidal rule.
+    CHECK(solution.getObjective() ==
+            Approx(optimalControl.getObjective()).epsilon(0.05));
+}
@@ -605,3 +605,101 @@ TEST_CASE("Bhargava2004Metabolics basics") {
 
     }
 }
+
+TEST_CASE("Bhargava2004Metabolics multiple muscles") {
+    Model model;
+    model.setName("muscles");
+    std::vector<std::string> musclePaths;
+    for (int i = 0; i < 3; ++i) {
+        const std::string suffix = std::to_string(i);
+        auto* body = new Body("body" + suffix, 0.5, SimTK::Vec3(0),
+                SimTK::Inertia(0));
+        model.addComponent(body);
+        auto* joint = new SliderJoint("joint" + suffix, model.getGround(),
+                *body);
+        joint->updCoordinate(SliderJoint::Coord::TranslationX)
+                .setName("x" + suffix);
+        model.addComponent(joint);
+        auto* muscle = new DeGrooteFregly2016Muscle();
+        muscle->setName("muscle" + suffix);
+        muscle->set_optimal_fiber_length(0.1 + 0.05 * i);
+        muscle->set_max_isometric_force(500 + 300 * i);
+        muscle->addNewPathPoint("origin", model.updGround(), SimTK::Vec3(0));
+        muscle->addNewPathPoint("insertion", *body, SimTK::Vec3(0));
+        model.addComponent(muscle);
+        musclePaths.push_back("/muscle" + suffix);
+    }
+    model.finalizeConnections();
+
+    // One metabolics component for all muscles, and one for each muscle.
+    auto smoothingType = GENERATE(as<std::string>{}, "none", "tanh", "huber");
+    const auto addMetabolics = [&](const std::string& name,
+                                       const std::vector<int>& muscles) {
+        auto* metabolics = new Bhargava2004Metabolics();
+        metabolics->setName(name);
+        metabolics->set_use_smoothing(smoothingType != "none");
+        if (smoothingType != "none") {
+            metabolics->set_smoothing_type(smoothingType);
+        }
+        for (int i : muscles) {
+            metabolics->addMuscle("muscle" + std::to_string(i),
+                    model.getComponent<Muscle>(musclePaths[i]),
+                    0.3 + 0.2 * i, 0.25e6);
+        }
+        model.addComponent(metabolics);
+    };
+    addMetabolics("all", {0, 1, 2});
+    for (int i = 0; i < 3; ++i) {
+        addMetabolics("single" + std::to_string(i), {i});
+    }
+    model.finalizeConnections();
+
+    SimTK::State state = model.initSystem();
+    for (int i = 0; i < 3; ++i) {
+        const std::string suffix = std::to_string(i);
+        const auto& muscle = model.getComponent<Muscle>(musclePaths[i]);
+        muscle.setActivation(state, 0.2 + 0.3 * i);
+        const auto& coord = model.getComponent<Coordinate>(
+                "/joint" + suffix + "/x" + suffix);
+        coord.setValue(state,
+                muscle.getOptimalFiberLength() + muscle.getTendonSlackLength());
+        coord.setSpeedValue(state, 0.1 - 0.1 * i);
+    }
+    model.realizeVelocity(state);
+    model.equilibrateMuscles(state);
+    SimTK::Vector& controls(model.updControls(state));
+    for (int i = 0; i < 3; ++i) {
+        model.getComponent<Muscle>(musclePaths[i]).setControls(
+                SimTK::Vector(1, 0.1 + 0.4 * i), controls);
+    }
+    model.setControls(state, controls);
+    model.realizeDynamics(state);
+
+    const auto& all = model.getComponent<Bhargava2004Metabolics>("all");
+    // Obtaining the activation rate first computes only some of the rates.
+    double activationRate = 0;
+    for (int i = 0; i < 3; ++i) {
+        activationRate += model.getComponent<Bhargava2004Metabolics>(
+                "single" + std::to_string(i)).getTotalActivationRate(state);
+    }
+    CHECK(all.getTotalActivationRate(state) == Approx(activationRate));
+    for (int i = 0; i < 3; ++i) {
+        const auto& single = model.getComponent<Bhargava2004Metabolics>(
+                "single" + std::to_string(i));
+        CHECK(all.getMuscleMetabolicRate(state, musclePaths[i]) ==
+                Approx(single.getMuscleMetabolicRate(state, musclePaths[i])));
+    }
+    double shorteningRate = 0;
+    double mechanicalWorkRate = 0;
+    double maintenanceRate = 0;
+    for (int i = 0; i < 3; ++i) {
+        const auto& single = model.getComponent<Bhargava2004Metabolics>(
+                "single" + std::to_string(i));
+        shorteningRate += single.getTotalShorteningRate(state);
+        mechanicalWorkRate += single.getTotalMechanicalWorkRate(state);
+        maintenanceRate += single.getTotalMaintenanceRate(state);
+    }
+    CHECK(all.getTotalShorteningRate(state) == Approx(shorteningRate));
+    CHECK(all.getTotalMechanicalWorkRate(state) == Approx(mechanicalWorkRate));
+    CHECK(all.getTotalMaintenanceRate(state) == Approx(maintenanceRate));
+}
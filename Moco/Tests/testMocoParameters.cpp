@@ -99,6 +99,107 @@ TEMPLATE_TEST_CASE("Oscillator mass", "", MocoTropterSolver, MocoCasADiSolver) {
     CHECK(sol.getParameter("oscillator_mass") == Approx(MASS).epsilon(0.003));
 }
 
+TEST_CASE("Oscillator mass without initSystem()") {
+    MocoStudy study;
+    study.setName("oscillator_mass_no_initsystem");
+    MocoProblem& mp = study.updProblem();
+    mp.setModel(createOscillatorModel());
+    mp.setTimeBounds(0, FINAL_TIME);
+    mp.setStateInfo("/slider/position/value", {-5.0, 5.0}, -0.5, {0.25, 0.75});
+    mp.setStateInfo("/slider/position/speed", {-20, 20}, 0, 0);
+    mp.addParameter("oscillator_mass", "body", "mass", MocoBounds(0, 10));
+    mp.addGoal<FinalPositionGoal>();
+
+    auto& ms = study.initCasADiSolver();
+    ms.set_num_mesh_intervals(25);
+    // Body mass properties do not require initSystem().
+    ms.set_parameters_require_initsystem(false);
+
+    MocoSolution sol = study.solve();
+    CHECK(sol.getParameter("oscillator_mass") == Approx(MASS).epsilon(0.003));
+}
+
+TEST_CASE("MocoParameter update method") {
+    using UpdateMethod = MocoParameter::UpdateMethod;
+    auto model = createOscillatorModel();
+    auto* muscle = new DeGrooteFregly2016Muscle();
+    muscle->setName("muscle");
+    muscle->addNewPathPoint(
+            "origin", model->updGround(), SimTK::Vec3(-1, 0, 0));
+    muscle->addNewPathPoint(
+            "insertion", model->updComponent<Body>("body"), SimTK::Vec3(0));
+    model->addForce(muscle);
+
+    MocoProblem problem;
+    problem.setModel(std::move(model));
+    problem.setTimeBounds(0, 1);
+
+    SECTION("Body mass properties do not require initSystem()") {
+        problem.addParameter("mass", "body", "mass", MocoBounds(0, 10));
+        problem.addParameter(
+                "com_y", "body", "mass_center", MocoBounds(-1, 1), 1);
+        auto rep = problem.createRep();
+        CHECK(rep.getParameter("mass").getUpdateMethod() ==
+                UpdateMethod::MassProperties);
+        CHECK(rep.getParametersUpdateMethod() == UpdateMethod::MassProperties);
+
+        rep.applyParametersToModelProperties(SimTK::Vector(SimTK::Vec2(
+                                                     MASS, 0.1)), true);
+        const auto& body = rep.getModelBase().getComponent<Body>("body");
+        CHECK(body.getMass() == MASS);
+        const auto& state = rep.updStateBase();
+        rep.getModelBase().realizeInstance(state);
+        CHECK(body.getMobilizedBody().getBodyMass(state) == MASS);
+        CHECK(body.getMobilizedBody().getBodyMassCenterStation(state)[1] ==
+                Approx(0.1));
+
+        const auto& bodyDisCon =
+                rep.getModelDisabledConstraints().getComponent<Body>("body");
+        const auto& stateDisCon = rep.updStateDisabledConstraints();
+        rep.getModelDisabledConstraints().realizeInstance(stateDisCon);
+        CHECK(bodyDisCon.getMobilizedBody().getBodyMass(stateDisCon) == MASS);
+    }
+
+    SECTION("Body mass properties without initSystem()") {
+        problem.addParameter("mass", "body", "mass", MocoBounds(0, 10));
+        auto rep = problem.createRep();
+        rep.getModelBase().realizeAcceleration(rep.updStateBase());
+        rep.applyParametersToModelProperties(SimTK::Vector(1, MASS), false);
+        // The states from before the update must not be used.
+        const auto& body = rep.getModelBase().getComponent<Body>("body");
+        const auto& state = rep.updStateBase();
+        rep.getModelBase().realizeAcceleration(state);
+        CHECK(body.getMobilizedBody().getBodyMass(state) == MASS);
+        const auto& stateDisCon = rep.updStateDisabledConstraints();
+        rep.getModelDisabledConstraints().realizeAcceleration(stateDisCon);
+    }
+
+    SECTION("Muscle max isometric force only invalidates the state cache") {
+        problem.addParameter("max_isometric_force", "/forceset/muscle",
+                "max_isometric_force", MocoBounds(0, 1000));
+        auto rep = problem.createRep();
+        CHECK(rep.getParametersUpdateMethod() == UpdateMethod::Property);
+        auto& state = rep.updStateBase();
+        rep.getModelBase().realizeDynamics(state);
+
+        rep.applyParametersToModelProperties(SimTK::Vector(1, 500.0), true);
+        CHECK(rep.getModelBase()
+                        .getComponent<Muscle>("/forceset/muscle")
+                        .getMaxIsometricForce() == 500.0);
+        CHECK(state.getSystemStage() < SimTK::Stage::Instance);
+    }
+
+    SECTION("Other properties require initSystem()") {
+        problem.addParameter("mass", "body", "mass", MocoBounds(0, 10));
+        problem.addParameter("optimal_fiber_length", "/forceset/muscle",
+                "optimal_fiber_length", MocoBounds(0.1, 0.2));
+        auto rep = problem.createRep();
+        CHECK(rep.getParameter("optimal_fiber_length").getUpdateMethod() ==
+                UpdateMethod::InitSystem);
+        CHECK(rep.getParametersUpdateMethod() == UpdateMethod::InitSystem);
+    }
+}
+
 std::unique_ptr<Model> createOscillatorTwoSpringsModel() {
     auto model = make_unique<Model>();
     model->setName("oscillator_two_springs");
@@ -75,6 +75,25 @@ TEST_CASE("ModelProcessor") {
             CHECK(modelDeserialized.getAnalysisSet().getSize() == 1);
         }
     }
+
+    SECTION("Results are cached") {
+        CHECK(!ProcessorCache::getEnabled());
+        ProcessorCache::setEnabled(true);
+        ProcessorCache::clear();
+        ModelProcessor proc = ModelProcessor(model) | MyModelOperator();
+        CHECK(proc.process().getAnalysisSet().getSize() == 1);
+        CHECK(ProcessorCache::getNumHits() == 0);
+        Model cached = proc.process();
+        CHECK(ProcessorCache::getNumHits() == 1);
+        CHECK(cached.getAnalysisSet().getSize() == 1);
+        // The copy from the cache is usable.
+        cached.initSystem();
+
+        proc.append(MyModelOperator());
+        CHECK(proc.process().getAnalysisSet().getSize() == 2);
+        CHECK(ProcessorCache::getNumHits() == 1);
+        ProcessorCache::setEnabled(false);
+    }
 }
 
 TEST_CASE("ModOpRemoveMuscles") {
@@ -21,6 +21,9 @@
 
 #include <Moco/osimMoco.h>
 
+#include <OpenSim/Common/LinearFunction.h>
+#include <OpenSim/Simulation/SimbodyEngine/CoordinateCouplerConstraint.h>
+
 using namespace OpenSim;
 
 // Create a single leg 2D model with two muscles to test the estimation of
@@ -273,3 +276,160 @@ TEST_CASE("testPolynomialApproximation") {
     testPolynomialApproximationImpl();
     testPolynomialApproximation();
 }
+
+TEST_CASE("ModOpFitPolynomialMusclePaths") {
+    Model model(createModel());
+    // Start from the original geometry paths.
+    for (auto& muscle : model.updComponentList<Muscle>()) {
+        auto& path = muscle.updGeometryPath();
+        path.set_use_approximation(false);
+        path.updProperty_length_approximation().clear();
+        path.updProperty_approximation_coordinates().clear();
+    }
+
+    ModelProcessor modelProcessor =
+            ModelProcessor(model) | ModOpFitPolynomialMusclePaths(5, 500);
+    Model fitted = modelProcessor.process();
+    fitted.initSystem();
+
+    const auto& hip_flexion = fitted.getCoordinateSet().get("hip_flexion");
+    const auto& knee_angle = fitted.getCoordinateSet().get("knee_angle");
+    for (const auto& name : {"hamstrings", "RF"}) {
+        const auto& path =
+                fitted.getComponent<PathActuator>(name).getGeometryPath();
+        CHECK(path.get_use_approximation());
+        // Only the hip and knee change the length of these muscles.
+        REQUIRE(path.getProperty_approximation_coordinates().size() == 2);
+        CHECK(path.get_approximation_coordinates(0) ==
+                "/jointset/hip/hip_flexion");
+        CHECK(path.get_approximation_coordinates(1) ==
+                "/jointset/knee/knee_angle");
+        CHECK(path.computeApproximationErrorOnGrid(40, "length") < 3e-3);
+        CHECK(path.computeApproximationErrorOnGrid(
+                      40, "moment_arm", &hip_flexion) < 3e-3);
+        CHECK(path.computeApproximationErrorOnGrid(
+                      40, "moment_arm", &knee_angle) < 3e-3);
+    }
+}
+
+TEST_CASE("ModOpFitPolynomialMusclePaths with coupled coordinates") {
+    Model model(createModel());
+    for (auto& muscle : model.updComponentList<Muscle>()) {
+        auto& path = muscle.updGeometryPath();
+        path.set_use_approximation(false);
+        path.updProperty_length_approximation().clear();
+        path.updProperty_approximation_coordinates().clear();
+    }
+    // The knee angle is determined by the hip flexion angle.
+    auto* constraint = new CoordinateCouplerConstraint();
+    Array<std::string> names;
+    names.append("hip_flexion");
+    constraint->setIndependentCoordinateNames(names);
+    constraint->setDependentCoordinateName("knee_angle");
+    constraint->setFunction(LinearFunction(-0.5, -0.5));
+    model.addConstraint(constraint);
+    model.finalizeConnections();
+
+    ModelProcessor modelProcessor =
+            ModelProcessor(model) | ModOpFitPolynomialMusclePaths(5, 500);
+    Model fitted = modelProcessor.process();
+    SimTK::State fittedState = fitted.initSystem();
+    SimTK::State state = model.initSystem();
+
+    const auto& hip_flexion = model.getCoordinateSet().get("hip_flexion");
+    const auto& fittedHipFlexion =
+            fitted.getCoordinateSet().get("hip_flexion");
+    for (const auto& name : {"hamstrings", "RF"}) {
+        const auto& path =
+                model.getComponent<PathActuator>(name).getGeometryPath();
+        const auto& fittedPath =
+                fitted.getComponent<PathActuator>(name).getGeometryPath();
+        CHECK(fittedPath.get_use_approximation());
+        // The knee angle is not an independent coordinate.
+        REQUIRE(fittedPath.getProperty_approximation_coordinates().size() ==
+                1);
+        CHECK(fittedPath.get_approximation_coordinates(0) ==
+                "/jointset/hip/hip_flexion");
+        // The fit is consistent with the coupled kinematics.
+        for (int i = 0; i <= 20; ++i) {
+            const double value = hip_flexion.getRangeMin() +
+                                 i / 20.0 * (hip_flexion.getRangeMax() -
+                                                    hip_flexion.getRangeMin());
+            hip_flexion.setValue(state, value);
+            fittedHipFlexion.setValue(fittedState, value);
+            CHECK(fittedPath.getLength(fittedState) ==
+                    Approx(path.getLength(state)).margin(3e-3));
+        }
+    }
+}
+
+TEST_CASE("SimTKMultivariatePolynomial gradient and batch evaluation") {
+    SimTK::Random::Uniform random(-1, 1);
+    random.setSeed(0);
+    const int order = 3;
+    for (int dimension = 1; dimension <= 4; ++dimension) {
+        CAPTURE(dimension);
+        const auto powers = SimTKMultivariatePolynomial<double>::createPowers(
+                dimension, order);
+        SimTK::Vector coefficients((int)powers.size());
+        for (int i = 0; i < coefficients.size(); ++i) {
+            coefficients[i] = random.getValue();
+        }
+        const SimTKMultivariatePolynomial<double> polynomial(
+                coefficients, dimension, order);
+
+        const int numPoints = 5;
+        SimTK::Matrix points(numPoints, dimension);
+        for (int p = 0; p < numPoints; ++p) {
+            for (int i = 0; i < dimension; ++i) {
+                points(p, i) = 2 * random.getValue();
+            }
+        }
+        SimTK::Vector values;
+        SimTK::Matrix gradients;
+        polynomial.calcValuesAndGradients(points, values, gradients);
+        SimTK::Vector valuesOnly;
+        polynomial.calcValues(points, valuesOnly);
+
+        for (int p = 0; p < numPoints; ++p) {
+            const SimTK::Vector x = points.row(p).transpose();
+            // Evaluate the polynomial term by term.
+            double expectedValue = 0;
+            for (int iterm = 0; iterm < (int)powers.size(); ++iterm) {
+                double term = coefficients[iterm];
+                for (int i = 0; i < dimension; ++i) {
+                    term *= std::pow(x[i], powers[iterm][i]);
+                }
+                expectedValue += term;
+            }
+            CHECK(polynomial.calcValue(x) == Approx(expectedValue));
+            CHECK(values[p] == Approx(expectedValue));
+            CHECK(valuesOnly[p] == Approx(expectedValue));
+
+            double value;
+            SimTK::Vector gradient;
+            polynomial.calcValueAndGradient(x, value, gradient);
+            CHECK(value == Approx(expectedValue));
+            for (int j = 0; j < dimension; ++j) {
+                // Central finite difference.
+                const double h = 1e-6;
+                SimTK::Vector xPlus = x;
+                SimTK::Vector xMinus = x;
+                xPlus[j] += h;
+                xMinus[j] -= h;
+                const double expectedDeriv =
+                        (polynomial.calcValue(xPlus) -
+                                polynomial.calcValue(xMinus)) /
+                        (2 * h);
+                const double deriv =
+                        polynomial.calcDerivative(std::vector<int>{j}, x);
+                CHECK(deriv == Approx(expectedDeriv).margin(1e-6));
+                CHECK(gradient[j] == Approx(deriv));
+                CHECK(gradients(p, j) == Approx(deriv));
+            }
+            CHECK(polynomial.calcDerivative(std::vector<int>{dimension}, x) ==
+                    0);
+            CHECK(polynomial.calcDerivative(std::vector<int>{4}, x) == 0);
+        }
+    }
+}
@@ -72,4 +72,72 @@ TEST_CASE("TableProcessor") {
             CHECK(out.getNumRows() == 4);
         }
     }
+
+    SECTION("Results are cached") {
+        CHECK(!ProcessorCache::getEnabled());
+        ProcessorCache::setEnabled(true);
+        ProcessorCache::clear();
+        TableProcessor proc = TableProcessor(table) | MyTableOperator();
+        CHECK(proc.process().getNumRows() == 4);
+        CHECK(ProcessorCache::getNumHits() == 0);
+        CHECK(proc.process().getNumRows() == 4);
+        CHECK(ProcessorCache::getNumHits() == 1);
+
+        // A copy of the processor has the same key.
+        TableProcessor copy = proc;
+        CHECK(copy.process().getNumRows() == 4);
+        CHECK(ProcessorCache::getNumHits() == 2);
+
+        // Changing the source table or operators changes the key.
+        TimeSeriesTable modified = table;
+        modified.updMatrix()(0, 0) += 1.0;
+        TableProcessor procModified =
+                TableProcessor(modified) | MyTableOperator();
+        CHECK(procModified.process().getMatrix()(0, 0) ==
+                table.getMatrix()(0, 0) + 1.0);
+        proc.append(MyTableOperator());
+        CHECK(proc.process().getNumRows() == 5);
+        CHECK(ProcessorCache::getNumHits() == 2);
+
+        ProcessorCache::setEnabled(false);
+        proc.process();
+        CHECK(ProcessorCache::getNumHits() == 2);
+    }
+}
+
+TEST_CASE("TabOpLowPassFilter") {
+    const int numRows = 101;
+    std::vector<double> time(numRows);
+    SimTK::Matrix data(numRows, 2);
+    for (int i = 0; i < numRows; ++i) {
+        time[i] = 0.01 * i;
+        data(i, 0) = std::sin(2 * SimTK::Pi * time[i]) +
+                     0.1 * std::sin(2 * SimTK::Pi * 40 * time[i]);
+        data(i, 1) = std::cos(2 * SimTK::Pi * time[i]);
+    }
+    TimeSeriesTable table(time, data, {"a", "b"});
+
+    const auto expected = filterLowpass(table, 6, true);
+    const auto actual = filterLowpassWithoutStorage(table, 6, true);
+    REQUIRE(actual.getNumRows() == expected.getNumRows());
+    CHECK(actual.getColumnLabels() == expected.getColumnLabels());
+    for (int irow = 0; irow < (int)actual.getNumRows(); ++irow) {
+        CHECK(actual.getIndependentColumn()[irow] ==
+                Approx(expected.getIndependentColumn()[irow]));
+        for (int icol = 0; icol < 2; ++icol) {
+            CHECK(actual.getMatrix()(irow, icol) ==
+                    Approx(expected.getMatrix()(irow, icol)).margin(1e-12));
+        }
+    }
+
+    TabOpLowPassFilter op(6);
+    op.set_convert_to_storage(false);
+    TimeSeriesTable operated = table;
+    op.operate(operated);
+    CHECK(operated.getNumRows() == expected.getNumRows());
+
+    // Nonuniform times are not supported.
+    TimeSeriesTable nonuniform = table;
+    nonuniform.setIndependentValueAtIndex(50, 0.505);
+    CHECK_THROWS(filterLowpassWithoutStorage(nonuniform, 6, true));
 }
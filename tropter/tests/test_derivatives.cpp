@@ -543,6 +543,131 @@ TEST_CASE("Check derivatives with analytical deriv.; sparse Jacobian.")
     }
 }
 
+/// The constraints are c(x) = A x + B q(x); if `separated` is true, the
+/// problem provides this form to the decorator.
+class SeparatedConstraints : public Problem<double> {
+public:
+    SeparatedConstraints(bool separated)
+            : Problem<double>(4, 3), m_separated(separated) {
+        this->set_variable_bounds(Vector4d(1, 1, 1, 1), Vector4d(5, 5, 5, 5));
+        this->set_constraint_bounds(Vector3d::Zero(), Vector3d::Zero());
+    }
+    void calc_objective(const VectorXd& x, double& obj_value) const override {
+        obj_value = x[0] * x[0] + x[3] * x[3];
+    }
+    void calc_constraints(
+            const VectorXd& x, Eigen::Ref<VectorXd> constr) const override {
+        constr[0] = x[0] - 2 * x[1] + 3 * x[2] * x[2];
+        constr[1] = x[3] + sin(x[1]);
+        constr[2] = x[0] + x[3] + x[1] * x[2] - 0.5 * x[2] * x[2];
+    }
+    int get_num_nonlinear_functions() const override {
+        return m_separated ? 3 : 0;
+    }
+    void calc_separated_constraint_matrices(
+            Eigen::SparseMatrix<double>& linear,
+            Eigen::SparseMatrix<double>& nonlinear) const override {
+        MatrixXd A(3, 4);
+        A << 1, -2, 0, 0,
+             0,  0, 0, 1,
+             1,  0, 0, 1;
+        MatrixXd B(3, 3);
+        B <<    3, 0, 0,
+                0, 1, 0,
+             -0.5, 0, 1;
+        linear = A.sparseView();
+        nonlinear = B.sparseView();
+    }
+    void calc_nonlinear_functions(const VectorXd& x,
+            Eigen::Ref<VectorXd> nonlinear_functions) const override {
+        nonlinear_functions[0] = x[2] * x[2];
+        nonlinear_functions[1] = sin(x[1]);
+        nonlinear_functions[2] = x[1] * x[2];
+    }
+    void analytical_jacobian(const VectorXd& x, MatrixXd& jacobian) const {
+        jacobian.resize(3, 4);
+        jacobian << 1, -2, 6 * x[2], 0,
+                    0, cos(x[1]), 0, 1,
+                    1, x[2], x[1] - x[2], 1;
+    }
+    void analytical_hessian_lagrangian(const VectorXd& x, double obj_factor,
+            const VectorXd& lambda, MatrixXd& hessian) const {
+        hessian.setZero(4, 4);
+        hessian(0, 0) = 2 * obj_factor;
+        hessian(3, 3) = 2 * obj_factor;
+        hessian(1, 1) = -lambda[1] * sin(x[1]);
+        hessian(1, 2) = lambda[2];
+        hessian(2, 1) = lambda[2];
+        hessian(2, 2) = 6 * lambda[0] - lambda[2];
+    }
+
+private:
+    bool m_separated;
+};
+
+TEST_CASE("Finite differences with separated constraints") {
+    VectorXd x(4);
+    x << 3.1, -1.5, -0.25, 5.3;
+    VectorXd lambda(3);
+    lambda << 0.5, 1.5, 2.5;
+    const double obj_factor = 0.7;
+
+    MatrixXd analytical_jacobian;
+    MatrixXd analytical_hessian;
+    {
+        SeparatedConstraints problem(true);
+        problem.analytical_jacobian(x, analytical_jacobian);
+        problem.analytical_hessian_lagrangian(
+                x, obj_factor, lambda, analytical_hessian);
+
+        // The separated form gives the same constraint values.
+        VectorXd constr(3);
+        problem.calc_constraints(x, constr);
+        Eigen::SparseMatrix<double> A, B;
+        problem.calc_separated_constraint_matrices(A, B);
+        VectorXd q(3);
+        problem.calc_nonlinear_functions(x, q);
+        TROPTER_REQUIRE_EIGEN(constr, VectorXd(A * x + B * q), 1e-15);
+    }
+
+    for (bool separated : {false, true}) {
+        CAPTURE(separated);
+        SeparatedConstraints problem(separated);
+        auto proxy = problem.make_decorator();
+        SparsityCoordinates jac_sparsity;
+        SparsityCoordinates hes_sparsity;
+        proxy->calc_sparsity(proxy->make_initial_guess_from_bounds(),
+                jac_sparsity, true, hes_sparsity);
+
+        // Jacobian.
+        const unsigned num_jacobian_elem = (unsigned)jac_sparsity.row.size();
+        REQUIRE(num_jacobian_elem == 9);
+        VectorXd jacobian_values(num_jacobian_elem);
+        proxy->calc_jacobian(4, x.data(), true, num_jacobian_elem,
+                jacobian_values.data());
+        for (int inz = 0; inz < (int)num_jacobian_elem; ++inz) {
+            const auto& i = jac_sparsity.row[inz];
+            const auto& j = jac_sparsity.col[inz];
+            REQUIRE(analytical_jacobian(i, j) ==
+                    Approx(jacobian_values[inz]).margin(1e-7));
+        }
+
+        // Hessian (of the Lagrangian).
+        const unsigned num_hessian_nonzeros = (unsigned)hes_sparsity.row.size();
+        VectorXd hessian_values(num_hessian_nonzeros);
+        proxy->set_findiff_hessian_step_size(1e-4);
+        proxy->calc_hessian_lagrangian(4, x.data(), true, obj_factor, 3,
+                lambda.data(), true, num_hessian_nonzeros,
+                hessian_values.data());
+        for (int inz = 0; inz < (int)num_hessian_nonzeros; ++inz) {
+            const auto& i = hes_sparsity.row[inz];
+            const auto& j = hes_sparsity.col[inz];
+            REQUIRE(analytical_hessian(i, j) ==
+                    Approx(hessian_values[inz]).margin(1e-3));
+        }
+    }
+}
+
 TEST_CASE("Check finite differences on bounds", "[finitediff][!mayfail]")
 {
     HS071<adouble> problem;
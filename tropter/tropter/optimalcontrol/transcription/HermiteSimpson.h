@@ -83,6 +83,18 @@ public:
     void calc_objective(const VectorX<T>& x, T& obj_value) const override;
     void calc_constraints(const VectorX<T>& x,
         Eigen::Ref<VectorX<T>> constr) const override;
+    /// The defects are linear in the states and in the state derivatives
+    /// (multiplied by the duration), and the control midpoint constraints are
+    /// linear in the controls, so we provide the constraints in the separated
+    /// form of Betts 2010, eq. 4.107. The nonlinear functions are the state
+    /// derivatives at each collocation point multiplied by the duration,
+    /// followed by the path constraints at each mesh point.
+    int get_num_nonlinear_functions() const override;
+    void calc_separated_constraint_matrices(
+        Eigen::SparseMatrix<double>& linear,
+        Eigen::SparseMatrix<double>& nonlinear) const override;
+    void calc_nonlinear_functions(const VectorX<T>& x,
+        Eigen::Ref<VectorX<T>> nonlinear_functions) const override;
     /// Use knowledge of the repeated structure of the optimization problem
     /// to efficiently determine the sparsity pattern of the entire Hessian.
     /// We only need to perturb the optimal control functions at one mesh point,
@@ -462,9 +462,8 @@ void HermiteSimpson<T>::calc_constraints(
         const auto& xdot_im1 = m_derivs_mesh.leftCols(N);
         const auto& xdot_mid = m_derivs_mid;
 
-        // TODO separate out nonlinear components of the constraint vector per
-        // Bett's eq. 4.107 on page 144 to fully take advantage of the separated
-        // Hermite-Simpson form.
+        // calc_separated_constraint_matrices() and calc_nonlinear_functions()
+        // provide these same constraints in separated form (Betts eq. 4.107).
 
         // Hermite interpolant defects
         // ---------------------------
@@ -497,6 +496,146 @@ void HermiteSimpson<T>::calc_constraints(
     }
 }
 
+template <typename T>
+int HermiteSimpson<T>::get_num_nonlinear_functions() const {
+    return m_num_states * m_num_col_points + m_num_path_traj_constraints;
+}
+
+template <typename T>
+void HermiteSimpson<T>::calc_separated_constraint_matrices(
+        Eigen::SparseMatrix<double>& linear,
+        Eigen::SparseMatrix<double>& nonlinear) const {
+    const auto state_index = [this](int i_col, int i_state) {
+        return m_num_dense_variables + i_col * m_num_continuous_variables +
+               i_state;
+    };
+    const auto control_index = [this](int i_col, int i_control) {
+        return m_num_dense_variables + i_col * m_num_continuous_variables +
+               m_num_states + i_control;
+    };
+    // Index of the state derivative in the nonlinear functions.
+    const auto deriv_index = [this](int i_col, int i_state) {
+        return i_col * m_num_states + i_state;
+    };
+
+    std::vector<Eigen::Triplet<double>> linear_triplets;
+    std::vector<Eigen::Triplet<double>> nonlinear_triplets;
+
+    // Defects.
+    // --------
+    // The nonlinear functions include the duration, so the coefficients
+    // only contain the mesh interval (as a fraction of the duration).
+    for (int imesh = 0; imesh < m_num_mesh_intervals; ++imesh) {
+        const int i_col_im1 = 2 * imesh;
+        const int i_col_mid = i_col_im1 + 1;
+        const int i_col_i = i_col_im1 + 2;
+        const double h = m_mesh_intervals[imesh];
+        for (int is = 0; is < m_num_states; ++is) {
+            // Hermite interpolant defects.
+            const int hermite = imesh * 2 * m_num_states + is;
+            linear_triplets.emplace_back(
+                    hermite, state_index(i_col_mid, is), 1);
+            linear_triplets.emplace_back(
+                    hermite, state_index(i_col_im1, is), -0.5);
+            linear_triplets.emplace_back(
+                    hermite, state_index(i_col_i, is), -0.5);
+            nonlinear_triplets.emplace_back(
+                    hermite, deriv_index(i_col_im1, is), -h / 8.0);
+            nonlinear_triplets.emplace_back(
+                    hermite, deriv_index(i_col_i, is), h / 8.0);
+
+            // Simpson integration defects.
+            const int simpson = hermite + m_num_states;
+            linear_triplets.emplace_back(simpson, state_index(i_col_i, is), 1);
+            linear_triplets.emplace_back(
+                    simpson, state_index(i_col_im1, is), -1);
+            nonlinear_triplets.emplace_back(
+                    simpson, deriv_index(i_col_im1, is), -h / 6.0);
+            nonlinear_triplets.emplace_back(
+                    simpson, deriv_index(i_col_mid, is), -4.0 * h / 6.0);
+            nonlinear_triplets.emplace_back(
+                    simpson, deriv_index(i_col_i, is), -h / 6.0);
+        }
+    }
+
+    // Path constraints.
+    // -----------------
+    const int path_offset = m_num_states * m_num_col_points;
+    for (int i = 0; i < m_num_path_traj_constraints; ++i) {
+        nonlinear_triplets.emplace_back(
+                m_num_dynamics_constraints + i, path_offset + i, 1);
+    }
+
+    // Control midpoints.
+    // ------------------
+    if (m_num_controls && m_interpolate_control_midpoints) {
+        const int offset =
+                m_num_dynamics_constraints + m_num_path_traj_constraints;
+        for (int imesh = 0; imesh < m_num_mesh_intervals; ++imesh) {
+            for (int ic = 0; ic < m_num_controls; ++ic) {
+                const int row = offset + imesh * m_num_controls + ic;
+                linear_triplets.emplace_back(
+                        row, control_index(2 * imesh + 1, ic), 1);
+                linear_triplets.emplace_back(
+                        row, control_index(2 * imesh, ic), -0.5);
+                linear_triplets.emplace_back(
+                        row, control_index(2 * imesh + 2, ic), -0.5);
+            }
+        }
+    }
+
+    linear.resize(this->get_num_constraints(), this->get_num_variables());
+    linear.setFromTriplets(linear_triplets.begin(), linear_triplets.end());
+    nonlinear.resize(
+            this->get_num_constraints(), get_num_nonlinear_functions());
+    nonlinear.setFromTriplets(
+            nonlinear_triplets.begin(), nonlinear_triplets.end());
+}
+
+template <typename T>
+void HermiteSimpson<T>::calc_nonlinear_functions(const VectorX<T>& x,
+        Eigen::Ref<VectorX<T>> nonlinear_functions) const {
+    const T& initial_time = x[0];
+    const T& final_time = x[1];
+    const T duration = final_time - initial_time;
+
+    auto states = make_states_trajectory_view(x);
+    auto controls = make_controls_trajectory_view(x);
+    auto adjuncts = make_adjuncts_trajectory_view(x);
+    auto diffuses = make_diffuses_trajectory_view(x);
+    auto parameters = make_parameters_view(x);
+
+    m_ocproblem->initialize_on_iterate(parameters);
+
+    // State derivatives at each collocation point, followed by the path
+    // constraints at each mesh point.
+    Eigen::Map<MatrixX<T>> derivs(
+            nonlinear_functions.data(), m_num_states, m_num_col_points);
+    Eigen::Map<MatrixX<T>> path_constraints(
+            nonlinear_functions.data() + m_num_states * m_num_col_points,
+            m_num_path_constraints, m_num_mesh_points);
+
+    for (int i_col = 0; i_col < m_num_col_points; ++i_col) {
+        const T time = duration * m_mesh_and_midpoints[i_col] + initial_time;
+        if (i_col % 2 == 0) {
+            m_ocproblem->calc_differential_algebraic_equations(
+                    {i_col, time, states.col(i_col), controls.col(i_col),
+                            adjuncts.col(i_col), m_empty_diffuse_col,
+                            parameters},
+                    {derivs.col(i_col), path_constraints.col(i_col / 2)});
+        } else {
+            m_ocproblem->calc_differential_algebraic_equations(
+                    {i_col, time, states.col(i_col), controls.col(i_col),
+                            adjuncts.col(i_col), diffuses.col(i_col / 2),
+                            parameters},
+                    {derivs.col(i_col), m_empty_path_constraint_col});
+            TROPTER_THROW_IF(m_empty_path_constraint_col.size() != 0,
+                    "Invalid resize of empty path constraint output.");
+        }
+    }
+    derivs *= duration;
+}
+
 template <typename T>
 void HermiteSimpson<T>::calc_sparsity_hessian_lagrangian(
         const Eigen::VectorXd& x, SymmetricSparsityPattern& hescon_sparsity,
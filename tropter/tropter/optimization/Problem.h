@@ -19,6 +19,7 @@
 #include <tropter/common.h>
 #include "AbstractProblem.h"
 #include "ProblemDecorator.h"
+#include <Eigen/SparseCore>
 #include <memory>
 
 namespace tropter {
@@ -64,6 +65,37 @@ public:
     virtual void calc_constraints(const VectorX<T>& variables,
             Eigen::Ref<VectorX<T>> constr) const;
 
+    /// @name Separated constraints
+    /// Optionally, a problem can express its constraints in the separated
+    /// form (Betts 2010, eq. 4.107)
+    /// @verbatim
+    ///     c(x) = A x + B q(x),
+    /// @endverbatim
+    /// where A and B are constant sparse matrices and q(x) are the nonlinear
+    /// functions of the problem (e.g., the dynamics at each collocation
+    /// point). The finite-difference derivatives are then computed by
+    /// perturbing only q(x), whose Jacobian is usually much sparser than that
+    /// of c(x): fewer perturbations are required, the linear terms are exact,
+    /// and A does not contribute to the Hessian of the Lagrangian.
+    /// calc_constraints() must still be implemented, and must produce the same
+    /// values as the separated form. These functions are used only if
+    /// T = double (automatic differentiation does not benefit from them).
+    /// @{
+
+    /// The number of nonlinear functions q(x). The default, 0, means the
+    /// problem does not provide its constraints in the separated form.
+    virtual int get_num_nonlinear_functions() const { return 0; }
+    /// Compute the constant matrices A (num_constraints x num_variables) and
+    /// B (num_constraints x get_num_nonlinear_functions()). This is called
+    /// once, when the sparsity pattern is determined.
+    virtual void calc_separated_constraint_matrices(
+            Eigen::SparseMatrix<double>& linear,
+            Eigen::SparseMatrix<double>& nonlinear) const;
+    /// Compute q(x), which has get_num_nonlinear_functions() elements.
+    virtual void calc_nonlinear_functions(const VectorX<T>& variables,
+            Eigen::Ref<VectorX<T>> nonlinear_functions) const;
+    /// @}
+
     /// Create an interface to this problem that can provide the derivatives
     /// of the objective and constraint functions. This is for use by the
     /// optimization solver, but users might call this if they are interested
@@ -94,6 +126,18 @@ void Problem<T>::calc_constraints(const VectorX<T>&,
         Eigen::Ref<VectorX<T>>) const
 {}
 
+template<typename T>
+void Problem<T>::calc_separated_constraint_matrices(
+        Eigen::SparseMatrix<double>&, Eigen::SparseMatrix<double>&) const {
+    throw std::runtime_error("Not implemented.");
+}
+
+template<typename T>
+void Problem<T>::calc_nonlinear_functions(const VectorX<T>&,
+        Eigen::Ref<VectorX<T>>) const {
+    throw std::runtime_error("Not implemented.");
+}
+
 /// We must specialize this template for each scalar type.
 /// @ingroup optimization
 template<typename T>
@@ -82,32 +82,96 @@ calc_sparsity(const Eigen::VectorXd& variables,
     // Jacobian.
     // =========
     const auto num_jac_rows = get_num_constraints();
+    // If the problem provides its constraints in separated form, we only
+    // need to differentiate the nonlinear functions.
+    m_num_nonlinear_functions = m_problem.get_num_nonlinear_functions();
+    const bool separated = m_num_nonlinear_functions > 0;
+    const int num_functions =
+            separated ? m_num_nonlinear_functions : (int)num_jac_rows;
 
     // Determine the sparsity pattern.
     // -------------------------------
     // We do this by setting an element of x to NaN, and examining which
     // constraint equations end up as NaN (and therefore depend on that
     // element of x).
-    std::function<void(const VectorXd&, VectorXd&)> calc_constraints =
-            [this](const VectorXd& vars, VectorXd& constr) {
-                m_problem.calc_constraints(vars, constr);
+    std::function<void(const VectorXd&, VectorXd&)> calc_functions =
+            [this](const VectorXd& vars, VectorXd& functions) {
+                calc_differentiated_functions(vars, functions);
             };
     const auto var_names = m_problem.get_variable_names();
-    const auto constr_names = m_problem.get_constraint_names();
+    // Only the constraints have names.
+    const auto function_names = separated ? std::vector<std::string>()
+                                          : m_problem.get_constraint_names();
     SparsityPattern jacobian_sparsity =
             calc_jacobian_sparsity_with_perturbation(variables,
-                    num_jac_rows, calc_constraints, constr_names, var_names);
+                    num_functions, calc_functions, function_names, var_names);
 
     m_jacobian_coloring.reset(new JacobianColoring(jacobian_sparsity));
-    m_jacobian_coloring->get_coordinate_format(jacobian_sparsity_coordinates);
+    if (separated) {
+        m_problem.calc_separated_constraint_matrices(
+                m_linear_constraint_matrix, m_nonlinear_constraint_matrix);
+        TROPTER_THROW_IF(m_linear_constraint_matrix.rows() != num_jac_rows ||
+                        m_linear_constraint_matrix.cols() != num_vars,
+                "Expected the matrix of linear constraint terms to have "
+                "dimensions %i x %i, but it has dimensions %i x %i.",
+                num_jac_rows, num_vars,
+                (int)m_linear_constraint_matrix.rows(),
+                (int)m_linear_constraint_matrix.cols());
+        TROPTER_THROW_IF(
+                m_nonlinear_constraint_matrix.rows() != num_jac_rows ||
+                        m_nonlinear_constraint_matrix.cols() != num_functions,
+                "Expected the matrix of nonlinear constraint terms to have "
+                "dimensions %i x %i, but it has dimensions %i x %i.",
+                num_jac_rows, num_functions,
+                (int)m_nonlinear_constraint_matrix.rows(),
+                (int)m_nonlinear_constraint_matrix.cols());
+        m_linear_constraint_matrix.makeCompressed();
+        m_nonlinear_constraint_matrix.makeCompressed();
+
+        // The sparsity of A + B dq/dx. We replace all values with ones so
+        // that no terms cancel.
+        const auto one = [](double) { return 1.0; };
+        const VectorXd ones =
+                VectorXd::Ones(m_jacobian_coloring->get_num_nonzeros());
+        Eigen::SparseMatrix<double> nonlinear_jacobian_pattern;
+        m_jacobian_coloring->convert(ones.data(), nonlinear_jacobian_pattern);
+        const Eigen::SparseMatrix<double> linear_pattern =
+                m_linear_constraint_matrix.unaryExpr(one);
+        const Eigen::SparseMatrix<double> nonlinear_pattern =
+                m_nonlinear_constraint_matrix.unaryExpr(one);
+        m_jacobian_pattern =
+                linear_pattern + nonlinear_pattern * nonlinear_jacobian_pattern;
+        m_jacobian_pattern.makeCompressed();
+
+        auto& rows = jacobian_sparsity_coordinates.row;
+        auto& cols = jacobian_sparsity_coordinates.col;
+        rows.clear();
+        cols.clear();
+        rows.reserve(m_jacobian_pattern.nonZeros());
+        cols.reserve(m_jacobian_pattern.nonZeros());
+        for (int icol = 0; icol < m_jacobian_pattern.outerSize(); ++icol) {
+            for (Eigen::SparseMatrix<double>::InnerIterator it(
+                         m_jacobian_pattern, icol); it; ++it) {
+                rows.push_back((unsigned int)it.row());
+                cols.push_back((unsigned int)it.col());
+            }
+        }
+        m_nonlinear_jacobian_values.resize(
+                m_jacobian_coloring->get_num_nonzeros());
+        print("Number of nonlinear functions in separated constraints: %i",
+                num_functions);
+    } else {
+        m_jacobian_coloring->get_coordinate_format(
+                jacobian_sparsity_coordinates);
+    }
     int num_jacobian_seeds = (int)m_jacobian_coloring->get_seed_matrix().cols();
     print("Number of seeds for Jacobian: %i", num_jacobian_seeds);
     // jacobian_sparsity.write("DEBUG_findiff_jacobian_sparsity.csv");
 
     // Allocate memory that is used in jacobian().
-    m_constr_pos.resize(num_jac_rows);
-    m_constr_neg.resize(num_jac_rows);
-    m_jacobian_compressed.resize(num_jac_rows, num_jacobian_seeds);
+    m_constr_pos.resize(num_functions);
+    m_constr_neg.resize(num_functions);
+    m_jacobian_compressed.resize(num_functions, num_jacobian_seeds);
 
     // Hessian.
     // ========
@@ -279,15 +343,52 @@ calc_jacobian(unsigned num_variables, const double* variables, bool /*new_x*/,
     for (Eigen::Index iseed = 0; iseed < num_seeds; ++iseed) {
         const auto direction = seed.col(iseed);
         // Perturb x in the positive direction.
-        m_problem.calc_constraints(x0 + eps * direction, m_constr_pos);
+        calc_differentiated_functions(x0 + eps * direction, m_constr_pos);
         // Perturb x in the negative direction.
-        m_problem.calc_constraints(x0 - eps * direction, m_constr_neg);
+        calc_differentiated_functions(x0 - eps * direction, m_constr_neg);
         // Compute central difference.
         m_jacobian_compressed.col(iseed) =
                 (m_constr_pos - m_constr_neg) / two_eps;
     }
 
-    m_jacobian_coloring->recover(m_jacobian_compressed, jacobian_values);
+    if (!m_num_nonlinear_functions) {
+        m_jacobian_coloring->recover(m_jacobian_compressed, jacobian_values);
+        return;
+    }
+
+    // Separated constraints: the Jacobian is A + B dq/dx.
+    m_jacobian_coloring->recover(m_jacobian_compressed,
+            m_nonlinear_jacobian_values.data());
+    Eigen::SparseMatrix<double> nonlinear_jacobian;
+    m_jacobian_coloring->convert(m_nonlinear_jacobian_values.data(),
+            nonlinear_jacobian);
+    const Eigen::SparseMatrix<double> jacobian = m_linear_constraint_matrix +
+            m_nonlinear_constraint_matrix * nonlinear_jacobian;
+    // The nonzeros of jacobian are a subset of those in m_jacobian_pattern,
+    // and both are sorted by row within each column.
+    int inz = 0;
+    for (int icol = 0; icol < m_jacobian_pattern.outerSize(); ++icol) {
+        Eigen::SparseMatrix<double>::InnerIterator it(jacobian, icol);
+        for (Eigen::SparseMatrix<double>::InnerIterator itpat(
+                     m_jacobian_pattern, icol); itpat; ++itpat) {
+            if (it && it.row() == itpat.row()) {
+                jacobian_values[inz] = it.value();
+                ++it;
+            } else {
+                jacobian_values[inz] = 0;
+            }
+            ++inz;
+        }
+    }
+}
+
+void Problem<double>::Decorator::
+calc_differentiated_functions(const VectorXd& x, VectorXd& functions) const {
+    if (m_num_nonlinear_functions) {
+        m_problem.calc_nonlinear_functions(x, functions);
+    } else {
+        m_problem.calc_constraints(x, functions);
+    }
 }
 
 void Problem<double>::Decorator::
@@ -320,9 +421,19 @@ calc_hessian_lagrangian(unsigned num_variables, const double* x_raw,
     // TODO reuse perturbations between the Jacobian and Hessian calculations
     // (if step size is the same).
 
+    // With separated constraints, lambda^T c(x) = lambda^T A x +
+    // (B^T lambda)^T q(x); the linear term does not contribute to the
+    // Hessian, so we only need the second derivatives of q(x).
+    const bool separated = m_num_nonlinear_functions > 0;
+    const int num_functions =
+            separated ? m_num_nonlinear_functions : (int)num_constraints;
+    const VectorXd multipliers = separated
+            ? VectorXd(m_nonlinear_constraint_matrix.transpose() * lambda)
+            : VectorXd(lambda);
+
     // Compute the unperturbed constraints value.
-    VectorXd p1 = VectorXd::Zero(num_constraints);
-    m_problem.calc_constraints(x0, p1);
+    VectorXd p1 = VectorXd::Zero(num_functions);
+    calc_differentiated_functions(x0, p1);
 
     const auto& hescon_seed = m_hescon_coloring->get_seed_matrix();
     const Eigen::Index num_hescon_seeds = hescon_seed.cols();
@@ -338,25 +449,25 @@ calc_hessian_lagrangian(unsigned num_variables, const double* x_raw,
     Eigen::MatrixXd hescon_c(num_variables, num_hescon_seeds);
     // Double-compressed second derivatives; same shape as a compressed
     // Jacobian. Used in the inner loop.
-    Eigen::MatrixXd hescon_cc(num_constraints, num_jac_seeds);
+    Eigen::MatrixXd hescon_cc(num_functions, num_jac_seeds);
     // Store perturbed values of constraints.
-    VectorXd p2(num_constraints);
-    VectorXd p3(num_constraints);
-    VectorXd p4(num_constraints);
+    VectorXd p2(num_functions);
+    VectorXd p3(num_functions);
+    VectorXd p4(num_functions);
 
     // Loop through Hessian seeds.
     for (int ihesseed = 0; ihesseed < num_hescon_seeds; ++ihesseed) {
         const auto hes_direction = hescon_seed.col(ihesseed);
         VectorXd xb = x0 + eps * hes_direction;
         p2.setZero();
-        m_problem.calc_constraints(xb, p2);
+        calc_differentiated_functions(xb, p2);
 
         for (int ijacseed = 0; ijacseed < num_jac_seeds; ++ijacseed) {
             const auto jac_direction = jac_seed.col(ijacseed);
             p3.setZero();
-            m_problem.calc_constraints(x0 + eps * jac_direction, p3);
+            calc_differentiated_functions(x0 + eps * jac_direction, p3);
             p4.setZero();
-            m_problem.calc_constraints(xb + eps * jac_direction, p4);
+            calc_differentiated_functions(xb + eps * jac_direction, p4);
 
             // Finite difference.
             hescon_cc.col(ijacseed) = (p1 - p2 - p3 + p4) / eps_squared;
@@ -369,7 +480,7 @@ calc_hessian_lagrangian(unsigned num_variables, const double* x_raw,
         Eigen::SparseMatrix<double> Bgunc;
         m_jacobian_coloring->convert(Bgunc_coeffs.data(), Bgunc);
 
-        hescon_c.col(ihesseed) = Bgunc.transpose() * lambda;
+        hescon_c.col(ihesseed) = Bgunc.transpose() * multipliers;
     }
 
     // Convert the compressed Hessian of constraints into a SparseMatrix, for
@@ -74,6 +74,12 @@ private:
     void calc_sparsity_hessian_lagrangian(
             const Eigen::VectorXd&, SparsityCoordinates&) const;
 
+    /// Compute the functions whose Jacobian m_jacobian_coloring describes:
+    /// the nonlinear functions q(x) if the problem provides its constraints
+    /// in separated form, and the constraints otherwise.
+    void calc_differentiated_functions(const Eigen::VectorXd& x,
+            Eigen::VectorXd& functions) const;
+
     void calc_hessian_objective(const Eigen::VectorXd& x0,
             Eigen::VectorXd& hesobj_values) const;
     void calc_lagrangian(
@@ -110,6 +116,20 @@ private:
     mutable Eigen::VectorXd m_constr_neg;
     mutable Eigen::MatrixXd m_jacobian_compressed;
 
+    // Separated constraints.
+    // ----------------------
+    // If the problem provides its constraints in the separated form
+    // c(x) = A x + B q(x), m_jacobian_coloring describes the Jacobian of q(x)
+    // (not of c(x)), and the Jacobian of c(x) is A + B dq/dx.
+    mutable int m_num_nonlinear_functions = 0;
+    mutable Eigen::SparseMatrix<double> m_linear_constraint_matrix;
+    mutable Eigen::SparseMatrix<double> m_nonlinear_constraint_matrix;
+    // Sparsity pattern of the Jacobian of c(x); the nonzeros are reported to
+    // the solver in the (column-major) order of this matrix.
+    mutable Eigen::SparseMatrix<double> m_jacobian_pattern;
+    // Working memory.
+    mutable Eigen::VectorXd m_nonlinear_jacobian_values;
+
     // Hessian/Lagrangian.
     // -------------------
     mutable std::unique_ptr<HessianColoring> m_hescon_coloring;